@@ -14145,7 +14145,8 @@ extern const struct language_defn ada_language_defn = {
   NULL,
   NULL,
   ada_is_string_type,
-  "(...)"			/* la_struct_too_deep_ellipsis */
+  "(...)",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 /* Command-list for the "set/show ada" prefix command.  */
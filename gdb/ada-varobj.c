@@ -990,9 +990,10 @@ ada_value_has_mutated (const struct varobj *var, struct value *new_val,
 
   varobj_restrict_range (var->children, &from, &to);
   for (int i = from; i < to; i++)
-    if (ada_varobj_get_name_of_child (new_val, new_type,
-				      var->name.c_str (), i)
-	!= var->children[i]->name)
+    if (var->children[i] != NULL
+	&& ada_varobj_get_name_of_child (new_val, new_type,
+					 var->name.c_str (), i)
+	   != var->children[i]->name)
       return true;
 
   return false;
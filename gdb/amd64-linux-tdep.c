@@ -1841,6 +1841,8 @@ amd64_linux_init_abi_common(struct gdbarch_info info, struct gdbarch *gdbarch)
   set_gdbarch_displaced_step_fixup (gdbarch, amd64_displaced_step_fixup);
   set_gdbarch_displaced_step_location (gdbarch,
                                        linux_displaced_step_location);
+  set_gdbarch_displaced_step_buffer_count
+    (gdbarch, linux_displaced_step_buffer_count);
 
   set_gdbarch_process_record (gdbarch, i386_process_record);
   set_gdbarch_process_record_signal (gdbarch, amd64_linux_record_signal);
@@ -45,6 +45,12 @@ default_displaced_step_hw_singlestep (struct gdbarch *gdbarch,
   return !gdbarch_software_single_step_p (gdbarch);
 }
 
+int
+default_displaced_step_buffer_count (struct gdbarch *gdbarch)
+{
+  return 1;
+}
+
 CORE_ADDR
 displaced_step_at_entry_point (struct gdbarch *gdbarch)
 {
@@ -79,6 +79,10 @@ extern int
   default_displaced_step_hw_singlestep (struct gdbarch *,
 					struct displaced_step_closure *);
 
+/* Default implementation of gdbarch_displaced_step_buffer_count:
+   a single buffer.  */
+extern int default_displaced_step_buffer_count (struct gdbarch *gdbarch);
+
 /* Possible value for gdbarch_displaced_step_location:
    Place displaced instructions at the program's entry point,
    leaving space for inferior function call return breakpoints.  */
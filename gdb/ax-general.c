@@ -27,6 +27,7 @@
 
 #include "value.h"
 #include "user-regs.h"
+#include "gdbsupport/selftest.h"
 
 static void grow_expr (struct agent_expr *x, int n);
 
@@ -600,3 +601,377 @@ ax_reqs (struct agent_expr *ax)
 
   ax->final_height = height;
 }
+
+
+/* Evaluating expressions.  */
+
+/* See ax.h.  */
+
+bool
+ax_eval (struct gdbarch *gdbarch, const gdb_byte *code, int len,
+	 ax_eval_context *context, ULONGEST *result)
+{
+  const int stack_max = 100;
+  ULONGEST stack[stack_max], top = 0;
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  gdb_byte buf[8];
+  int sp = 0, pc = 0, steps = 0;
+
+  /* Cache the stack top in TOP, like the agent does; STACK[1] to
+     STACK[SP - 1] hold the elements below it, so the stack has SP
+     elements.  */
+  while (pc < len)
+    {
+      enum agent_op op = (enum agent_op) code[pc++];
+
+      /* Gotos can jump backwards; give up on expressions that loop
+	 rather than hang the inferior.  */
+      if (++steps > AX_EVAL_MAX_STEPS)
+	return false;
+
+      if (op >= aop_last || aop_map[op].name == NULL
+	  || pc + aop_map[op].op_size > len
+	  || sp < aop_map[op].consumed)
+	return false;
+
+      /* The operand, for the ops that have one.  */
+      ULONGEST arg = 0;
+      for (int i = 0; i < aop_map[op].op_size; i++)
+	arg = (arg << 8) | code[pc++];
+
+      switch (op)
+	{
+	case aop_add:
+	  top += stack[--sp];
+	  break;
+
+	case aop_sub:
+	  top = stack[--sp] - top;
+	  break;
+
+	case aop_mul:
+	  top *= stack[--sp];
+	  break;
+
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	  if (top == 0)
+	    return false;
+	  if (op == aop_div_signed)
+	    top = (LONGEST) stack[--sp] / (LONGEST) top;
+	  else if (op == aop_div_unsigned)
+	    top = stack[--sp] / top;
+	  else if (op == aop_rem_signed)
+	    top = (LONGEST) stack[--sp] % (LONGEST) top;
+	  else
+	    top = stack[--sp] % top;
+	  break;
+
+	case aop_lsh:
+	  top = stack[--sp] << top;
+	  break;
+
+	case aop_rsh_signed:
+	  top = (LONGEST) stack[--sp] >> top;
+	  break;
+
+	case aop_rsh_unsigned:
+	  top = stack[--sp] >> top;
+	  break;
+
+	case aop_log_not:
+	  top = !top;
+	  break;
+
+	case aop_bit_and:
+	  top &= stack[--sp];
+	  break;
+
+	case aop_bit_or:
+	  top |= stack[--sp];
+	  break;
+
+	case aop_bit_xor:
+	  top ^= stack[--sp];
+	  break;
+
+	case aop_bit_not:
+	  top = ~top;
+	  break;
+
+	case aop_equal:
+	  top = (stack[--sp] == top);
+	  break;
+
+	case aop_less_signed:
+	  top = ((LONGEST) stack[--sp] < (LONGEST) top);
+	  break;
+
+	case aop_less_unsigned:
+	  top = (stack[--sp] < top);
+	  break;
+
+	case aop_ext:
+	  if (arg > 0 && arg < sizeof (LONGEST) * 8)
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (arg - 1);
+
+	      top &= ((ULONGEST) 1 << arg) - 1;
+	      top = (top ^ mask) - mask;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  if (arg < sizeof (LONGEST) * 8)
+	    top &= ((ULONGEST) 1 << arg) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    int size = aop_map[op].data_size / 8;
+
+	    if (!context->read_memory ((CORE_ADDR) top, buf, size))
+	      return false;
+	    top = extract_unsigned_integer (buf, size, byte_order);
+	  }
+	  break;
+
+	case aop_if_goto:
+	  if (top)
+	    pc = arg;
+	  if (--sp >= 0)
+	    top = stack[sp];
+	  break;
+
+	case aop_goto:
+	  pc = arg;
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  stack[sp++] = top;
+	  top = arg;
+	  break;
+
+	case aop_reg:
+	  stack[sp++] = top;
+	  if (!context->read_register (arg, &top))
+	    return false;
+	  break;
+
+	case aop_end:
+	  if (sp <= 0)
+	    return false;
+	  *result = top;
+	  return true;
+
+	case aop_dup:
+	  stack[sp++] = top;
+	  break;
+
+	case aop_pop:
+	  if (--sp >= 0)
+	    top = stack[sp];
+	  break;
+
+	case aop_pick:
+	  if (arg >= sp)
+	    return false;
+	  stack[sp] = top;
+	  top = stack[sp - arg];
+	  sp++;
+	  break;
+
+	case aop_rot:
+	  {
+	    ULONGEST tem = stack[sp - 1];
+
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = top;
+	    top = tem;
+	  }
+	  break;
+
+	case aop_swap:
+	  stack[sp] = top;
+	  top = stack[sp - 1];
+	  stack[sp - 1] = stack[sp];
+	  break;
+
+	default:
+	  /* Tracing, trace state variables, printf and floating
+	     point.  */
+	  return false;
+	}
+
+      if (sp < 0 || sp >= stack_max - 1)
+	return false;
+    }
+
+  /* Ran off the end without an "end" op.  */
+  return false;
+}
+
+#if GDB_SELF_TEST
+namespace selftests {
+namespace ax_eval_tests {
+
+/* A program state with one register and a few bytes of memory.  */
+
+struct test_context : public ax_eval_context
+{
+  bool read_register (int regnum, ULONGEST *val) override
+  {
+    if (regnum != 3)
+      return false;
+    *val = 42;
+    return true;
+  }
+
+  bool read_memory (CORE_ADDR addr, gdb_byte *buf, int len) override
+  {
+    if (addr < 0x1000 || addr + len > 0x1000 + sizeof (memory))
+      return false;
+    memcpy (buf, memory + (addr - 0x1000), len);
+    return true;
+  }
+
+  gdb_byte memory[16];
+};
+
+/* Evaluate X against CONTEXT, and return whether that succeeded.  */
+
+static bool
+eval (agent_expr *x, test_context *context, ULONGEST *result)
+{
+  return ax_eval (x->gdbarch, x->buf, x->len, context, result);
+}
+
+static void
+run_tests ()
+{
+  struct gdbarch *gdbarch = target_gdbarch ();
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  test_context context;
+  ULONGEST result;
+
+  store_unsigned_integer (context.memory, 4, byte_order, 0xfffffffe);
+
+  /* (2 + 3) * 4 == 20.  */
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_const_l (&x, 2);
+    ax_const_l (&x, 3);
+    ax_simple (&x, aop_add);
+    ax_const_l (&x, 4);
+    ax_simple (&x, aop_mul);
+    ax_const_l (&x, 20);
+    ax_simple (&x, aop_equal);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (eval (&x, &context, &result) && result == 1);
+  }
+
+  /* A sign-extended memory load compared against a register:
+     *(int *) 0x1000 < $reg3, i.e. -2 < 42.  */
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_const_l (&x, 0x1000);
+    ax_simple (&x, aop_ref32);
+    ax_ext (&x, 32);
+    ax_raw_byte (&x, aop_reg);
+    ax_raw_byte (&x, 0);
+    ax_raw_byte (&x, 3);
+    ax_simple (&x, aop_less_signed);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (eval (&x, &context, &result) && result == 1);
+  }
+
+  /* Conditional jumps: 0 ? 7 : 9.  */
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_const_l (&x, 0);
+    int else_jump = ax_goto (&x, aop_if_goto);
+    ax_const_l (&x, 9);
+    int end_jump = ax_goto (&x, aop_goto);
+    ax_label (&x, else_jump, x.len);
+    ax_const_l (&x, 7);
+    ax_label (&x, end_jump, x.len);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (eval (&x, &context, &result) && result == 9);
+  }
+
+  /* Errors: dividing by zero, reading unreadable memory or an unknown
+     register, trace state variables, and an empty stack at the
+     end.  */
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_const_l (&x, 1);
+    ax_const_l (&x, 0);
+    ax_simple (&x, aop_div_signed);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_const_l (&x, 0x2000);
+    ax_simple (&x, aop_ref8);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_raw_byte (&x, aop_reg);
+    ax_raw_byte (&x, 0);
+    ax_raw_byte (&x, 4);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_tsv (&x, aop_getv, 1);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+  {
+    agent_expr x (gdbarch, 0);
+
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+
+  /* An endless loop.  */
+  {
+    agent_expr x (gdbarch, 0);
+
+    int loop_jump = ax_goto (&x, aop_goto);
+    ax_label (&x, loop_jump, 0);
+    ax_simple (&x, aop_end);
+    SELF_CHECK (!eval (&x, &context, &result));
+  }
+}
+
+} /* namespace ax_eval_tests */
+} /* namespace selftests */
+#endif /* GDB_SELF_TEST */
+
+void
+_initialize_ax_general ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("ax_eval", selftests::ax_eval_tests::run_tests);
+#endif
+}
@@ -265,4 +265,40 @@ extern struct aop_map aop_map[];
 
 extern void ax_reqs (struct agent_expr *ax);
 
+
+/* Evaluating expressions.  */
+
+/* The program state ax_eval reads registers and memory from.  */
+
+struct ax_eval_context
+{
+  virtual ~ax_eval_context () = default;
+
+  /* Store the value of raw register REGNUM in *VAL.  REGNUM is
+     numbered as in the bytecode, see ax_reg.  Return false if the
+     register can't be read.  */
+  virtual bool read_register (int regnum, ULONGEST *val) = 0;
+
+  /* Read LEN bytes of memory at ADDR into BUF.  Return false on
+     error.  */
+  virtual bool read_memory (CORE_ADDR addr, gdb_byte *buf, int len) = 0;
+};
+
+/* The most operations ax_eval executes before giving up on an
+   expression, which may loop forever with backward gotos.  */
+
+#define AX_EVAL_MAX_STEPS 10000
+
+/* Evaluate the LEN bytes of bytecode at CODE, assembled for GDBARCH,
+   reading the program state through CONTEXT, and store the value left
+   on top of the stack in *RESULT.  This is a plain evaluator for
+   expressions such as breakpoint conditions: it does no tracing, and
+   knows nothing of trace state variables.  Return false if the
+   expression couldn't be evaluated, e.g., because it divided by zero,
+   failed to read memory, used an operation not supported here, or
+   executed more than AX_EVAL_MAX_STEPS operations.  */
+
+extern bool ax_eval (struct gdbarch *gdbarch, const gdb_byte *code, int len,
+		     ax_eval_context *context, ULONGEST *result);
+
 #endif /* AX_H */
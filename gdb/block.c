@@ -215,12 +215,10 @@ blockvector_contains_pc (const struct blockvector *bv, CORE_ADDR pc)
   return find_block_in_blockvector (bv, pc) != NULL;
 }
 
-/* Return call_site for specified PC in GDBARCH.  PC must match exactly, it
-   must be the next instruction after call (or after tail call jump).  Throw
-   NO_ENTRY_VALUE_ERROR otherwise.  This function never returns NULL.  */
+/* See block.h.  */
 
 struct call_site *
-call_site_for_pc (struct gdbarch *gdbarch, CORE_ADDR pc)
+find_call_site_for_pc (CORE_ADDR pc)
 {
   struct compunit_symtab *cust;
   void **slot = NULL;
@@ -232,6 +230,20 @@ call_site_for_pc (struct gdbarch *gdbarch, CORE_ADDR pc)
     slot = htab_find_slot (COMPUNIT_CALL_SITE_HTAB (cust), &pc, NO_INSERT);
 
   if (slot == NULL)
+    return NULL;
+  return (struct call_site *) *slot;
+}
+
+/* Return call_site for specified PC in GDBARCH.  PC must match exactly, it
+   must be the next instruction after call (or after tail call jump).  Throw
+   NO_ENTRY_VALUE_ERROR otherwise.  This function never returns NULL.  */
+
+struct call_site *
+call_site_for_pc (struct gdbarch *gdbarch, CORE_ADDR pc)
+{
+  struct call_site *call_site = find_call_site_for_pc (pc);
+
+  if (call_site == NULL)
     {
       struct bound_minimal_symbol msym = lookup_minimal_symbol_by_pc (pc);
 
@@ -245,7 +257,7 @@ call_site_for_pc (struct gdbarch *gdbarch, CORE_ADDR pc)
 		    : MSYMBOL_PRINT_NAME (msym.minsym)));
     }
 
-  return (struct call_site *) *slot;
+  return call_site;
 }
 
 /* Return the blockvector immediately containing the innermost lexical block
@@ -241,6 +241,11 @@ extern int blockvector_contains_pc (const struct blockvector *bv, CORE_ADDR pc);
 extern struct call_site *call_site_for_pc (struct gdbarch *gdbarch,
 					   CORE_ADDR pc);
 
+/* Like call_site_for_pc, but return NULL if there is no call site at
+   PC.  */
+
+extern struct call_site *find_call_site_for_pc (CORE_ADDR pc);
+
 extern const struct block *block_for_pc (CORE_ADDR);
 
 extern const struct block *block_for_pc_sect (CORE_ADDR, struct obj_section *);
@@ -535,6 +535,11 @@ static unsigned bp_locations_count;
 
 static CORE_ADDR bp_locations_placed_address_before_address_max;
 
+/* The number of software or hardware breakpoint locations in
+   BP_LOCATIONS that are permanent breakpoints.  */
+
+static unsigned bp_locations_permanent_count;
+
 /* Maximum offset plus alignment between bp_target_info.PLACED_ADDRESS
    + bp_target_info.SHADOW_LEN and ADDRESS for the current elements of
    BP_LOCATIONS which get a valid result from bp_location_has_shadow.
@@ -753,6 +758,26 @@ set_condition_evaluation_mode (const char *args, int from_tty,
   return;
 }
 
+/* See breakpoint.h.  */
+
+void
+breakpoint_condition_evaluation_support_changed ()
+{
+  struct bp_location *loc, **loc_tmp;
+
+  /* Re-parse the conditions of all the locations, and re-insert those
+     already inserted, so that the target gets the conditions, or
+     forgets them.  */
+  ALL_BP_LOCATIONS (loc, loc_tmp)
+    {
+      mark_breakpoint_location_modified (loc);
+      if (is_breakpoint (loc->owner) && loc->inserted)
+	loc->needs_update = 1;
+    }
+
+  update_global_location_list (UGLL_MAY_INSERT);
+}
+
 /* Shows the current mode of breakpoint condition evaluation.  Explicitly shows
    what "auto" is translating to.  */
 
@@ -3960,6 +3985,14 @@ breakpoint_here_p (const address_space *aspace, CORE_ADDR pc)
 
 /* See breakpoint.h.  */
 
+bool
+permanent_breakpoint_location_p ()
+{
+  return bp_locations_permanent_count != 0;
+}
+
+/* See breakpoint.h.  */
+
 int
 breakpoint_in_range_p (const address_space *aspace,
 		       CORE_ADDR addr, ULONGEST len)
@@ -4004,6 +4037,35 @@ moribund_breakpoint_here_p (const address_space *aspace, CORE_ADDR pc)
   return 0;
 }
 
+/* See breakpoint.h.  */
+
+bool
+only_target_conditional_breakpoints_here_p (const address_space *aspace,
+					    CORE_ADDR pc)
+{
+  struct bp_location **blp, **blp_tmp = NULL;
+  bool any = false;
+
+  ALL_BP_LOCATIONS_AT_ADDR (blp, blp_tmp, pc)
+    {
+      struct bp_location *bl = *blp;
+
+      if (bl->loc_type != bp_loc_software_breakpoint
+	  && bl->loc_type != bp_loc_hardware_breakpoint)
+	continue;
+
+      if ((breakpoint_enabled (bl->owner) || bl->permanent)
+	  && breakpoint_location_address_match (bl, aspace, pc))
+	{
+	  if (!is_breakpoint (bl->owner) || bl->cond_bytecode == NULL)
+	    return false;
+	  any = true;
+	}
+    }
+
+  return any;
+}
+
 /* Returns non-zero iff BL is inserted at PC, in address space
    ASPACE.  */
 
@@ -11682,6 +11744,16 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
 
   bp_locations_target_extensions_update ();
 
+  bp_locations_permanent_count = 0;
+  for (unsigned ix = 0; ix < bp_locations_count; ix++)
+    {
+      loc = bp_locations[ix];
+      if (loc->permanent
+	  && (loc->loc_type == bp_loc_software_breakpoint
+	      || loc->loc_type == bp_loc_hardware_breakpoint))
+	bp_locations_permanent_count++;
+    }
+
   /* Identify bp_location instances that are no longer present in the
      new list, and therefore should be freed.  Note that it's not
      necessary that those locations should be removed from inferior --
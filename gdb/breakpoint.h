@@ -1202,6 +1202,16 @@ extern int program_breakpoint_here_p (struct gdbarch *gdbarch, CORE_ADDR address
 extern enum breakpoint_here breakpoint_here_p (const address_space *,
 					       CORE_ADDR);
 
+/* Called by targets when whether they support evaluating breakpoint
+   conditions changes, to send or withdraw the conditions of the
+   inserted breakpoints.  */
+extern void breakpoint_condition_evaluation_support_changed ();
+
+/* Return true if any breakpoint location is a permanent breakpoint.
+   This is a cheap way to know whether breakpoint_here_p could ever
+   return permanent_breakpoint_here, without needing an address.  */
+extern bool permanent_breakpoint_location_p ();
+
 /* Return true if an enabled breakpoint exists in the range defined by
    ADDR and LEN, in ASPACE.  */
 extern int breakpoint_in_range_p (const address_space *aspace,
@@ -1209,6 +1219,13 @@ extern int breakpoint_in_range_p (const address_space *aspace,
 
 extern int moribund_breakpoint_here_p (const address_space *, CORE_ADDR);
 
+/* Return true if all the enabled breakpoint locations at PC, in
+   ASPACE, are user breakpoints whose conditions were given to the
+   target to evaluate.  If the target says their conditions are all
+   false, the hit can then be ignored.  */
+extern bool only_target_conditional_breakpoints_here_p
+  (const address_space *aspace, CORE_ADDR pc);
+
 extern int breakpoint_inserted_here_p (const address_space *,
 				       CORE_ADDR);
 
@@ -935,7 +935,8 @@ extern const struct language_defn c_language_defn =
   c_get_compile_context,
   c_compute_program,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
 
 enum cplus_primitive_types {
@@ -1081,7 +1082,8 @@ extern const struct language_defn cplus_language_defn =
   cplus_get_compile_context,
   cplus_compute_program,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
 
 static const char *asm_extensions[] =
@@ -1136,7 +1138,8 @@ extern const struct language_defn asm_language_defn =
   NULL,
   NULL,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
 
 /* The following language_defn does not represent a real language.
@@ -1191,5 +1194,6 @@ extern const struct language_defn minimal_language_defn =
   NULL,
   NULL,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
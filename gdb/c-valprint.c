@@ -492,6 +492,62 @@ c_val_print_memberptr (struct type *type, const gdb_byte *valaddr,
     }
 }
 
+/* Read the parts of ORIGINAL_VALUE that c_val_print looks at directly
+   to print the TYPE object at EMBEDDED_OFFSET in it, if ORIGINAL_VALUE
+   is being read in parts; see value_begin_fetch_in_parts.  The parts
+   of arrays and structures printed by recursing are read when
+   recursing.  */
+
+static void
+c_val_print_fetch (struct type *type, int embedded_offset,
+		   struct value *original_value,
+		   const struct value_print_options *options)
+{
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_ARRAY:
+      /* Strings are printed from the contents directly.  */
+      if (c_textual_element_type (TYPE_TARGET_TYPE (type), options->format))
+	value_fetch_lazy_range (original_value, embedded_offset,
+				TYPE_LENGTH (type));
+      break;
+
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      /* Base classes, virtual table pointers and dynamic types are
+	 found from the contents directly.  */
+      if (TYPE_N_BASECLASSES (type) > 0
+	  || TYPE_NFN_FIELDS (type) > 0
+	  || is_dynamic_type (type)
+	  || (options->vtblprint && cp_is_vtbl_ptr_type (type)))
+	{
+	  value_fetch_lazy_range (original_value, embedded_offset,
+				  TYPE_LENGTH (type));
+	  break;
+	}
+
+      /* So are bitfields.  */
+      for (int i = 0; i < TYPE_NFIELDS (type); i++)
+	if (!field_is_static (&TYPE_FIELD (type, i))
+	    && TYPE_FIELD_PACKED (type, i))
+	  {
+	    LONGEST bitpos = TYPE_FIELD_BITPOS (type, i);
+	    LONGEST start = bitpos / TARGET_CHAR_BIT;
+	    LONGEST end = ((bitpos + TYPE_FIELD_BITSIZE (type, i)
+			    + TARGET_CHAR_BIT - 1) / TARGET_CHAR_BIT);
+
+	    value_fetch_lazy_range (original_value, embedded_offset + start,
+				    end - start);
+	  }
+      break;
+
+    default:
+      value_fetch_lazy_range (original_value, embedded_offset,
+			      TYPE_LENGTH (type));
+      break;
+    }
+}
+
 /* See val_print for a description of the various parameters of this
    function; they are identical.  */
 
@@ -506,6 +562,9 @@ c_val_print (struct type *type,
   const gdb_byte *valaddr = value_contents_for_printing (original_value);
 
   type = check_typedef (type);
+  if (value_lazy (original_value))
+    c_val_print_fetch (type, embedded_offset, original_value, options);
+
   switch (TYPE_CODE (type))
     {
     case TYPE_CODE_ARRAY:
@@ -43,6 +43,8 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "gdbsupport/filestuff.h"
+#include "gdbsupport/scoped_mmap.h"
+#include <algorithm>
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -115,6 +117,28 @@ public:
 
 private: /* per-core data */
 
+  /* An entry in the segment index used to read memory.  */
+  struct core_segment
+  {
+    /* The range of target addresses covered.  */
+    CORE_ADDR addr;
+    CORE_ADDR endaddr;
+
+    /* The core file section holding the contents.  */
+    asection *section;
+
+    /* The contents of SECTION within the memory-mapped core file, or
+       NULL if they must be read through BFD.  */
+    const gdb_byte *contents;
+  };
+
+  void build_segment_index ();
+  const gdb_byte *mapped_section_contents (asection *section);
+  enum target_xfer_status xfer_memory_from_index (gdb_byte *readbuf,
+						  ULONGEST offset,
+						  ULONGEST len,
+						  ULONGEST *xfered_len);
+
   /* The core's section table.  Note that these target sections are
      *not* mapped in the current address spaces' set of target
      sections --- those should come only from pure executable or
@@ -130,6 +154,17 @@ private: /* per-core data */
   /* FIXME: kettenis/20031023: Eventually this field should
      disappear.  */
   struct gdbarch *m_core_gdbarch = NULL;
+
+#ifdef HAVE_SYS_MMAN_H
+  /* The core file, mapped read-only in memory.  Not mapped if the core
+     file may be written to, or if mapping it failed.  */
+  scoped_mmap m_core_mapping;
+#endif
+
+  /* The memory sections of the core, sorted by address.  Empty if the
+     sections overlap, in which case memory is read through the section
+     table instead.  */
+  std::vector<core_segment> m_core_segments;
 };
 
 core_target::core_target ()
@@ -145,6 +180,90 @@ core_target::core_target ()
 			   &m_core_section_table.sections_end))
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+
+  build_segment_index ();
+}
+
+/* Return a pointer to the contents of SECTION in the memory-mapped
+   core file, or NULL if they are not available there.  */
+
+const gdb_byte *
+core_target::mapped_section_contents (asection *section)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (m_core_mapping.get () == MAP_FAILED)
+    return NULL;
+
+  if ((bfd_section_flags (section) & SEC_HAS_CONTENTS) == 0
+      || (bfd_section_flags (section) & SEC_IN_MEMORY) != 0
+      || section->compress_status != COMPRESS_SECTION_NONE
+      || section->filepos < 0)
+    return NULL;
+
+  ULONGEST end = (ULONGEST) section->filepos + bfd_section_size (section);
+  if (end > m_core_mapping.size ())
+    return NULL;
+
+  return (const gdb_byte *) m_core_mapping.get () + section->filepos;
+#else
+  return NULL;
+#endif
+}
+
+/* Map the core file in memory if possible, and build the sorted index
+   of its memory sections used by xfer_memory_from_index.  */
+
+void
+core_target::build_segment_index ()
+{
+#ifdef HAVE_SYS_MMAN_H
+  /* Only ELF section file positions are known to be plain file
+     offsets.  Writes go through BFD, so don't map the file if it may
+     be written to.  */
+  if (!write_files && bfd_get_flavour (core_bfd) == bfd_target_elf_flavour)
+    {
+      try
+	{
+	  m_core_mapping = mmap_file (bfd_get_filename (core_bfd));
+	}
+      catch (const gdb_exception_error &except)
+	{
+	  /* Fall back to reading through BFD.  */
+	}
+    }
+#endif
+
+  for (target_section *p = m_core_section_table.sections;
+       p < m_core_section_table.sections_end;
+       p++)
+    {
+      if (p->endaddr <= p->addr)
+	continue;
+
+      core_segment seg;
+
+      seg.addr = p->addr;
+      seg.endaddr = p->endaddr;
+      seg.section = p->the_bfd_section;
+      seg.contents = mapped_section_contents (seg.section);
+      m_core_segments.push_back (seg);
+    }
+
+  std::sort (m_core_segments.begin (), m_core_segments.end (),
+	     [] (const core_segment &a, const core_segment &b)
+	     {
+	       return a.addr < b.addr;
+	     });
+
+  /* section_table_xfer_memory_partial uses the first section that
+     contains an address.  If any sections overlap, the sorted order
+     may pick a different one, so don't use the index at all.  */
+  for (size_t i = 1; i < m_core_segments.size (); i++)
+    if (m_core_segments[i].addr < m_core_segments[i - 1].endaddr)
+      {
+	m_core_segments.clear ();
+	break;
+      }
 }
 
 core_target::~core_target ()
@@ -597,6 +716,18 @@ core_target::get_core_register_section (struct regcache *regcache,
 	       section_name.c_str ());
     }
 
+  /* Supply register sets straight from the mapped core file.  */
+  if (regset != NULL)
+    {
+      const gdb_byte *mapped = mapped_section_contents (section);
+
+      if (mapped != NULL)
+	{
+	  regset->supply_regset (regset, regcache, -1, mapped, size);
+	  return;
+	}
+    }
+
   contents = (char *) alloca (size);
   if (! bfd_get_section_contents (core_bfd, section, contents,
 				  (file_ptr) 0, size))
@@ -709,6 +840,38 @@ core_target::files_info ()
   print_section_info (&m_core_section_table, core_bfd);
 }
 
+/* Read memory using the sorted segment index, straight from the
+   memory-mapped core file where possible.  This gives the same
+   results as section_table_xfer_memory_partial on the core's section
+   table, without a linear search or a file read per access.  */
+
+enum target_xfer_status
+core_target::xfer_memory_from_index (gdb_byte *readbuf, ULONGEST offset,
+				     ULONGEST len, ULONGEST *xfered_len)
+{
+  auto it = std::upper_bound (m_core_segments.begin (),
+			      m_core_segments.end (), offset,
+			      [] (ULONGEST addr, const core_segment &seg)
+			      {
+				return addr < seg.addr;
+			      });
+  if (it == m_core_segments.begin ())
+    return TARGET_XFER_EOF;
+  --it;
+  if (offset >= it->endaddr)
+    return TARGET_XFER_EOF;
+
+  len = std::min (len, (ULONGEST) (it->endaddr - offset));
+  if (it->contents != NULL)
+    memcpy (readbuf, it->contents + (offset - it->addr), len);
+  else if (!bfd_get_section_contents (core_bfd, it->section, readbuf,
+				      offset - it->addr, len))
+    return TARGET_XFER_EOF;
+
+  *xfered_len = len;
+  return TARGET_XFER_OK;
+}
+
 enum target_xfer_status
 core_target::xfer_partial (enum target_object object, const char *annex,
 			   gdb_byte *readbuf, const gdb_byte *writebuf,
@@ -717,6 +880,8 @@ core_target::xfer_partial (enum target_object object, const char *annex,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (readbuf != NULL && !m_core_segments.empty ())
+	return xfer_memory_from_index (readbuf, offset, len, xfered_len);
       return (section_table_xfer_memory_partial
 	      (readbuf, writebuf,
 	       offset, len, xfered_len,
@@ -253,7 +253,8 @@ extern const struct language_defn d_language_defn =
   NULL,
   NULL,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 /* Build all D language types for the specified architecture.  */
@@ -25,6 +25,7 @@
 #include "inferior.h"
 #include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -83,6 +84,12 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The number of bytes of stack read ahead when the stack cache misses,
+   at first and at most.  The read-ahead grows as long as the
+   unwinders keep walking past the end of what was read.  */
+#define DCACHE_STACK_READAHEAD 256
+#define DCACHE_STACK_MAX_READAHEAD 65536
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -116,6 +123,12 @@ struct dcache_struct
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
+
+  /* The end of the stack of PTID last read ahead by
+     dcache_read_stack_memory_partial, or 0, and how many bytes to read
+     ahead when the stack is next read past it.  */
+  CORE_ADDR stack_hi;
+  ULONGEST stack_readahead;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -249,6 +262,8 @@ dcache_invalidate (DCACHE *dcache)
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->stack_hi = 0;
+  dcache->stack_readahead = DCACHE_STACK_READAHEAD;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -453,6 +468,8 @@ dcache_init (void)
   dcache->size = 0;
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
+  dcache->stack_hi = 0;
+  dcache->stack_readahead = DCACHE_STACK_READAHEAD;
 
   return dcache;
 }
@@ -504,6 +521,127 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
     }
 }
 
+/* Return true if REGION's memory can be read, and may be cached
+   even if it wasn't asked for.  */
+
+static bool
+dcache_readahead_region_p (const struct mem_region *region)
+{
+  return (region->attrib.mode != MEM_NONE
+	  && region->attrib.mode != MEM_WO
+	  && region->attrib.cache);
+}
+
+/* See dcache.h.  */
+
+ULONGEST
+dcache_prefetch (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len)
+{
+  CORE_ADDR start = MASK (dcache, memaddr);
+  struct mem_region *region;
+  LONGEST got;
+
+  if (inferior_ptid != dcache->ptid)
+    {
+      dcache_invalidate (dcache);
+      dcache->ptid = inferior_ptid;
+    }
+
+  /* Leave reads that the cache can't hold to dcache_read_line.  */
+  len += memaddr - start;
+  len = std::min<ULONGEST> (len, (ULONGEST) dcache_size * dcache->line_size);
+
+  /* Stop at the end of MEMADDR's region, unless the regions after it
+     are readable and cacheable.  */
+  region = lookup_mem_region (start);
+  if (region->attrib.mode == MEM_NONE || region->attrib.mode == MEM_WO)
+    return 0;
+  while (region->hi != 0 && region->hi - start < len)
+    {
+      CORE_ADDR hi = region->hi;
+
+      region = lookup_mem_region (hi);
+      if (!dcache_readahead_region_p (region))
+	{
+	  len = hi - start;
+	  break;
+	}
+    }
+
+  len -= len % dcache->line_size;
+  if (len == 0)
+    return 0;
+
+  gdb::byte_vector buf (len);
+  got = target_read (current_top_target (), TARGET_OBJECT_RAW_MEMORY, NULL,
+		     buf.data (), start, len);
+  if (got <= 0)
+    return 0;
+  got -= got % dcache->line_size;
+
+  for (LONGEST i = 0; i < got; i += dcache->line_size)
+    {
+      struct dcache_block *db = dcache_hit (dcache, start + i);
+
+      if (db == NULL)
+	db = dcache_alloc (dcache, start + i);
+      memcpy (db->data, buf.data () + i, dcache->line_size);
+    }
+
+  return start + got > memaddr ? start + got - memaddr : 0;
+}
+
+/* See dcache.h.  */
+
+enum target_xfer_status
+dcache_read_stack_memory_partial (struct target_ops *ops, DCACHE *dcache,
+				  CORE_ADDR memaddr, gdb_byte *myaddr,
+				  ULONGEST len, ULONGEST *xfered_len)
+{
+  if (inferior_ptid != dcache->ptid)
+    {
+      dcache_invalidate (dcache);
+      dcache->ptid = inferior_ptid;
+    }
+
+  /* Stacks that grow down are unwound towards higher addresses, so on
+     a miss, read ahead of MEMADDR.  Unwinding reads the stack a few
+     words at a time; reading it a line at a time would cost a target
+     round-trip every LINE_SIZE bytes.  */
+  if (gdbarch_inner_than (target_gdbarch (), 1, 2)
+      && dcache_hit (dcache, memaddr) == NULL)
+    {
+      CORE_ADDR start;
+      ULONGEST got;
+
+      if (dcache->stack_hi != 0
+	  && memaddr >= dcache->stack_hi
+	  && memaddr - dcache->stack_hi < dcache->stack_readahead)
+	{
+	  /* The unwinders walked past the end of what was read ahead.
+	     Extend it, reading more at once each time, so that a long
+	     backtrace only takes a few reads.  */
+	  start = dcache->stack_hi;
+	  dcache->stack_readahead
+	    = std::min<ULONGEST> (2 * dcache->stack_readahead,
+				  DCACHE_STACK_MAX_READAHEAD);
+	}
+      else
+	{
+	  start = memaddr;
+	  dcache->stack_readahead = DCACHE_STACK_READAHEAD;
+	}
+
+      got = dcache_prefetch (dcache, start,
+			     std::max<ULONGEST> (dcache->stack_readahead,
+						 memaddr - start + len));
+      dcache->stack_hi = got > 0 ? start + got : 0;
+    }
+
+  return dcache_read_memory_partial (ops, dcache, memaddr, myaddr, len,
+				     xfered_len);
+}
+
 /* FIXME: There would be some benefit to making the cache write-back and
    moving the writeback operation to a higher layer, as it could occur
    after a sequence of smaller writes have been completed (as when a stack
@@ -48,8 +48,27 @@ enum target_xfer_status
 			      CORE_ADDR memaddr, gdb_byte *myaddr,
 			      ULONGEST len, ULONGEST *xfered_len);
 
+/* Like dcache_read_memory_partial, for reads of the stack of the
+   current thread.  When the stack is not cached, read ahead of MEMADDR
+   at once, and read further ahead each time the stack is read past
+   the end of what was read, as unwinding does.  */
+
+enum target_xfer_status
+  dcache_read_stack_memory_partial (struct target_ops *ops, DCACHE *dcache,
+				    CORE_ADDR memaddr, gdb_byte *myaddr,
+				    ULONGEST len, ULONGEST *xfered_len);
+
 void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
 
+/* Read the LEN bytes of memory at MEMADDR into DCACHE with a single
+   target read, instead of one read per cache line as they are
+   accessed.  The read stops at the end of MEMADDR's memory region,
+   unless the regions after it are readable and cacheable.  Return the
+   number of bytes from MEMADDR on that are now cached; that may be
+   less than LEN if not all of the memory could be read.  */
+
+ULONGEST dcache_prefetch (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len);
+
 #endif /* DCACHE_H */
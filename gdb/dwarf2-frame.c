@@ -39,11 +39,16 @@
 #include "ax.h"
 #include "dwarf2loc.h"
 #include "dwarf2-frame-tailcall.h"
+#include "gdb_bfd.h"
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #include "selftest-arch.h"
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
 struct comp_unit;
 
 /* Call Frame Information (CFI).  */
@@ -98,11 +103,9 @@ struct dwarf2_cie
   unsigned char segment_size;
 };
 
-struct dwarf2_cie_table
-{
-  int num_entries;
-  struct dwarf2_cie **entries;
-};
+/* CIEs keyed by their offset into the section they were read
+   from.  */
+typedef std::unordered_map<ULONGEST, dwarf2_cie *> dwarf2_cie_table;
 
 /* Frame Description Entry (FDE).  */
 
@@ -126,11 +129,8 @@ struct dwarf2_fde
   unsigned char eh_frame_p;
 };
 
-struct dwarf2_fde_table
-{
-  int num_entries;
-  struct dwarf2_fde **entries;
-};
+/* A flat array of FDEs.  */
+typedef std::vector<dwarf2_fde> dwarf2_fde_table;
 
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the call frame information.  */
@@ -158,6 +158,150 @@ struct comp_unit
   bfd_vma tbase;
 };
 
+/* The binary search table of a .eh_frame_hdr section, which the
+   linker generates to let unwinders find the FDEs of .eh_frame
+   without decoding the whole section.  FDEs are decoded on their
+   first lookup only, along with their CIEs.  */
+
+struct dwarf2_eh_frame_hdr
+{
+  /* The .eh_frame section the table describes.  */
+  struct comp_unit *unit;
+
+  /* The .eh_frame_hdr section, whose start is the base of
+     DW_EH_PE_datarel encoded values in the table.  */
+  struct comp_unit *hdr_unit;
+
+  /* The first entry of the table, and the number of entries.  Each
+     entry is the initial location of an FDE followed by the FDE's
+     address, both encoded with TABLE_ENC and FIELD_SIZE bytes
+     long.  */
+  const gdb_byte *table;
+  ULONGEST fde_count;
+  gdb_byte table_enc;
+  unsigned int field_size;
+
+  /* Target pointer size in bytes.  */
+  int ptr_size;
+
+  /* The CIEs decoded so far.  */
+  dwarf2_cie_table cies;
+
+  /* The FDEs decoded so far, keyed by their index in the table.  An
+     FDE that turned out to be empty or invalid is recorded as
+     NULL.  */
+  std::unordered_map<ULONGEST, dwarf2_fde *> fdes;
+
+  /* Set if the table pointed outside .eh_frame, or decoding an FDE
+     failed.  The table isn't used anymore then; ALL_FDES holds all
+     the FDEs of .eh_frame instead, decoded at once and sorted.  */
+  bool broken = false;
+  dwarf2_fde_table all_fdes;
+};
+
+/* A row of the call frame table, as computed by running the CFA
+   program of an FDE up to some PC: the rule for computing the CFA,
+   and the save rules of the registers.  Rows are cached per objfile
+   so that unwinding deep stacks, which keep coming back to the same
+   PCs, decodes each of them only once.  */
+
+struct dwarf2_frame_row
+{
+  /* Register rules, indexed by DWARF register number.  */
+  std::vector<struct dwarf2_frame_state_reg> reg;
+
+  /* The CFA rule.  A DW_CFA_def_cfa_expression that just adds an
+     offset to a register is turned into a CFA_REG_OFFSET rule, so it
+     doesn't need the expression evaluator.  CFA_OFFSET already has
+     the producer quirks applied to it.  As in
+     dwarf2_frame_state_reg_info, CFA_REG holds the length of CFA_EXP
+     for CFA_EXP rules.  */
+  enum cfa_how_kind cfa_how;
+  ULONGEST cfa_reg;
+  LONGEST cfa_offset;
+  const gdb_byte *cfa_exp;
+
+  /* The return address column of the CIE.  */
+  ULONGEST retaddr_column;
+
+  /* The PC the row starts at, relative to the text section.  */
+  CORE_ADDR pc;
+
+  /* The offset of the CFA from the stack pointer at the entry of the
+     function, if known.  */
+  bool entry_cfa_sp_offset_p;
+  LONGEST entry_cfa_sp_offset;
+};
+
+/* What a cached row depends on.  ENTRY_PC is only used when
+   HAVE_ENTRY_PC; PC and ENTRY_PC are relative to the text section.  */
+
+struct dwarf2_frame_row_key
+{
+  struct dwarf2_fde *fde;
+  struct gdbarch *gdbarch;
+  CORE_ADDR pc;
+  CORE_ADDR entry_pc;
+  bool have_entry_pc;
+
+  bool operator== (const dwarf2_frame_row_key &other) const
+  {
+    return (fde == other.fde
+	    && gdbarch == other.gdbarch
+	    && pc == other.pc
+	    && have_entry_pc == other.have_entry_pc
+	    && (!have_entry_pc || entry_pc == other.entry_pc));
+  }
+};
+
+struct dwarf2_frame_row_key_hash
+{
+  size_t operator() (const dwarf2_frame_row_key &key) const
+  {
+    size_t h = std::hash<void *> () (key.fde);
+
+    h = h * 31 + std::hash<CORE_ADDR> () (key.pc);
+    if (key.have_entry_pc)
+      h = h * 31 + std::hash<CORE_ADDR> () (key.entry_pc);
+    return h;
+  }
+};
+
+typedef std::unordered_map<dwarf2_frame_row_key, dwarf2_frame_row,
+			   dwarf2_frame_row_key_hash> dwarf2_frame_row_table;
+
+/* The call frame information of an objfile.  */
+
+struct dwarf2_frame_objfile_info
+{
+  /* FDEs read from .debug_frame, and from .eh_frame unless that is
+     searched through EH_FRAME_HDR, sorted by initial location.  */
+  dwarf2_fde_table fdes;
+
+  /* The search table of .eh_frame, or NULL.  */
+  std::unique_ptr<dwarf2_eh_frame_hdr> eh_frame_hdr;
+
+  /* Number of CIEs read to fill FDES.  */
+  ULONGEST num_cies = 0;
+
+  /* The last PC looked up, relative to the text section, and the FDE
+     found for it, if any.  */
+  bool last_lookup_valid = false;
+  CORE_ADDR last_seek_pc = 0;
+  struct dwarf2_fde *last_fde = NULL;
+
+  /* Rows of the call frame table computed so far.  */
+  dwarf2_frame_row_table rows;
+
+  /* Time spent in dwarf2_build_frame_info, and decoding FDEs through
+     EH_FRAME_HDR afterwards.  */
+  std::chrono::steady_clock::duration build_time {};
+  std::chrono::steady_clock::duration decode_time {};
+};
+
+static const struct objfile_key<dwarf2_frame_objfile_info>
+  dwarf2_frame_objfile_data;
+
 static struct dwarf2_fde *dwarf2_frame_find_fde (CORE_ADDR *pc,
 						 CORE_ADDR *out_offset);
 
@@ -925,6 +1069,170 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
 }
 
 
+/* If the DWARF expression EXP of LEN bytes only adds a constant to a
+   register, store the register into *REG and the constant into
+   *OFFSET, and return true.  */
+
+static bool
+dwarf2_frame_exp_is_reg_offset (const gdb_byte *exp, ULONGEST len,
+				ULONGEST *reg, LONGEST *offset)
+{
+  const gdb_byte *end = exp + len;
+  uint64_t r;
+  int64_t off;
+
+  if (len == 0)
+    return false;
+
+  if (*exp >= DW_OP_breg0 && *exp <= DW_OP_breg31)
+    r = *exp++ - DW_OP_breg0;
+  else if (*exp == DW_OP_bregx)
+    {
+      exp = gdb_read_uleb128 (exp + 1, end, &r);
+      if (exp == NULL)
+	return false;
+    }
+  else
+    return false;
+
+  if (gdb_read_sleb128 (exp, end, &off) != end)
+    return false;
+
+  *reg = r;
+  *offset = off;
+  return true;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Unit test for dwarf2_frame_exp_is_reg_offset.  */
+
+static void
+exp_is_reg_offset_test ()
+{
+  ULONGEST reg;
+  LONGEST offset;
+
+  /* DW_OP_breg7 16.  */
+  static const gdb_byte breg[] = { DW_OP_breg7, 0x10 };
+  SELF_CHECK (dwarf2_frame_exp_is_reg_offset (breg, sizeof (breg),
+					      &reg, &offset));
+  SELF_CHECK (reg == 7 && offset == 16);
+
+  /* DW_OP_bregx 40 -8.  */
+  static const gdb_byte bregx[] = { DW_OP_bregx, 0x28, 0x78 };
+  SELF_CHECK (dwarf2_frame_exp_is_reg_offset (bregx, sizeof (bregx),
+					      &reg, &offset));
+  SELF_CHECK (reg == 40 && offset == -8);
+
+  /* DW_OP_breg7 8; DW_OP_deref.  */
+  static const gdb_byte deref[] = { DW_OP_breg7, 0x08, DW_OP_deref };
+  SELF_CHECK (!dwarf2_frame_exp_is_reg_offset (deref, sizeof (deref),
+					       &reg, &offset));
+
+  /* A truncated DW_OP_bregx.  */
+  SELF_CHECK (!dwarf2_frame_exp_is_reg_offset (bregx, 2, &reg, &offset));
+
+  /* DW_OP_lit0.  */
+  static const gdb_byte lit[] = { DW_OP_lit0 };
+  SELF_CHECK (!dwarf2_frame_exp_is_reg_offset (lit, sizeof (lit),
+					       &reg, &offset));
+}
+
+} // namespace selftests
+#endif /* GDB_SELF_TEST */
+
+/* Return the row of the call frame table of FDE for PC.  If
+   HAVE_ENTRY_PC, ENTRY_PC is the entry point of the function,
+   which is where the CFA's offset from the stack pointer is
+   recorded.  TEXT_OFFSET is the offset of the objfile's text
+   section.  */
+
+static const struct dwarf2_frame_row &
+dwarf2_frame_find_row (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       CORE_ADDR text_offset, CORE_ADDR pc,
+		       bool have_entry_pc, CORE_ADDR entry_pc)
+{
+  struct dwarf2_frame_objfile_info *info
+    = dwarf2_frame_objfile_data.get (fde->cie->unit->objfile);
+  gdb_assert (info != NULL);
+
+  dwarf2_frame_row_key key;
+  key.fde = fde;
+  key.gdbarch = gdbarch;
+  key.pc = pc - text_offset;
+  key.entry_pc = have_entry_pc ? entry_pc - text_offset : 0;
+  key.have_entry_pc = have_entry_pc;
+
+  auto iter = info->rows.find (key);
+  if (iter != info->rows.end ())
+    return iter->second;
+
+  /* Allocate and initialize the frame state.  */
+  struct dwarf2_frame_state fs (fde->initial_location + text_offset,
+				fde->cie);
+  dwarf2_frame_row row;
+  const gdb_byte *instr;
+
+  row.entry_cfa_sp_offset_p = false;
+  row.entry_cfa_sp_offset = 0;
+
+  /* Check for "quirks" - known bugs in producers.  */
+  dwarf2_frame_find_quirks (&fs, fde);
+
+  /* First decode all the insns in the CIE.  */
+  execute_cfa_program (fde, fde->cie->initial_instructions,
+		       fde->cie->end, gdbarch, pc, &fs);
+
+  /* Save the initialized register set.  */
+  fs.initial = fs.regs;
+
+  if (have_entry_pc)
+    {
+      /* Decode the insns in the FDE up to the entry PC.  */
+      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
+				   entry_pc, &fs);
+
+      if (fs.regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+	      == gdbarch_sp_regnum (gdbarch)))
+	{
+	  row.entry_cfa_sp_offset = fs.regs.cfa_offset;
+	  row.entry_cfa_sp_offset_p = true;
+	}
+    }
+  else
+    instr = fde->instructions;
+
+  /* Then decode the insns in the FDE up to our target PC.  */
+  execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs);
+
+  row.reg = std::move (fs.regs.reg);
+  row.cfa_how = fs.regs.cfa_how;
+  row.cfa_reg = fs.regs.cfa_reg;
+  row.cfa_exp = fs.regs.cfa_exp;
+  if (fs.armcc_cfa_offsets_reversed)
+    row.cfa_offset = -fs.regs.cfa_offset;
+  else
+    row.cfa_offset = fs.regs.cfa_offset;
+  row.retaddr_column = fs.retaddr_column;
+  row.pc = fs.pc - text_offset;
+
+  /* The expression evaluator truncates and converts the address it
+     computes according to the target; only take the shortcut where
+     that makes no difference.  */
+  if (row.cfa_how == CFA_EXP
+      && fde->cie->addr_size >= sizeof (CORE_ADDR)
+      && !gdbarch_integer_to_address_p (gdbarch)
+      && dwarf2_frame_exp_is_reg_offset (row.cfa_exp, row.cfa_exp_len,
+					 &row.cfa_reg, &row.cfa_offset))
+    row.cfa_how = CFA_REG_OFFSET;
+
+  return info->rows.emplace (key, std::move (row)).first->second;
+}
+
 struct dwarf2_frame_cache
 {
   /* DWARF Call Frame Address.  */
@@ -976,7 +1284,6 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   struct dwarf2_frame_cache *cache;
   struct dwarf2_fde *fde;
   CORE_ADDR entry_pc;
-  const gdb_byte *instr;
 
   if (*this_cache)
     return (struct dwarf2_frame_cache *) *this_cache;
@@ -1007,65 +1314,38 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   fde = dwarf2_frame_find_fde (&pc1, &cache->text_offset);
   gdb_assert (fde != NULL);
 
-  /* Allocate and initialize the frame state.  */
-  struct dwarf2_frame_state fs (pc1, fde->cie);
-
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs);
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-
   /* Fetching the entry pc for THIS_FRAME won't necessarily result
      in an address that's within the range of FDE locations.  This
      is due to the possibility of the function occupying non-contiguous
      ranges.  */
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= entry_pc
-      && entry_pc < fde->initial_location + fde->address_range)
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, &fs);
+  bool have_entry_pc
+    = (get_frame_func_if_available (this_frame, &entry_pc)
+       && fde->initial_location <= entry_pc
+       && entry_pc < fde->initial_location + fde->address_range);
 
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  cache->entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  cache->entry_cfa_sp_offset_p = 1;
-	}
-    }
-  else
-    instr = fde->instructions;
+  const struct dwarf2_frame_row &row
+    = dwarf2_frame_find_row (gdbarch, fde, cache->text_offset,
+			     get_frame_address_in_block (this_frame),
+			     have_entry_pc, entry_pc);
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs);
+  cache->entry_cfa_sp_offset_p = row.entry_cfa_sp_offset_p;
+  cache->entry_cfa_sp_offset = row.entry_cfa_sp_offset;
 
   try
     {
       /* Calculate the CFA.  */
-      switch (fs.regs.cfa_how)
+      switch (row.cfa_how)
 	{
 	case CFA_REG_OFFSET:
-	  cache->cfa = read_addr_from_reg (this_frame, fs.regs.cfa_reg);
-	  if (fs.armcc_cfa_offsets_reversed)
-	    cache->cfa -= fs.regs.cfa_offset;
-	  else
-	    cache->cfa += fs.regs.cfa_offset;
+	  cache->cfa = (read_addr_from_reg (this_frame, row.cfa_reg)
+			+ row.cfa_offset);
 	  break;
 
 	case CFA_EXP:
 	  cache->cfa =
-	    execute_stack_op (fs.regs.cfa_exp, fs.regs.cfa_exp_len,
+	    execute_stack_op (row.cfa_exp, row.cfa_exp_len,
 			      cache->addr_size, cache->text_offset,
 			      this_frame, 0, 0);
 	  break;
@@ -1100,7 +1380,7 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   {
     int column;		/* CFI speak for "register number".  */
 
-    for (column = 0; column < fs.regs.reg.size (); column++)
+    for (column = 0; column < row.reg.size (); column++)
       {
 	/* Use the GDB register number as the destination index.  */
 	int regnum = dwarf_reg_to_regnum (gdbarch, column);
@@ -1120,16 +1400,16 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 	   problems when a debug info register falls outside of the
 	   table.  We need a way of iterating through all the valid
 	   DWARF2 register numbers.  */
-	if (fs.regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
+	if (row.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	  {
 	    if (cache->reg[regnum].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	      complaint (_("\
 incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 			 gdbarch_register_name (gdbarch, regnum),
-			 paddress (gdbarch, fs.pc));
+			 paddress (gdbarch, row.pc + cache->text_offset));
 	  }
 	else
-	  cache->reg[regnum] = fs.regs.reg[column];
+	  cache->reg[regnum] = row.reg[column];
       }
   }
 
@@ -1144,8 +1424,8 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	    || cache->reg[regnum].how == DWARF2_FRAME_REG_RA_OFFSET)
 	  {
 	    const std::vector<struct dwarf2_frame_state_reg> &regs
-	      = fs.regs.reg;
-	    ULONGEST retaddr_column = fs.retaddr_column;
+	      = row.reg;
+	    ULONGEST retaddr_column = row.retaddr_column;
 
 	    /* It seems rather bizarre to specify an "empty" column as
                the return adress column.  However, this is exactly
@@ -1154,7 +1434,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
                register corresponding to the return address column.
                Incidentally, that's how we should treat a return
                address column specifying "same value" too.  */
-	    if (fs.retaddr_column < fs.regs.reg.size ()
+	    if (row.retaddr_column < row.reg.size ()
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_UNSPECIFIED
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_SAME_VALUE)
 	      {
@@ -1167,12 +1447,12 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	      {
 		if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA)
 		  {
-		    cache->reg[regnum].loc.reg = fs.retaddr_column;
+		    cache->reg[regnum].loc.reg = row.retaddr_column;
 		    cache->reg[regnum].how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 		else
 		  {
-		    cache->retaddr_reg.loc.reg = fs.retaddr_column;
+		    cache->retaddr_reg.loc.reg = row.retaddr_column;
 		    cache->retaddr_reg.how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 	      }
@@ -1180,8 +1460,8 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
-  if (fs.retaddr_column < fs.regs.reg.size ()
-      && fs.regs.reg[fs.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
+  if (row.retaddr_column < row.reg.size ()
+      && row.reg[row.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
 
   return cache;
@@ -1469,10 +1749,6 @@ dwarf2_frame_cfa (struct frame_info *this_frame)
   return get_frame_base (this_frame);
 }
 
-const struct objfile_key<dwarf2_fde_table,
-			 gdb::noop_deleter<dwarf2_fde_table>>
-  dwarf2_frame_objfile_data;
-
 static unsigned int
 read_1_byte (bfd *abfd, const gdb_byte *buf)
 {
@@ -1641,66 +1917,309 @@ read_encoded_value (struct comp_unit *unit, gdb_byte encoding,
 }
 
 
+#define DW64_CIE_ID 0xffffffffffffffffULL
+
+/* Defines the type of eh_frames that are expected to be decoded: CIE, FDE
+   or any of them.  */
+
+enum eh_frame_type
+{
+  EH_CIE_TYPE_ID = 1 << 0,
+  EH_FDE_TYPE_ID = 1 << 1,
+  EH_CIE_OR_FDE_TYPE_ID = EH_CIE_TYPE_ID | EH_FDE_TYPE_ID
+};
+
+static const gdb_byte *decode_frame_entry (struct comp_unit *unit,
+					   const gdb_byte *start,
+					   int eh_frame_p,
+					   dwarf2_cie_table &cie_table,
+					   dwarf2_fde_table *fde_table,
+					   enum eh_frame_type entry_type);
+static void sort_fde_table (dwarf2_fde_table *fde_table);
+
+/* Find CIE with the given CIE_POINTER in CIE_TABLE.  */
+static struct dwarf2_cie *
+find_cie (const dwarf2_cie_table &cie_table, ULONGEST cie_pointer)
+{
+  auto iter = cie_table.find (cie_pointer);
+  if (iter != cie_table.end ())
+    return iter->second;
+  return NULL;
+}
+
 static int
-bsearch_cie_cmp (const void *key, const void *element)
+bsearch_fde_cmp (const void *key, const void *element)
 {
-  ULONGEST cie_pointer = *(ULONGEST *) key;
-  struct dwarf2_cie *cie = *(struct dwarf2_cie **) element;
+  CORE_ADDR seek_pc = *(CORE_ADDR *) key;
+  const struct dwarf2_fde *fde = (const struct dwarf2_fde *) element;
+
+  if (seek_pc < fde->initial_location)
+    return -1;
+  if (seek_pc < fde->initial_location + fde->address_range)
+    return 0;
+  return 1;
+}
+
+/* Return the size in bytes of values encoded with ENCODING, or 0 if
+   that isn't an encoding read_encoded_value can decode, or if values
+   encoded with it don't have a fixed size.  PTR_SIZE is the target
+   pointer size.  */
 
-  if (cie_pointer == cie->cie_pointer)
+static unsigned int
+fixed_encoding_size (gdb_byte encoding, int ptr_size)
+{
+  if ((encoding & DW_EH_PE_indirect) != 0
+      || (encoding & 0x70) > DW_EH_PE_funcrel)
     return 0;
 
-  return (cie_pointer < cie->cie_pointer) ? -1 : 1;
+  switch (encoding & 0x0f)
+    {
+    case DW_EH_PE_absptr:
+      return ptr_size;
+    case DW_EH_PE_udata2:
+    case DW_EH_PE_sdata2:
+      return 2;
+    case DW_EH_PE_udata4:
+    case DW_EH_PE_sdata4:
+      return 4;
+    case DW_EH_PE_udata8:
+    case DW_EH_PE_sdata8:
+      return 8;
+    default:
+      return 0;
+    }
 }
 
-/* Find CIE with the given CIE_POINTER in CIE_TABLE.  */
-static struct dwarf2_cie *
-find_cie (struct dwarf2_cie_table *cie_table, ULONGEST cie_pointer)
+/* Return field IX of entry N of the .eh_frame_hdr table HDR: the
+   initial location of the entry's FDE if IX is 0, or the FDE's
+   address if IX is 1.  */
+
+static CORE_ADDR
+eh_frame_hdr_field (const struct dwarf2_eh_frame_hdr *hdr, ULONGEST n,
+		    int ix)
 {
-  struct dwarf2_cie **p_cie;
+  const gdb_byte *buf = hdr->table + (2 * n + ix) * hdr->field_size;
+  unsigned int bytes_read;
+
+  return read_encoded_value (hdr->hdr_unit, hdr->table_enc, hdr->ptr_size,
+			     buf, &bytes_read, 0);
+}
 
-  /* The C standard (ISO/IEC 9899:TC2) requires the BASE argument to
-     bsearch be non-NULL.  */
-  if (cie_table->entries == NULL)
+/* Return the initial location of the FDE of entry N of the
+   .eh_frame_hdr table HDR.  */
+
+static CORE_ADDR
+eh_frame_hdr_initial_location (const struct dwarf2_eh_frame_hdr *hdr,
+			       ULONGEST n)
+{
+  struct gdbarch *gdbarch = get_objfile_arch (hdr->unit->objfile);
+
+  return gdbarch_adjust_dwarf2_addr (gdbarch, eh_frame_hdr_field (hdr, n, 0));
+}
+
+/* Stop using the .eh_frame_hdr table HDR, and decode all of the
+   .eh_frame section it describes instead, as if there were no
+   table.  */
+
+static void
+eh_frame_hdr_read_all (struct dwarf2_eh_frame_hdr *hdr)
+{
+  struct comp_unit *unit = hdr->unit;
+  const gdb_byte *frame_ptr = unit->dwarf_frame_buffer;
+  dwarf2_cie_table cie_table;
+
+  hdr->broken = true;
+
+  try
     {
-      gdb_assert (cie_table->num_entries == 0);
+      while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
+	frame_ptr = decode_frame_entry (unit, frame_ptr, 1, cie_table,
+					&hdr->all_fdes,
+					EH_CIE_OR_FDE_TYPE_ID);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      warning (_("skipping .eh_frame info of %s: %s"),
+	       objfile_name (unit->objfile), e.what ());
+      hdr->all_fdes.clear ();
+    }
+
+  sort_fde_table (&hdr->all_fdes);
+}
+
+/* Decode the FDE of entry N of the .eh_frame_hdr table of INFO.
+   Return NULL if the FDE is empty or invalid.  If the table turns out
+   to be broken, switch to decoding all of .eh_frame.  */
+
+static struct dwarf2_fde *
+eh_frame_hdr_decode_fde (struct dwarf2_frame_objfile_info *info,
+			 ULONGEST n)
+{
+  struct dwarf2_eh_frame_hdr *hdr = info->eh_frame_hdr.get ();
+  struct comp_unit *unit = hdr->unit;
+  struct objfile *objfile = unit->objfile;
+  CORE_ADDR fde_addr = eh_frame_hdr_field (hdr, n, 1);
+  CORE_ADDR section_addr = bfd_section_vma (unit->dwarf_frame_section);
+  dwarf2_fde_table fde_table;
+
+  if (fde_addr < section_addr
+      || fde_addr - section_addr >= unit->dwarf_frame_size)
+    {
+      complaint (_("Invalid FDE address %s in .eh_frame_hdr of %s"),
+		 paddress (get_objfile_arch (objfile), fde_addr),
+		 objfile_name (objfile));
+      eh_frame_hdr_read_all (hdr);
       return NULL;
     }
 
-  p_cie = ((struct dwarf2_cie **)
-	   bsearch (&cie_pointer, cie_table->entries, cie_table->num_entries,
-		    sizeof (cie_table->entries[0]), bsearch_cie_cmp));
-  if (p_cie != NULL)
-    return *p_cie;
-  return NULL;
+  try
+    {
+      decode_frame_entry (unit,
+			  unit->dwarf_frame_buffer + (fde_addr - section_addr),
+			  1, hdr->cies, &fde_table, EH_FDE_TYPE_ID);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      complaint (_("Invalid FDE at %s in .eh_frame of %s: %s"),
+		 paddress (get_objfile_arch (objfile), fde_addr),
+		 objfile_name (objfile), e.what ());
+      eh_frame_hdr_read_all (hdr);
+      return NULL;
+    }
+
+  if (fde_table.empty ())
+    return NULL;
+
+  struct dwarf2_fde *fde = XOBNEW (&objfile->objfile_obstack,
+				   struct dwarf2_fde);
+  *fde = fde_table[0];
+  return fde;
 }
 
-/* Add a pointer to new CIE to the CIE_TABLE, allocating space for it.  */
-static void
-add_cie (struct dwarf2_cie_table *cie_table, struct dwarf2_cie *cie)
+/* Find the FDE for SEEK_PC, an address relative to the objfile's text
+   section, through the .eh_frame_hdr table of INFO, if there is
+   one.  */
+
+static struct dwarf2_fde *
+eh_frame_hdr_find_fde (struct dwarf2_frame_objfile_info *info,
+		       CORE_ADDR seek_pc)
 {
-  const int n = cie_table->num_entries;
+  struct dwarf2_eh_frame_hdr *hdr = info->eh_frame_hdr.get ();
+
+  if (hdr == NULL || hdr->broken)
+    return NULL;
+
+  /* Find the last entry whose FDE starts at or before SEEK_PC.  */
+  ULONGEST lo = 0, hi = hdr->fde_count;
+
+  while (lo < hi)
+    {
+      ULONGEST mid = lo + (hi - lo) / 2;
+
+      if (eh_frame_hdr_initial_location (hdr, mid) <= seek_pc)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == 0)
+    return NULL;
+
+  struct dwarf2_fde *fde;
+  auto iter = hdr->fdes.find (lo - 1);
+
+  if (iter != hdr->fdes.end ())
+    fde = iter->second;
+  else
+    {
+      auto start = std::chrono::steady_clock::now ();
 
-  gdb_assert (n < 1
-              || cie_table->entries[n - 1]->cie_pointer < cie->cie_pointer);
+      fde = eh_frame_hdr_decode_fde (info, lo - 1);
+      hdr->fdes.emplace (lo - 1, fde);
+      info->decode_time += std::chrono::steady_clock::now () - start;
+    }
 
-  cie_table->entries
-    = XRESIZEVEC (struct dwarf2_cie *, cie_table->entries, n + 1);
-  cie_table->entries[n] = cie;
-  cie_table->num_entries = n + 1;
+  if (fde != NULL
+      && seek_pc >= fde->initial_location
+      && seek_pc < fde->initial_location + fde->address_range)
+    return fde;
+  return NULL;
 }
 
-static int
-bsearch_fde_cmp (const void *key, const void *element)
+/* Find the FDE for *PC in OBJFILE.  Return a pointer to the FDE, and
+   store the initial location associated with it into *PC.  */
+
+static struct dwarf2_fde *
+find_fde_in_objfile (struct objfile *objfile, CORE_ADDR *pc,
+		     CORE_ADDR *out_offset)
 {
-  CORE_ADDR seek_pc = *(CORE_ADDR *) key;
-  struct dwarf2_fde *fde = *(struct dwarf2_fde **) element;
+  struct dwarf2_frame_objfile_info *info;
+  struct dwarf2_fde *fde = NULL;
+  CORE_ADDR offset;
+  CORE_ADDR seek_pc;
 
-  if (seek_pc < fde->initial_location)
-    return -1;
-  if (seek_pc < fde->initial_location + fde->address_range)
-    return 0;
-  return 1;
+  info = dwarf2_frame_objfile_data.get (objfile);
+  if (info == NULL)
+    {
+      dwarf2_build_frame_info (objfile);
+      info = dwarf2_frame_objfile_data.get (objfile);
+    }
+  gdb_assert (info != NULL);
+
+  if (info->fdes.empty () && info->eh_frame_hdr == NULL)
+    return NULL;
+
+  gdb_assert (objfile->section_offsets);
+  offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+  seek_pc = *pc - offset;
+
+  /* The sniffers, and then the unwinder, look up the same frame's PC
+     in turn.  */
+  if (info->last_lookup_valid && info->last_seek_pc == seek_pc)
+    fde = info->last_fde;
+  else
+    {
+      /* FDEs from .debug_frame take precedence over those of
+	 .eh_frame.  */
+      if (!info->fdes.empty ()
+	  && *pc >= offset + info->fdes[0].initial_location)
+	fde = ((struct dwarf2_fde *)
+	       bsearch (&seek_pc, info->fdes.data (), info->fdes.size (),
+			sizeof (info->fdes[0]), bsearch_fde_cmp));
+
+      if (fde == NULL
+	  && info->eh_frame_hdr != NULL
+	  && !info->eh_frame_hdr->broken
+	  && *pc >= offset + eh_frame_hdr_initial_location
+				(info->eh_frame_hdr.get (), 0))
+	fde = eh_frame_hdr_find_fde (info, seek_pc);
+
+      /* That may have found the table broken; look through all of
+	 .eh_frame then.  */
+      if (fde == NULL
+	  && info->eh_frame_hdr != NULL
+	  && info->eh_frame_hdr->broken)
+	{
+	  dwarf2_fde_table &all_fdes = info->eh_frame_hdr->all_fdes;
+
+	  if (!all_fdes.empty ()
+	      && *pc >= offset + all_fdes[0].initial_location)
+	    fde = ((struct dwarf2_fde *)
+		   bsearch (&seek_pc, all_fdes.data (), all_fdes.size (),
+			    sizeof (all_fdes[0]), bsearch_fde_cmp));
+	}
+
+      info->last_lookup_valid = true;
+      info->last_seek_pc = seek_pc;
+      info->last_fde = fde;
+    }
+
+  if (fde != NULL)
+    {
+      *pc = fde->initial_location + offset;
+      if (out_offset)
+	*out_offset = offset;
+    }
+  return fde;
 }
 
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
@@ -1709,88 +2228,63 @@ bsearch_fde_cmp (const void *key, const void *element)
 static struct dwarf2_fde *
 dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
 {
-  for (objfile *objfile : current_program_space->objfiles ())
+  /* Go straight to the objfile PC is in, through the program space's
+     address-ordered map of sections, which is rebuilt whenever
+     objfiles are added, removed or relocated.  With hundreds of
+     shared libraries, trying each objfile in turn, for each frame,
+     takes a while.  The objfile's FDEs may be in its separate debug
+     objfiles too.  */
+  struct obj_section *section = find_pc_section (*pc);
+
+  if (section != NULL)
     {
-      struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
-      CORE_ADDR offset;
-      CORE_ADDR seek_pc;
+      struct objfile *objfile = section->objfile;
 
-      fde_table = dwarf2_frame_objfile_data.get (objfile);
-      if (fde_table == NULL)
-	{
-	  dwarf2_build_frame_info (objfile);
-	  fde_table = dwarf2_frame_objfile_data.get (objfile);
-	}
-      gdb_assert (fde_table != NULL);
+      if (objfile->separate_debug_objfile_backlink != NULL)
+	objfile = objfile->separate_debug_objfile_backlink;
 
-      if (fde_table->num_entries == 0)
-	continue;
+      for (struct objfile *iter : objfile->separate_debug_objfiles ())
+	{
+	  struct dwarf2_fde *fde = find_fde_in_objfile (iter, pc, out_offset);
 
-      gdb_assert (objfile->section_offsets);
-      offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+	  if (fde != NULL)
+	    return fde;
+	}
+      return NULL;
+    }
 
-      gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
-        continue;
+  /* PC isn't in any known section, e.g., it is in code generated at
+     run time; look through all the objfiles.  */
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      struct dwarf2_fde *fde = find_fde_in_objfile (objfile, pc, out_offset);
 
-      seek_pc = *pc - offset;
-      p_fde = ((struct dwarf2_fde **)
-	       bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
-                        sizeof (fde_table->entries[0]), bsearch_fde_cmp));
-      if (p_fde != NULL)
-        {
-          *pc = (*p_fde)->initial_location + offset;
-	  if (out_offset)
-	    *out_offset = offset;
-          return *p_fde;
-        }
+      if (fde != NULL)
+	return fde;
     }
   return NULL;
 }
 
-/* Add a pointer to new FDE to the FDE_TABLE, allocating space for it.  */
+/* Add FDE to the FDE_TABLE, unless it is empty.  */
 static void
-add_fde (struct dwarf2_fde_table *fde_table, struct dwarf2_fde *fde)
+add_fde (dwarf2_fde_table *fde_table, const struct dwarf2_fde &fde)
 {
-  if (fde->address_range == 0)
+  if (fde.address_range == 0)
     /* Discard useless FDEs.  */
     return;
 
-  fde_table->num_entries += 1;
-  fde_table->entries = XRESIZEVEC (struct dwarf2_fde *, fde_table->entries,
-				   fde_table->num_entries);
-  fde_table->entries[fde_table->num_entries - 1] = fde;
+  fde_table->push_back (fde);
 }
 
-#define DW64_CIE_ID 0xffffffffffffffffULL
-
-/* Defines the type of eh_frames that are expected to be decoded: CIE, FDE
-   or any of them.  */
-
-enum eh_frame_type
-{
-  EH_CIE_TYPE_ID = 1 << 0,
-  EH_FDE_TYPE_ID = 1 << 1,
-  EH_CIE_OR_FDE_TYPE_ID = EH_CIE_TYPE_ID | EH_FDE_TYPE_ID
-};
-
-static const gdb_byte *decode_frame_entry (struct comp_unit *unit,
-					   const gdb_byte *start,
-					   int eh_frame_p,
-					   struct dwarf2_cie_table *cie_table,
-					   struct dwarf2_fde_table *fde_table,
-					   enum eh_frame_type entry_type);
-
 /* Decode the next CIE or FDE, entry_type specifies the expected type.
    Return NULL if invalid input, otherwise the next byte to be processed.  */
 
 static const gdb_byte *
 decode_frame_entry_1 (struct comp_unit *unit, const gdb_byte *start,
 		      int eh_frame_p,
-                      struct dwarf2_cie_table *cie_table,
-                      struct dwarf2_fde_table *fde_table,
-                      enum eh_frame_type entry_type)
+		      dwarf2_cie_table &cie_table,
+		      dwarf2_fde_table *fde_table,
+		      enum eh_frame_type entry_type)
 {
   struct gdbarch *gdbarch = get_objfile_arch (unit->objfile);
   const gdb_byte *buf, *end;
@@ -2007,12 +2501,13 @@ decode_frame_entry_1 (struct comp_unit *unit, const gdb_byte *start,
       cie->end = end;
       cie->unit = unit;
 
-      add_cie (cie_table, cie);
+      cie_table[cie_pointer] = cie;
     }
   else
     {
       /* This is a FDE.  */
-      struct dwarf2_fde *fde;
+      struct dwarf2_fde fde_storage;
+      struct dwarf2_fde *fde = &fde_storage;
       CORE_ADDR addr;
 
       /* Check that an FDE was expected.  */
@@ -2033,7 +2528,6 @@ decode_frame_entry_1 (struct comp_unit *unit, const gdb_byte *start,
       if (cie_pointer >= unit->dwarf_frame_size)
 	return NULL;
 
-      fde = XOBNEW (&unit->objfile->objfile_obstack, struct dwarf2_fde);
       fde->cie = find_cie (cie_table, cie_pointer);
       if (fde->cie == NULL)
 	{
@@ -2078,7 +2572,7 @@ decode_frame_entry_1 (struct comp_unit *unit, const gdb_byte *start,
 
       fde->eh_frame_p = eh_frame_p;
 
-      add_fde (fde_table, fde);
+      add_fde (fde_table, *fde);
     }
 
   return end;
@@ -2090,9 +2584,9 @@ decode_frame_entry_1 (struct comp_unit *unit, const gdb_byte *start,
 static const gdb_byte *
 decode_frame_entry (struct comp_unit *unit, const gdb_byte *start,
 		    int eh_frame_p,
-                    struct dwarf2_cie_table *cie_table,
-                    struct dwarf2_fde_table *fde_table,
-                    enum eh_frame_type entry_type)
+		    dwarf2_cie_table &cie_table,
+		    dwarf2_fde_table *fde_table,
+		    enum eh_frame_type entry_type)
 {
   enum { NONE, ALIGN4, ALIGN8, FAIL } workaround = NONE;
   const gdb_byte *ret;
@@ -2181,25 +2675,168 @@ Corrupt data in %s:%s; align 8 workaround apparently succeeded"),
   return ret;
 }
 
-static int
-qsort_fde_cmp (const void *a, const void *b)
-{
-  struct dwarf2_fde *aa = *(struct dwarf2_fde **)a;
-  struct dwarf2_fde *bb = *(struct dwarf2_fde **)b;
+/* Return true if FDE AA should be sorted before FDE BB.  */
 
-  if (aa->initial_location == bb->initial_location)
+static bool
+fde_is_less_than (const dwarf2_fde &aa, const dwarf2_fde &bb)
+{
+  if (aa.initial_location == bb.initial_location)
     {
-      if (aa->address_range != bb->address_range
-          && aa->eh_frame_p == 0 && bb->eh_frame_p == 0)
+      if (aa.address_range != bb.address_range
+          && aa.eh_frame_p == 0 && bb.eh_frame_p == 0)
         /* Linker bug, e.g. gold/10400.
            Work around it by keeping stable sort order.  */
-        return (a < b) ? -1 : 1;
+        return false;
       else
         /* Put eh_frame entries after debug_frame ones.  */
-        return aa->eh_frame_p - bb->eh_frame_p;
+        return aa.eh_frame_p < bb.eh_frame_p;
+    }
+
+  return aa.initial_location < bb.initial_location;
+}
+
+/* Sort FDE_TABLE for lookups with bsearch_fde_cmp, and squeeze out
+   duplicates and leftovers from --gc-sections.  */
+
+static void
+sort_fde_table (dwarf2_fde_table *fde_table)
+{
+  if (fde_table->empty ())
+    return;
+
+  const struct dwarf2_fde *first_non_zero_fde = NULL;
+  CORE_ADDR first_non_zero_start = 0;
+
+  /* Prepare FDE table for lookups.  */
+  std::stable_sort (fde_table->begin (), fde_table->end (),
+		    fde_is_less_than);
+
+  /* Check for leftovers from --gc-sections.  The GNU linker sets
+     the relevant symbols to zero, but doesn't zero the FDE *end*
+     ranges because there's no relocation there.  It's (offset,
+     length), not (start, end).  On targets where address zero is
+     just another valid address this can be a problem, since the
+     FDEs appear to be non-empty in the output --- we could pick
+     out the wrong FDE.  To work around this, when overlaps are
+     detected, we prefer FDEs that do not start at zero.
+
+     Start by finding the first FDE with non-zero start.  Below
+     we'll discard all FDEs that start at zero and overlap this
+     one.  */
+  for (const dwarf2_fde &fde : *fde_table)
+    {
+      if (fde.initial_location != 0)
+	{
+	  first_non_zero_fde = &fde;
+	  first_non_zero_start = fde.initial_location;
+	  break;
+	}
+    }
+
+  /* Since we'll be doing bsearch, squeeze out identical (except
+     for eh_frame_p) fde entries so bsearch result is predictable.
+     Also discard leftovers from --gc-sections.  The kept entries
+     are moved down in place.  */
+  size_t count = 0;
+  for (const dwarf2_fde &fde : *fde_table)
+    {
+      if (fde.initial_location == 0
+	  && first_non_zero_fde != NULL
+	  && (first_non_zero_start
+	      < fde.initial_location + fde.address_range))
+	continue;
+
+      if (count > 0
+	  && (*fde_table)[count - 1].initial_location == fde.initial_location)
+	continue;
+
+      (*fde_table)[count++] = fde;
     }
 
-  return (aa->initial_location < bb->initial_location) ? -1 : 1;
+  /* Keep the table as a single flat array.  */
+  fde_table->resize (count);
+  fde_table->shrink_to_fit ();
+}
+
+/* Set up the search table of the .eh_frame_hdr section of OBJFILE, for
+   the .eh_frame section described by UNIT.  Return NULL if there is
+   no such table, or it can't be used.  */
+
+static std::unique_ptr<dwarf2_eh_frame_hdr>
+read_eh_frame_hdr (struct objfile *objfile, struct comp_unit *unit)
+{
+  struct gdbarch *gdbarch = get_objfile_arch (objfile);
+  asection *section;
+  const gdb_byte *buf, *end;
+  bfd_size_type size;
+  unsigned int bytes_read;
+
+  section = bfd_get_section_by_name (unit->abfd, ".eh_frame_hdr");
+  if (section == NULL
+      || (bfd_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return NULL;
+
+  buf = gdb_bfd_map_section (section, &size);
+  end = buf + size;
+
+  /* Version, encodings of the .eh_frame pointer, of the FDE count and
+     of the table entries.  */
+  if (size < 4 || buf[0] != 1)
+    return NULL;
+
+  gdb_byte eh_frame_ptr_enc = buf[1];
+  gdb_byte fde_count_enc = buf[2];
+  gdb_byte table_enc = buf[3];
+  int ptr_size = gdbarch_ptr_bit (gdbarch) / TARGET_CHAR_BIT;
+  unsigned int eh_frame_ptr_size = fixed_encoding_size (eh_frame_ptr_enc,
+							ptr_size);
+  unsigned int fde_count_size = fixed_encoding_size (fde_count_enc,
+						     ptr_size);
+  unsigned int field_size = fixed_encoding_size (table_enc, ptr_size);
+
+  /* The linker leaves the table out, and sets the encodings to
+     DW_EH_PE_omit, when it can't sort the FDEs.  */
+  if (eh_frame_ptr_size == 0 || fde_count_size == 0 || field_size == 0)
+    return NULL;
+
+  buf += 4;
+  if (end - buf < eh_frame_ptr_size + fde_count_size)
+    return NULL;
+
+  std::unique_ptr<dwarf2_eh_frame_hdr> hdr (new dwarf2_eh_frame_hdr);
+
+  hdr->unit = unit;
+  hdr->ptr_size = ptr_size;
+  hdr->table_enc = table_enc;
+  hdr->field_size = field_size;
+
+  hdr->hdr_unit = XOBNEW (&objfile->objfile_obstack, comp_unit);
+  hdr->hdr_unit->abfd = unit->abfd;
+  hdr->hdr_unit->objfile = objfile;
+  hdr->hdr_unit->dwarf_frame_buffer = end - size;
+  hdr->hdr_unit->dwarf_frame_size = size;
+  hdr->hdr_unit->dwarf_frame_section = section;
+  hdr->hdr_unit->dbase = bfd_section_vma (section);
+  hdr->hdr_unit->tbase = unit->tbase;
+
+  /* The table must describe this objfile's .eh_frame section.  */
+  CORE_ADDR eh_frame_addr
+    = read_encoded_value (hdr->hdr_unit, eh_frame_ptr_enc, ptr_size,
+			  buf, &bytes_read, 0);
+  buf += bytes_read;
+  if (eh_frame_addr != bfd_section_vma (unit->dwarf_frame_section))
+    return NULL;
+
+  hdr->fde_count = read_encoded_value (hdr->hdr_unit, fde_count_enc,
+				       ptr_size, buf, &bytes_read, 0);
+  buf += bytes_read;
+  hdr->table = buf;
+
+  if (hdr->fde_count == 0
+      || hdr->fde_count > (end - buf) / (2 * field_size))
+    return NULL;
+
+  return hdr;
 }
 
 void
@@ -2207,15 +2844,13 @@ dwarf2_build_frame_info (struct objfile *objfile)
 {
   struct comp_unit *unit;
   const gdb_byte *frame_ptr;
-  struct dwarf2_cie_table cie_table;
-  struct dwarf2_fde_table fde_table;
-  struct dwarf2_fde_table *fde_table2;
-
-  cie_table.num_entries = 0;
-  cie_table.entries = NULL;
+  dwarf2_cie_table cie_table;
+  dwarf2_fde_table fde_table;
+  struct dwarf2_frame_objfile_info *info;
+  auto start_time = std::chrono::steady_clock::now ();
 
-  fde_table.num_entries = 0;
-  fde_table.entries = NULL;
+  info = new dwarf2_frame_objfile_info;
+  dwarf2_frame_objfile_data.set (objfile, info);
 
   /* Build a minimal decoding of the DWARF2 compilation unit.  */
   unit = XOBNEW (&objfile->objfile_obstack, comp_unit);
@@ -2250,53 +2885,64 @@ dwarf2_build_frame_info (struct objfile *objfile)
           if (txt)
             unit->tbase = txt->vma;
 
-	  try
-	    {
-	      frame_ptr = unit->dwarf_frame_buffer;
-	      while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
-		frame_ptr = decode_frame_entry (unit, frame_ptr, 1,
-						&cie_table, &fde_table,
-						EH_CIE_OR_FDE_TYPE_ID);
-	    }
+	  /* If the linker sorted the FDEs into a search table, decode
+	     them only as they are looked up.  That saves reading
+	     through the whole section, which takes a while for large
+	     programs.  */
+	  info->eh_frame_hdr = read_eh_frame_hdr (objfile, unit);
 
-	  catch (const gdb_exception_error &e)
+	  if (info->eh_frame_hdr == NULL)
 	    {
-	      warning (_("skipping .eh_frame info of %s: %s"),
-		       objfile_name (objfile), e.what ());
+	      try
+		{
+		  frame_ptr = unit->dwarf_frame_buffer;
+		  while (frame_ptr < (unit->dwarf_frame_buffer
+				      + unit->dwarf_frame_size))
+		    frame_ptr = decode_frame_entry (unit, frame_ptr, 1,
+						    cie_table, &fde_table,
+						    EH_CIE_OR_FDE_TYPE_ID);
+		}
 
-	      if (fde_table.num_entries != 0)
+	      catch (const gdb_exception_error &e)
 		{
-                  xfree (fde_table.entries);
-		  fde_table.entries = NULL;
-		  fde_table.num_entries = 0;
+		  warning (_("skipping .eh_frame info of %s: %s"),
+			   objfile_name (objfile), e.what ());
+
+		  fde_table.clear ();
+		  /* The cie_table is discarded below.  */
 		}
-	      /* The cie_table is discarded by the next if.  */
-	    }
 
-          if (cie_table.num_entries != 0)
-            {
-              /* Reinit cie_table: debug_frame has different CIEs.  */
-              xfree (cie_table.entries);
-              cie_table.num_entries = 0;
-              cie_table.entries = NULL;
-            }
+	      /* Reinit cie_table: debug_frame has different CIEs.  */
+	      info->num_cies += cie_table.size ();
+	      cie_table.clear ();
+	    }
         }
     }
 
+  if (info->eh_frame_hdr != NULL)
+    {
+      /* The search table keeps referring to UNIT; read .debug_frame
+	 through a copy.  */
+      struct comp_unit *eh_frame_unit = unit;
+
+      unit = XOBNEW (&objfile->objfile_obstack, comp_unit);
+      *unit = *eh_frame_unit;
+    }
+
   dwarf2_get_section_info (objfile, DWARF2_DEBUG_FRAME,
                            &unit->dwarf_frame_section,
                            &unit->dwarf_frame_buffer,
                            &unit->dwarf_frame_size);
   if (unit->dwarf_frame_size)
     {
-      int num_old_fde_entries = fde_table.num_entries;
+      size_t num_old_fde_entries = fde_table.size ();
 
       try
 	{
 	  frame_ptr = unit->dwarf_frame_buffer;
 	  while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
 	    frame_ptr = decode_frame_entry (unit, frame_ptr, 0,
-					    &cie_table, &fde_table,
+					    cie_table, &fde_table,
 					    EH_CIE_OR_FDE_TYPE_ID);
 	}
       catch (const gdb_exception_error &e)
@@ -2304,106 +2950,72 @@ dwarf2_build_frame_info (struct objfile *objfile)
 	  warning (_("skipping .debug_frame info of %s: %s"),
 		   objfile_name (objfile), e.what ());
 
-	  if (fde_table.num_entries != 0)
-	    {
-	      fde_table.num_entries = num_old_fde_entries;
-	      if (num_old_fde_entries == 0)
-		{
-		  xfree (fde_table.entries);
-		  fde_table.entries = NULL;
-		}
-	      else
-		{
-		  fde_table.entries
-		    = XRESIZEVEC (struct dwarf2_fde *, fde_table.entries,
-				  fde_table.num_entries);
-		}
-	    }
-	  fde_table.num_entries = num_old_fde_entries;
-	  /* The cie_table is discarded by the next if.  */
+	  fde_table.resize (num_old_fde_entries);
 	}
+
+      info->num_cies += cie_table.size ();
     }
 
-  /* Discard the cie_table, it is no longer needed.  */
-  if (cie_table.num_entries != 0)
+  if (!fde_table.empty ())
     {
-      xfree (cie_table.entries);
-      cie_table.entries = NULL;   /* Paranoia.  */
-      cie_table.num_entries = 0;  /* Paranoia.  */
+      sort_fde_table (&fde_table);
+      info->fdes = std::move (fde_table);
     }
 
-  /* Copy fde_table to obstack: it is needed at runtime.  */
-  fde_table2 = XOBNEW (&objfile->objfile_obstack, struct dwarf2_fde_table);
+  info->build_time = std::chrono::steady_clock::now () - start_time;
+}
 
-  if (fde_table.num_entries == 0)
-    {
-      fde_table2->entries = NULL;
-      fde_table2->num_entries = 0;
-    }
-  else
-    {
-      struct dwarf2_fde *fde_prev = NULL;
-      struct dwarf2_fde *first_non_zero_fde = NULL;
-      int i;
-
-      /* Prepare FDE table for lookups.  */
-      qsort (fde_table.entries, fde_table.num_entries,
-             sizeof (fde_table.entries[0]), qsort_fde_cmp);
-
-      /* Check for leftovers from --gc-sections.  The GNU linker sets
-	 the relevant symbols to zero, but doesn't zero the FDE *end*
-	 ranges because there's no relocation there.  It's (offset,
-	 length), not (start, end).  On targets where address zero is
-	 just another valid address this can be a problem, since the
-	 FDEs appear to be non-empty in the output --- we could pick
-	 out the wrong FDE.  To work around this, when overlaps are
-	 detected, we prefer FDEs that do not start at zero.
-
-	 Start by finding the first FDE with non-zero start.  Below
-	 we'll discard all FDEs that start at zero and overlap this
-	 one.  */
-      for (i = 0; i < fde_table.num_entries; i++)
-	{
-	  struct dwarf2_fde *fde = fde_table.entries[i];
+/* See dwarf2-frame.h.  */
 
-	  if (fde->initial_location != 0)
-	    {
-	      first_non_zero_fde = fde;
-	      break;
-	    }
-	}
+void
+dwarf2_frame_print_statistics (struct objfile *objfile)
+{
+  using namespace std::chrono;
 
-      /* Since we'll be doing bsearch, squeeze out identical (except
-	 for eh_frame_p) fde entries so bsearch result is predictable.
-	 Also discard leftovers from --gc-sections.  */
-      fde_table2->num_entries = 0;
-      for (i = 0; i < fde_table.num_entries; i++)
-	{
-	  struct dwarf2_fde *fde = fde_table.entries[i];
-
-	  if (fde->initial_location == 0
-	      && first_non_zero_fde != NULL
-	      && (first_non_zero_fde->initial_location
-		  < fde->initial_location + fde->address_range))
-	    continue;
-
-	  if (fde_prev != NULL
-	      && fde_prev->initial_location == fde->initial_location)
-	    continue;
-
-	  obstack_grow (&objfile->objfile_obstack, &fde_table.entries[i],
-			sizeof (fde_table.entries[0]));
-	  ++fde_table2->num_entries;
-	  fde_prev = fde;
-	}
-      fde_table2->entries
-	= (struct dwarf2_fde **) obstack_finish (&objfile->objfile_obstack);
+  const struct dwarf2_frame_objfile_info *info
+    = dwarf2_frame_objfile_data.get (objfile);
 
-      /* Discard the original fde_table.  */
-      xfree (fde_table.entries);
-    }
+  if (info == NULL)
+    return;
 
-  dwarf2_frame_objfile_data.set (objfile, fde_table2);
+  const struct dwarf2_eh_frame_hdr *hdr = info->eh_frame_hdr.get ();
+  size_t memory = (sizeof (*info)
+		   + info->fdes.capacity () * sizeof (dwarf2_fde)
+		   + info->num_cies * sizeof (dwarf2_cie));
+
+  printf_filtered (_("  Number of FDEs in sorted call frame table: %s\n"),
+		   pulongest (info->fdes.size ()));
+  if (hdr != NULL)
+    {
+      printf_filtered (_("  Number of FDEs in .eh_frame_hdr table: %s, "
+			 "%s decoded\n"),
+		       pulongest (hdr->fde_count),
+		       pulongest (hdr->fdes.size ()));
+      memory += (sizeof (*hdr)
+		 + hdr->fdes.size () * (sizeof (dwarf2_fde)
+					+ sizeof (*hdr->fdes.begin ())
+					+ 2 * sizeof (void *))
+		 + hdr->cies.size () * (sizeof (dwarf2_cie)
+					+ sizeof (*hdr->cies.begin ())
+					+ 2 * sizeof (void *))
+		 + hdr->all_fdes.capacity () * sizeof (dwarf2_fde));
+      if (hdr->broken)
+	printf_filtered (_("  .eh_frame_hdr table broken, number of FDEs "
+			   "read from .eh_frame instead: %s\n"),
+			 pulongest (hdr->all_fdes.size ()));
+    }
+  printf_filtered (_("  Number of cached call frame table rows: %s\n"),
+		   pulongest (info->rows.size ()));
+  for (const auto &entry : info->rows)
+    memory += (sizeof (entry) + 2 * sizeof (void *)
+	       + (entry.second.reg.capacity ()
+		  * sizeof (struct dwarf2_frame_state_reg)));
+  printf_filtered (_("  Time spent reading call frame information: "
+		     "%.6f seconds\n"),
+		   duration<double> (info->build_time
+				     + info->decode_time).count ());
+  printf_filtered (_("  Total memory used for call frame information: %s\n"),
+		   pulongest (memory));
 }
 
 /* Handle 'maintenance show dwarf unwinders'.  */
@@ -2438,5 +3050,7 @@ architecture that doesn't support them will have no effect."),
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
+  selftests::register_test ("dwarf2_frame_exp_is_reg_offset",
+			    selftests::exp_is_reg_offset_test);
 #endif
 }
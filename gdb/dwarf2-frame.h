@@ -241,6 +241,11 @@ extern const struct frame_base *
 
 CORE_ADDR dwarf2_frame_cfa (struct frame_info *this_frame);
 
+/* Print statistics about the call frame information read for OBJFILE,
+   for "maint print statistics".  */
+
+extern void dwarf2_frame_print_statistics (struct objfile *objfile);
+
 /* Find the CFA information for PC.
 
    Return 1 if a register is used for the CFA, or 0 if another
@@ -1194,6 +1194,12 @@ call_site_find_chain (struct gdbarch *gdbarch, CORE_ADDR caller_pc,
 {
   struct call_site_chain *retval = NULL;
 
+  /* Most callers have no call site information at all; don't pay for
+     throwing and catching the error that says so below, which happens
+     for most frames of most backtraces.  */
+  if (!entry_values_debug && find_call_site_for_pc (caller_pc) == NULL)
+    return NULL;
+
   try
     {
       retval = call_site_find_chain_1 (gdbarch, caller_pc, callee_pc);
@@ -29,6 +29,7 @@
 #include "extension.h"
 #include "extension-priv.h"
 #include "observable.h"
+#include "native-printers.h"
 #include "cli/cli-script.h"
 #include "python/python.h"
 #include "guile/guile.h"
@@ -476,7 +477,8 @@ ext_lang_type_printers::~ext_lang_type_printers ()
 
    Extension languages are tried in the order specified by
    extension_languages.  The first one to provide a pretty-printed
-   value "wins".
+   value "wins".  GDB's native printers (see native-printers.h) are
+   tried if none does.
 
    If an error is encountered in a pretty-printer, no further extension
    languages are tried.
@@ -518,6 +520,11 @@ apply_ext_lang_val_pretty_printer (struct type *type,
 	}
     }
 
+  if (apply_native_val_pretty_printer (type, embedded_offset, address,
+				       stream, recurse, val, options,
+				       language))
+    return 1;
+
   return 0;
 }
 
@@ -680,7 +680,8 @@ extern const struct language_defn f_language_defn =
   NULL,
   NULL,
   f_is_string_type_p,
-  "(...)"			/* la_struct_too_deep_ellipsis */
+  "(...)",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 static void *
@@ -46,6 +46,7 @@
 #include "fbsd-tdep.h"
 
 #include <list>
+#include <forward_list>
 
 /* Return the name of a file that can be opened to get the symbols for
    the child process identified by PID.  */
@@ -133,7 +134,7 @@ fbsd_nat_target::find_memory_regions (find_memory_region_ftype func,
 	 Pass MODIFIED as true, we do not know the real modification state.  */
       func (kve->kve_start, size, kve->kve_protection & KVME_PROT_READ,
 	    kve->kve_protection & KVME_PROT_WRITE,
-	    kve->kve_protection & KVME_PROT_EXEC, 1, obfd);
+	    kve->kve_protection & KVME_PROT_EXEC, 1, false, obfd);
     }
   return 0;
 }
@@ -202,7 +203,7 @@ fbsd_nat_target::find_memory_regions (find_memory_region_ftype func,
 
       /* Invoke the callback function to create the corefile segment.
 	 Pass MODIFIED as true, we do not know the real modification state.  */
-      func (start, size, read, write, exec, 1, obfd);
+      func (start, size, read, write, exec, 1, false, obfd);
     }
 
   return 0;
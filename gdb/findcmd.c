@@ -55,11 +55,14 @@ put_bits (bfd_uint64_t data, gdb::byte_vector &buf, int bits, bfd_boolean big_p)
 static gdb::byte_vector
 parse_find_args (const char *args, ULONGEST *max_countp,
 		 CORE_ADDR *start_addrp, ULONGEST *search_space_lenp,
-		 bfd_boolean big_p)
+		 ULONGEST *alignp, bfd_boolean big_p)
 {
   /* Default to using the specified type.  */
   char size = '\0';
   ULONGEST max_count = ~(ULONGEST) 0;
+  bool aligned = false;
+  /* Size of the first value of the pattern, for aligned searches.  */
+  ULONGEST first_value_size = 0;
   /* Buffer to hold the search pattern.  */
   gdb::byte_vector pattern_buf;
   CORE_ADDR start_addr;
@@ -95,6 +98,10 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 	    case 'g':
 	      size = *s++;
 	      break;
+	    case 'a':
+	      aligned = true;
+	      ++s;
+	      break;
 	    default:
 	      error (_("Invalid size granularity."));
 	    }
@@ -190,6 +197,9 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 			      contents + TYPE_LENGTH (t));
 	}
 
+      if (first_value_size == 0)
+	first_value_size = pattern_buf.size ();
+
       if (*s == ',')
 	++s;
       s = skip_spaces (s);
@@ -201,7 +211,15 @@ parse_find_args (const char *args, ULONGEST *max_countp,
   if (search_space_len < pattern_buf.size ())
     error (_("Search space too small to contain pattern."));
 
+  /* Aligned searches only report matches at multiples of the size of
+     the first value.  */
+  if (aligned
+      && (first_value_size & (first_value_size - 1)) != 0)
+    error (_("Invalid alignment: the size of the first value, %s, "
+	     "is not a power of two."), pulongest (first_value_size));
+
   *max_countp = max_count;
+  *alignp = aligned ? first_value_size : 1;
   *start_addrp = start_addr;
   *search_space_lenp = search_space_len;
 
@@ -218,6 +236,7 @@ find_command (const char *args, int from_tty)
   ULONGEST max_count = 0;
   CORE_ADDR start_addr = 0;
   ULONGEST search_space_len = 0;
+  ULONGEST align = 1;
   /* End of command line parameters.  */
   unsigned int found_count;
   CORE_ADDR last_found_addr;
@@ -225,42 +244,27 @@ find_command (const char *args, int from_tty)
   gdb::byte_vector pattern_buf = parse_find_args (args, &max_count,
 						  &start_addr,
 						  &search_space_len,
-						  big_p);
+						  &align, big_p);
 
-  /* Perform the search.  */
+  /* Perform the search.  All the matches are found in a single pass
+     over the search space.  */
 
   found_count = 0;
   last_found_addr = 0;
 
-  while (search_space_len >= pattern_buf.size ()
-	 && found_count < max_count)
-    {
-      /* Offset from start of this iteration to the next iteration.  */
-      ULONGEST next_iter_incr;
-      CORE_ADDR found_addr;
-      int found = target_search_memory (start_addr, search_space_len,
-					pattern_buf.data (),
-					pattern_buf.size (),
-					&found_addr);
-
-      if (found <= 0)
-	break;
-
-      print_address (gdbarch, found_addr, gdb_stdout);
-      printf_filtered ("\n");
-      ++found_count;
-      last_found_addr = found_addr;
-
-      /* Begin next iteration at one byte past this match.  */
-      next_iter_incr = (found_addr - start_addr) + 1;
-
-      /* For robustness, we don't let search_space_len go -ve here.  */
-      if (search_space_len >= next_iter_incr)
-	search_space_len -= next_iter_incr;
-      else
-	search_space_len = 0;
-      start_addr += next_iter_incr;
-    }
+  if (search_space_len >= pattern_buf.size () && max_count > 0)
+    target_search_memory_all (start_addr, search_space_len,
+			      pattern_buf.data (), pattern_buf.size (),
+			      align,
+			      [&] (CORE_ADDR found_addr)
+			      {
+				print_address (gdbarch, found_addr,
+					       gdb_stdout);
+				printf_filtered ("\n");
+				++found_count;
+				last_found_addr = found_addr;
+				return found_count < max_count;
+			      });
 
   /* Record and print the results.  */
 
@@ -286,11 +290,13 @@ _initialize_mem_search (void)
   add_cmd ("find", class_vars, find_command, _("\
 Search memory for a sequence of bytes.\n\
 Usage:\nfind \
-[/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
-find [/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
+[/SIZE-CHAR] [/MAX-COUNT] [/a] START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
+find [/SIZE-CHAR] [/MAX-COUNT] [/a] START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
 SIZE-CHAR is one of b,h,w,g for 8,16,32,64 bit values respectively,\n\
 and if not specified the size is taken from the type of the expression\n\
 in the current language.\n\
+With /a, only matches at addresses that are a multiple of the size of\n\
+the first value are reported.\n\
 Note that this means for example that in the case of C-like languages\n\
 a search for an untyped 0x42 will search for \"(int) 0x42\"\n\
 which is typically four bytes, and a search for a string \"hello\" will\n\
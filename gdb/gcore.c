@@ -35,6 +35,7 @@
 #include "gdb_bfd.h"
 #include "readline/tilde.h"
 #include <algorithm>
+#include <unordered_set>
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scope-exit.h"
@@ -44,6 +45,10 @@
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* The granularity at which runs of zero bytes are left as holes in
+   the core file instead of being written out.  */
+#define SPARSE_BLOCK_BYTES 4096
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
@@ -381,14 +386,29 @@ make_output_phdrs (bfd *obfd, asection *osec, void *ignored)
   bfd_record_phdr (obfd, p_type, 1, p_flags, 0, 0, 0, 0, 1, &osec);
 }
 
-/* find_memory_region_ftype implementation.  DATA is 'bfd *' for the core file
-   GDB is creating.  */
+/* State shared by gcore_create_callback and gcore_copy_callback.  */
+
+struct gcore_memory_data
+{
+  /* The core file GDB is creating.  */
+  bfd *obfd;
+
+  /* Sections for regions that the target reported as holding only
+     zeroes.  They are left as holes in the core file instead of being
+     read from the target.  */
+  std::unordered_set<asection *> zero_sections;
+};
+
+/* find_memory_region_ftype implementation.  DATA is the
+   gcore_memory_data for the core file GDB is creating.  */
 
 static int
 gcore_create_callback (CORE_ADDR vaddr, unsigned long size, int read,
-		       int write, int exec, int modified, void *data)
+		       int write, int exec, int modified, bool zeroed,
+		       void *data)
 {
-  bfd *obfd = (bfd *) data;
+  gcore_memory_data *gdata = (gcore_memory_data *) data;
+  bfd *obfd = gdata->obfd;
   asection *osec;
   flagword flags = SEC_ALLOC | SEC_HAS_CONTENTS | SEC_LOAD;
 
@@ -466,6 +486,10 @@ gcore_create_callback (CORE_ADDR vaddr, unsigned long size, int read,
   bfd_set_section_size (osec, size);
   bfd_set_section_vma (osec, vaddr);
   bfd_set_section_lma (osec, 0);
+
+  if (zeroed)
+    gdata->zero_sections.insert (osec);
+
   return 0;
 }
 
@@ -498,6 +522,7 @@ objfile_find_memory_regions (struct target_ops *self,
 			   (flags & SEC_READONLY) == 0, /* Writable.  */
 			   (flags & SEC_CODE) != 0, /* Executable.  */
 			   1, /* MODIFIED is unknown, pass it as true.  */
+			   false, /* Contents are unknown.  */
 			   obfd);
 	    if (ret != 0)
 	      return ret;
@@ -511,6 +536,7 @@ objfile_find_memory_regions (struct target_ops *self,
 	     1, /* Stack section will be writable.  */
 	     0, /* Stack section will not be executable.  */
 	     1, /* Stack section will be modified.  */
+	     false, /* Contents are unknown.  */
 	     obfd);
 
   /* Make a heap segment.  */
@@ -520,14 +546,74 @@ objfile_find_memory_regions (struct target_ops *self,
 	     1, /* Heap section will be writable.  */
 	     0, /* Heap section will not be executable.  */
 	     1, /* Heap section will be modified.  */
+	     false, /* Contents are unknown.  */
 	     obfd);
 
   return 0;
 }
 
+/* Return true if the LEN bytes at BUF are all zero.  */
+
+static bool
+all_zero_p (const gdb_byte *buf, size_t len)
+{
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* Write the SIZE bytes at BUF to OSEC at OFFSET, skipping the
+   SPARSE_BLOCK_BYTES-sized blocks that are all zero.  The file is
+   always extended to cover the last byte of the section, so that a
+   section ending in zeroes still reads back correctly.  Return false
+   if a write failed.  */
+
+static bool
+gcore_write_sparse (bfd *obfd, asection *osec, const gdb_byte *buf,
+		    file_ptr offset, bfd_size_type size)
+{
+  bfd_size_type pos = 0;
+  bool last_chunk = offset + size == bfd_section_size (osec);
+
+  while (pos < size)
+    {
+      bfd_size_type start = pos;
+
+      /* Skip a run of zero blocks.  */
+      while (pos < size
+	     && all_zero_p (buf + pos,
+			    std::min (size - pos,
+				      (bfd_size_type) SPARSE_BLOCK_BYTES)))
+	pos += std::min (size - pos, (bfd_size_type) SPARSE_BLOCK_BYTES);
+
+      if (pos == size)
+	{
+	  /* Trailing zeroes.  Write the final byte of the section so
+	     that the hole is inside the file.  */
+	  if (last_chunk)
+	    return bfd_set_section_contents (obfd, osec, buf + size - 1,
+					     offset + size - 1, 1);
+	  break;
+	}
+
+      /* Find the end of the following run of non-zero blocks.  */
+      start = pos;
+      while (pos < size
+	     && !all_zero_p (buf + pos,
+			     std::min (size - pos,
+				       (bfd_size_type) SPARSE_BLOCK_BYTES)))
+	pos += std::min (size - pos, (bfd_size_type) SPARSE_BLOCK_BYTES);
+
+      if (!bfd_set_section_contents (obfd, osec, buf + start,
+				     offset + start, pos - start))
+	return false;
+    }
+
+  return true;
+}
+
 static void
-gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
+gcore_copy_callback (bfd *obfd, asection *osec, void *data)
 {
+  gcore_memory_data *gdata = (gcore_memory_data *) data;
   bfd_size_type size, total_size = bfd_section_size (osec);
   file_ptr offset = 0;
 
@@ -539,6 +625,19 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
   if (!startswith (bfd_section_name (osec), "load"))
     return;
 
+  /* Regions known to hold only zeroes need no reading; just make sure
+     the file covers them.  */
+  if (gdata->zero_sections.count (osec) != 0)
+    {
+      const gdb_byte zero = 0;
+
+      if (total_size > 0
+	  && !bfd_set_section_contents (obfd, osec, &zero, total_size - 1, 1))
+	warning (_("Failed to write corefile contents (%s)."),
+		 bfd_errmsg (bfd_get_error ()));
+      return;
+    }
+
   size = std::min (total_size, (bfd_size_type) MAX_COPY_BYTES);
   gdb::byte_vector memhunk (size);
 
@@ -556,8 +655,7 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch (), bfd_section_vma (osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+      if (!gcore_write_sparse (obfd, osec, memhunk.data (), offset, size))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
@@ -572,12 +670,16 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 static int
 gcore_memory_sections (bfd *obfd)
 {
+  gcore_memory_data data;
+
+  data.obfd = obfd;
+
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
       || gdbarch_find_memory_regions (target_gdbarch (),
-				      gcore_create_callback, obfd) != 0)
+				      gcore_create_callback, &data) != 0)
     {
-      if (target_find_memory_regions (gcore_create_callback, obfd) != 0)
+      if (target_find_memory_regions (gcore_create_callback, &data) != 0)
 	return 0;			/* FIXME: error return/msg?  */
     }
 
@@ -585,7 +687,7 @@ gcore_memory_sections (bfd *obfd)
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  bfd_map_over_sections (obfd, gcore_copy_callback, &data);
 
   return 1;
 }
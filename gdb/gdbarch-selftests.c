@@ -89,6 +89,7 @@ register_to_value_test (struct gdbarch *gdbarch)
 
   scoped_restore restore_thread_list
     = make_scoped_restore (&mock_inferior.thread_list, &mock_thread);
+  mock_inferior.ptid_thread_map[mock_ptid] = &mock_thread;
 
   /* Add the mock inferior to the inferior list so that look ups by
      target+ptid can find it.  */
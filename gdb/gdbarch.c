@@ -300,6 +300,7 @@ struct gdbarch
   gdbarch_displaced_step_hw_singlestep_ftype *displaced_step_hw_singlestep;
   gdbarch_displaced_step_fixup_ftype *displaced_step_fixup;
   gdbarch_displaced_step_location_ftype *displaced_step_location;
+  gdbarch_displaced_step_buffer_count_ftype *displaced_step_buffer_count;
   gdbarch_relocate_instruction_ftype *relocate_instruction;
   gdbarch_overlay_update_ftype *overlay_update;
   gdbarch_core_read_description_ftype *core_read_description;
@@ -454,6 +455,7 @@ gdbarch_alloc (const struct gdbarch_info *info,
   gdbarch->displaced_step_hw_singlestep = default_displaced_step_hw_singlestep;
   gdbarch->displaced_step_fixup = NULL;
   gdbarch->displaced_step_location = NULL;
+  gdbarch->displaced_step_buffer_count = default_displaced_step_buffer_count;
   gdbarch->relocate_instruction = NULL;
   gdbarch->has_shared_address_space = default_has_shared_address_space;
   gdbarch->fast_tracepoint_valid_at = default_fast_tracepoint_valid_at;
@@ -666,6 +668,7 @@ verify_gdbarch (struct gdbarch *gdbarch)
   /* Skip verify of displaced_step_fixup, has predicate.  */
   if ((! gdbarch->displaced_step_location) != (! gdbarch->displaced_step_copy_insn))
     log.puts ("\n\tdisplaced_step_location");
+  /* Skip verify of displaced_step_buffer_count, invalid_p == 0 */
   /* Skip verify of relocate_instruction, has predicate.  */
   /* Skip verify of overlay_update, has predicate.  */
   /* Skip verify of core_read_description, has predicate.  */
@@ -918,6 +921,9 @@ gdbarch_dump (struct gdbarch *gdbarch, struct ui_file *file)
   fprintf_unfiltered (file,
                       "gdbarch_dump: disassembler_options_implicit = %s\n",
                       pstring (gdbarch->disassembler_options_implicit));
+  fprintf_unfiltered (file,
+                      "gdbarch_dump: displaced_step_buffer_count = <%s>\n",
+                      host_address_to_string (gdbarch->displaced_step_buffer_count));
   fprintf_unfiltered (file,
                       "gdbarch_dump: gdbarch_displaced_step_copy_insn_p() = %d\n",
                       gdbarch_displaced_step_copy_insn_p (gdbarch));
@@ -4029,6 +4035,23 @@ set_gdbarch_displaced_step_location (struct gdbarch *gdbarch,
   gdbarch->displaced_step_location = displaced_step_location;
 }
 
+int
+gdbarch_displaced_step_buffer_count (struct gdbarch *gdbarch)
+{
+  gdb_assert (gdbarch != NULL);
+  gdb_assert (gdbarch->displaced_step_buffer_count != NULL);
+  if (gdbarch_debug >= 2)
+    fprintf_unfiltered (gdb_stdlog, "gdbarch_displaced_step_buffer_count called\n");
+  return gdbarch->displaced_step_buffer_count (gdbarch);
+}
+
+void
+set_gdbarch_displaced_step_buffer_count (struct gdbarch *gdbarch,
+                                         gdbarch_displaced_step_buffer_count_ftype displaced_step_buffer_count)
+{
+  gdbarch->displaced_step_buffer_count = displaced_step_buffer_count;
+}
+
 int
 gdbarch_relocate_instruction_p (struct gdbarch *gdbarch)
 {
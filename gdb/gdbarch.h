@@ -1084,9 +1084,9 @@ extern void gdbarch_displaced_step_fixup (struct gdbarch *gdbarch, struct displa
 extern void set_gdbarch_displaced_step_fixup (struct gdbarch *gdbarch, gdbarch_displaced_step_fixup_ftype *displaced_step_fixup);
 
 /* Return the address of an appropriate place to put displaced
-   instructions while we step over them.  There need only be one such
-   place, since we're only stepping one thread over a breakpoint at a
-   time.
+   instructions while we step over them.  This is the start of the
+   area holding the displaced stepping buffers, see
+   gdbarch_displaced_step_buffer_count.
   
    For a general explanation of displaced stepping and how GDB uses it,
    see the comments in infrun.c. */
@@ -1095,6 +1095,16 @@ typedef CORE_ADDR (gdbarch_displaced_step_location_ftype) (struct gdbarch *gdbar
 extern CORE_ADDR gdbarch_displaced_step_location (struct gdbarch *gdbarch);
 extern void set_gdbarch_displaced_step_location (struct gdbarch *gdbarch, gdbarch_displaced_step_location_ftype *displaced_step_location);
 
+/* Return how many displaced stepping buffers fit in the area returned
+   by gdbarch_displaced_step_location.  Each buffer is
+   gdbarch_max_insn_length bytes long, and they are laid out one after
+   the other.  Threads of an inferior can step over breakpoints
+   concurrently, each using its own buffer. */
+
+typedef int (gdbarch_displaced_step_buffer_count_ftype) (struct gdbarch *gdbarch);
+extern int gdbarch_displaced_step_buffer_count (struct gdbarch *gdbarch);
+extern void set_gdbarch_displaced_step_buffer_count (struct gdbarch *gdbarch, gdbarch_displaced_step_buffer_count_ftype *displaced_step_buffer_count);
+
 /* Relocate an instruction to execute at a different address.  OLDLOC
    is the address in the inferior memory where the instruction to
    relocate is currently at.  On input, TO points to the destination
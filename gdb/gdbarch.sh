@@ -852,14 +852,21 @@ m;int;displaced_step_hw_singlestep;struct displaced_step_closure *closure;closur
 M;void;displaced_step_fixup;struct displaced_step_closure *closure, CORE_ADDR from, CORE_ADDR to, struct regcache *regs;closure, from, to, regs;;NULL
 
 # Return the address of an appropriate place to put displaced
-# instructions while we step over them.  There need only be one such
-# place, since we're only stepping one thread over a breakpoint at a
-# time.
+# instructions while we step over them.  This is the start of the
+# area holding the displaced stepping buffers, see
+# gdbarch_displaced_step_buffer_count.
 #
 # For a general explanation of displaced stepping and how GDB uses it,
 # see the comments in infrun.c.
 m;CORE_ADDR;displaced_step_location;void;;;NULL;;(! gdbarch->displaced_step_location) != (! gdbarch->displaced_step_copy_insn)
 
+# Return how many displaced stepping buffers fit in the area returned
+# by gdbarch_displaced_step_location.  Each buffer is
+# gdbarch_max_insn_length bytes long, and they are laid out one after
+# the other.  Threads of an inferior can step over breakpoints
+# concurrently, each using its own buffer.
+m;int;displaced_step_buffer_count;void;;;default_displaced_step_buffer_count;;0
+
 # Relocate an instruction to execute at a different address.  OLDLOC
 # is the address in the inferior memory where the instruction to
 # relocate is currently at.  On input, TO points to the destination
@@ -22,9 +22,18 @@
 #include "gdbthread.h"
 #include "dll.h"
 
+#include <unordered_map>
+
 std::list<process_info *> all_processes;
 std::list<thread_info *> all_threads;
 
+/* Index of ALL_THREADS by thread id, so that looking up a thread or
+   removing it from the list does not need to walk the whole list.
+   With many threads, both happen for every thread on every stop.  */
+
+static std::unordered_map<ptid_t, std::list<thread_info *>::iterator,
+			  hash_ptid> thread_ptid_map;
+
 struct thread_info *current_thread;
 
 /* The current working directory used to start the inferior.  */
@@ -40,6 +49,7 @@ add_thread (ptid_t thread_id, void *target_data)
   new_thread->last_status.kind = TARGET_WAITKIND_IGNORE;
 
   all_threads.push_back (new_thread);
+  thread_ptid_map[thread_id] = std::prev (all_threads.end ());
 
   if (current_thread == NULL)
     current_thread = new_thread;
@@ -63,9 +73,11 @@ get_first_thread (void)
 struct thread_info *
 find_thread_ptid (ptid_t ptid)
 {
-  return find_thread ([&] (thread_info *thread) {
-    return thread->id == ptid;
-  });
+  auto it = thread_ptid_map.find (ptid);
+  if (it != thread_ptid_map.end ())
+    return *it->second;
+
+  return NULL;
 }
 
 /* Find a thread associated with the given PROCESS, or NULL if no
@@ -101,7 +113,15 @@ remove_thread (struct thread_info *thread)
     target_disable_btrace (thread->btrace);
 
   discard_queued_stop_replies (ptid_of (thread));
-  all_threads.remove (thread);
+
+  auto it = thread_ptid_map.find (thread->id);
+  if (it != thread_ptid_map.end () && *it->second == thread)
+    {
+      all_threads.erase (it->second);
+      thread_ptid_map.erase (it);
+    }
+  else
+    all_threads.remove (thread);
   free_one_thread (thread);
   if (current_thread == thread)
     current_thread = NULL;
@@ -130,6 +150,7 @@ clear_inferiors (void)
 {
   for_each_thread (free_one_thread);
   all_threads.clear ();
+  thread_ptid_map.clear ();
 
   clear_dlls ();
 
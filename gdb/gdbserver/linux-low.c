@@ -1811,7 +1811,18 @@ status_pending_p_callback (thread_info *thread, ptid_t ptid)
 struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
-  thread_info *thread = find_thread ([&] (thread_info *thr_arg)
+  thread_info *thread;
+
+  /* Threads are keyed by (PID, LWP), so a full ptid can be looked up
+     directly.  */
+  if (ptid.lwp () != 0)
+    {
+      thread = find_thread_ptid (ptid_t (ptid.pid (), ptid.lwp (), 0));
+      if (thread != NULL)
+	return get_thread_lwp (thread);
+    }
+
+  thread = find_thread ([&] (thread_info *thr_arg)
     {
       int lwp = ptid.lwp () != 0 ? ptid.lwp () : ptid.pid ();
       return thr_arg->id.lwp () == lwp;
@@ -5291,9 +5302,13 @@ disable_regset (struct regsets_info *info, struct regset_info *regset)
   info->disabled_regsets[dr_offset] = 1;
 }
 
+/* Fetch the general-purpose regsets if GENERAL is non-zero, or all the
+   other regsets otherwise.  Returns 0 if the general-purpose registers
+   were fetched, 1 otherwise.  */
+
 static int
 regsets_fetch_inferior_registers (struct regsets_info *regsets_info,
-				  struct regcache *regcache)
+				  struct regcache *regcache, int general)
 {
   struct regset_info *regset;
   int saw_general_regs = 0;
@@ -5306,7 +5321,8 @@ regsets_fetch_inferior_registers (struct regsets_info *regsets_info,
       void *buf, *data;
       int nt_type, res;
 
-      if (regset->size == 0 || regset_disabled (regsets_info, regset))
+      if (regset->size == 0 || regset_disabled (regsets_info, regset)
+	  || (regset->type == GENERAL_REGS) != (general != 0))
 	continue;
 
       buf = xmalloc (regset->size);
@@ -5370,9 +5386,14 @@ regsets_fetch_inferior_registers (struct regsets_info *regsets_info,
     return 1;
 }
 
+/* Store the regsets back into the inferior.  The regsets other than
+   the general-purpose ones are only stored if OTHERS is non-zero,
+   i.e., if they were fetched at all.  Returns 0 if the general-purpose
+   registers were stored, 1 otherwise.  */
+
 static int
 regsets_store_inferior_registers (struct regsets_info *regsets_info,
-				  struct regcache *regcache)
+				  struct regcache *regcache, int others)
 {
   struct regset_info *regset;
   int saw_general_regs = 0;
@@ -5386,7 +5407,8 @@ regsets_store_inferior_registers (struct regsets_info *regsets_info,
       int nt_type, res;
 
       if (regset->size == 0 || regset_disabled (regsets_info, regset)
-	  || regset->fill_function == NULL)
+	  || regset->fill_function == NULL
+	  || (regset->type != GENERAL_REGS && !others))
 	continue;
 
       buf = xmalloc (regset->size);
@@ -5462,8 +5484,8 @@ regsets_store_inferior_registers (struct regsets_info *regsets_info,
 #else /* !HAVE_LINUX_REGSETS */
 
 #define use_linux_regsets 0
-#define regsets_fetch_inferior_registers(regsets_info, regcache) 1
-#define regsets_store_inferior_registers(regsets_info, regcache) 1
+#define regsets_fetch_inferior_registers(regsets_info, regcache, general) 1
+#define regsets_store_inferior_registers(regsets_info, regcache, others) 1
 
 #endif
 
@@ -5649,9 +5671,15 @@ usr_store_inferior_registers (const struct regs_info *regs_info,
 #endif
 
 
+/* Fetch registers from the child process.  If REGNO is -1, the
+   thread's regcache is being filled: fetch only the general-purpose
+   registers, and leave the rest to be fetched on first access, which
+   is a call with REGNO set to one of them.  */
+
 static void
 linux_fetch_registers (struct regcache *regcache, int regno)
 {
+  struct lwp_info *lwp = get_thread_lwp (current_thread);
   int use_regsets;
   int all = 0;
   const struct regs_info *regs_info = (*the_low_target.regs_info) ();
@@ -5663,7 +5691,15 @@ linux_fetch_registers (struct regcache *regcache, int regno)
 	for (regno = 0; regno < regs_info->usrregs->num_regs; regno++)
 	  (*the_low_target.fetch_register) (regcache, regno);
 
-      all = regsets_fetch_inferior_registers (regs_info->regsets_info, regcache);
+      all = regsets_fetch_inferior_registers (regs_info->regsets_info,
+					      regcache, 1);
+
+      /* Without a general-purpose regset there's nothing to gain by
+	 deferring the rest.  */
+      lwp->other_regsets_fetched = all;
+      if (all)
+	regsets_fetch_inferior_registers (regs_info->regsets_info,
+					  regcache, 0);
       if (regs_info->usrregs != NULL)
 	usr_fetch_inferior_registers (regs_info, regcache, -1, all);
     }
@@ -5673,11 +5709,17 @@ linux_fetch_registers (struct regcache *regcache, int regno)
 	  && (*the_low_target.fetch_register) (regcache, regno))
 	return;
 
+      /* Don't fetch the general-purpose regsets again, that would
+	 clobber modified registers.  */
       use_regsets = linux_register_in_regsets (regs_info, regno);
-      if (use_regsets)
-	all = regsets_fetch_inferior_registers (regs_info->regsets_info,
-						regcache);
-      if ((!use_regsets || all) && regs_info->usrregs != NULL)
+      if (use_regsets && !lwp->other_regsets_fetched)
+	{
+	  regsets_fetch_inferior_registers (regs_info->regsets_info,
+					    regcache, 0);
+	  lwp->other_regsets_fetched = 1;
+	}
+      if (regcache->get_register_status (regno) == REG_UNKNOWN
+	  && regs_info->usrregs != NULL)
 	usr_fetch_inferior_registers (regs_info, regcache, regno, 1);
     }
 }
@@ -5685,6 +5727,7 @@ linux_fetch_registers (struct regcache *regcache, int regno)
 static void
 linux_store_registers (struct regcache *regcache, int regno)
 {
+  struct lwp_info *lwp = get_thread_lwp (current_thread);
   int use_regsets;
   int all = 0;
   const struct regs_info *regs_info = (*the_low_target.regs_info) ();
@@ -5692,7 +5735,8 @@ linux_store_registers (struct regcache *regcache, int regno)
   if (regno == -1)
     {
       all = regsets_store_inferior_registers (regs_info->regsets_info,
-					      regcache);
+					      regcache,
+					      lwp->other_regsets_fetched);
       if (regs_info->usrregs != NULL)
 	usr_store_inferior_registers (regs_info, regcache, regno, all);
     }
@@ -5701,7 +5745,8 @@ linux_store_registers (struct regcache *regcache, int regno)
       use_regsets = linux_register_in_regsets (regs_info, regno);
       if (use_regsets)
 	all = regsets_store_inferior_registers (regs_info->regsets_info,
-						regcache);
+						regcache,
+						lwp->other_regsets_fetched);
       if ((!use_regsets || all) && regs_info->usrregs != NULL)
 	usr_store_inferior_registers (regs_info, regcache, regno, 1);
     }
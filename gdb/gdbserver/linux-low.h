@@ -308,6 +308,13 @@ struct lwp_info
   /* When stopped is set, the last wait status recorded for this lwp.  */
   int last_status;
 
+  /* Whether the regsets other than the general-purpose ones were
+     fetched into the thread's regcache since it last stopped.  Only
+     the general-purpose registers are fetched when the regcache is
+     first filled; the rest, which may include large vector state,
+     are fetched the first time one of them is accessed.  */
+  int other_regsets_fetched;
+
   /* If WAITSTATUS->KIND != TARGET_WAITKIND_IGNORE, the waitstatus for
      this LWP's last event, to pass to GDB without any further
      processing.  This is used to store extended ptrace event
@@ -531,6 +531,7 @@ struct x86_dr_low_type x86_dr_low =
     x86_linux_dr_get_status,
     x86_linux_dr_get_control,
     sizeof (void *),
+    0,
   };
 
 /* Breakpoint/Watchpoint support.  */
@@ -44,6 +44,7 @@ get_thread_regcache (struct thread_info *thread, int fetch)
       gdb_assert (proc->tdesc != NULL);
 
       regcache = new_register_cache (proc->tdesc);
+      regcache->thread = thread;
       set_thread_regcache_data (thread, regcache);
     }
 
@@ -52,17 +53,53 @@ get_thread_regcache (struct thread_info *thread, int fetch)
       struct thread_info *saved_thread = current_thread;
 
       current_thread = thread;
-      /* Invalidate all registers, to prevent stale left-overs.  */
-      memset (regcache->register_status, REG_UNAVAILABLE,
+      /* Invalidate all registers, to prevent stale left-overs.  The
+	 target may leave some of them unknown, to be fetched on first
+	 access.  */
+      memset (regcache->register_status, REG_UNKNOWN,
 	      regcache->tdesc->reg_defs.size ());
+      regcache->fetching = 1;
       fetch_inferior_registers (regcache, -1);
+      regcache->fetching = 0;
       current_thread = saved_thread;
       regcache->registers_valid = 1;
+      regcache->registers_dirty = 0;
     }
 
   return regcache;
 }
 
+/* Fetch register N of REGCACHE, which the target left unknown when
+   the thread's registers were fetched.  */
+
+static void
+fetch_unknown_register (struct regcache *regcache, int n)
+{
+  struct thread_info *saved_thread = current_thread;
+
+  gdb_assert (regcache->thread != NULL);
+
+  current_thread = regcache->thread;
+  regcache->fetching = 1;
+  fetch_inferior_registers (regcache, n);
+  regcache->fetching = 0;
+  current_thread = saved_thread;
+
+  /* If the target couldn't supply it either, don't try again.  */
+  if (regcache->register_status[n] == REG_UNKNOWN)
+    regcache->register_status[n] = REG_UNAVAILABLE;
+}
+
+/* Fetch all the registers of REGCACHE that are still unknown.  */
+
+static void
+fetch_unknown_registers (struct regcache *regcache)
+{
+  for (int i = 0; i < regcache->tdesc->reg_defs.size (); ++i)
+    if (regcache->register_status[i] == REG_UNKNOWN)
+      fetch_unknown_register (regcache, i);
+}
+
 /* See gdbsupport/common-regcache.h.  */
 
 struct regcache *
@@ -81,7 +118,7 @@ regcache_invalidate_thread (struct thread_info *thread)
   if (regcache == NULL)
     return;
 
-  if (regcache->registers_valid)
+  if (regcache->registers_valid && regcache->registers_dirty)
     {
       struct thread_info *saved_thread = current_thread;
 
@@ -91,6 +128,7 @@ regcache_invalidate_thread (struct thread_info *thread)
     }
 
   regcache->registers_valid = 0;
+  regcache->registers_dirty = 0;
 }
 
 /* See regcache.h.  */
@@ -187,6 +225,10 @@ regcache_cpy (struct regcache *dst, struct regcache *src)
   gdb_assert (src->tdesc == dst->tdesc);
   gdb_assert (src != dst);
 
+#ifndef IN_PROCESS_AGENT
+  if (src->register_status != NULL)
+    fetch_unknown_registers (src);
+#endif
   memcpy (dst->registers, src->registers, src->tdesc->registers_size);
 #ifndef IN_PROCESS_AGENT
   if (dst->register_status != NULL && src->register_status != NULL)
@@ -212,6 +254,8 @@ registers_to_string (struct regcache *regcache, char *buf)
   unsigned char *registers = regcache->registers;
   const struct target_desc *tdesc = regcache->tdesc;
 
+  fetch_unknown_registers (regcache);
+
   for (int i = 0; i < tdesc->reg_defs.size (); ++i)
     {
       if (regcache->register_status[i] == REG_VALID)
@@ -243,7 +287,12 @@ registers_from_string (struct regcache *regcache, char *buf)
       if (len > tdesc->registers_size * 2)
 	len = tdesc->registers_size * 2;
     }
+
+  /* A short packet leaves the tail of the registers alone, so those
+     must be known before they are written back.  */
+  fetch_unknown_registers (regcache);
   hex2bin (buf, registers, len / 2);
+  regcache->registers_dirty = 1;
 }
 
 int
@@ -302,6 +351,16 @@ regcache_register_size (const struct regcache *regcache, int n)
 static unsigned char *
 register_data (const struct regcache *regcache, int n, int fetch)
 {
+#ifndef IN_PROCESS_AGENT
+  /* Fetching a register the target left unknown doesn't change its
+     value as far as the regcache's users can tell.  */
+  if (fetch
+      && regcache->register_status != NULL
+      && regcache->register_status[n] == REG_UNKNOWN
+      && !regcache->fetching)
+    fetch_unknown_register (const_cast<struct regcache *> (regcache), n);
+#endif
+
   return (regcache->registers
 	  + find_register_by_number (regcache->tdesc, n).offset / 8);
 }
@@ -317,6 +376,17 @@ supply_register (struct regcache *regcache, int n, const void *buf)
 void
 regcache::raw_supply (int n, const void *buf)
 {
+#ifndef IN_PROCESS_AGENT
+  if (register_status != NULL && !fetching)
+    {
+      /* The target writes back whole register sets, so the rest of
+	 this register's set must be known before it's modified.  */
+      if (register_status[n] == REG_UNKNOWN)
+	fetch_unknown_register (this, n);
+      registers_dirty = 1;
+    }
+#endif
+
   if (buf)
     {
       memcpy (register_data (this, n, 0), buf, register_size (tdesc, n));
@@ -340,6 +410,14 @@ regcache::raw_supply (int n, const void *buf)
 void
 supply_register_zeroed (struct regcache *regcache, int n)
 {
+#ifndef IN_PROCESS_AGENT
+  if (regcache->register_status != NULL && !regcache->fetching)
+    {
+      if (regcache->register_status[n] == REG_UNKNOWN)
+	fetch_unknown_register (regcache, n);
+      regcache->registers_dirty = 1;
+    }
+#endif
   memset (register_data (regcache, n, 0), 0,
 	  register_size (regcache->tdesc, n));
 #ifndef IN_PROCESS_AGENT
@@ -379,6 +457,8 @@ supply_regblock (struct regcache *regcache, const void *buf)
 
 	for (i = 0; i < tdesc->reg_defs.size (); i++)
 	  regcache->register_status[i] = REG_VALID;
+	if (!regcache->fetching)
+	  regcache->registers_dirty = 1;
       }
 #endif
     }
@@ -507,6 +587,8 @@ regcache::get_register_status (int regnum) const
 {
 #ifndef IN_PROCESS_AGENT
   gdb_assert (regnum >= 0 && regnum < tdesc->reg_defs.size ());
+  if (register_status[regnum] == REG_UNKNOWN && !fetching)
+    fetch_unknown_register (const_cast<struct regcache *> (this), regnum);
   return (enum register_status) (register_status[regnum]);
 #else
   return REG_VALID;
@@ -42,8 +42,26 @@ struct regcache : public reg_buffer_common
   int registers_owned = 0;
   unsigned char *registers = nullptr;
 #ifndef IN_PROCESS_AGENT
-  /* One of REG_UNAVAILBLE or REG_VALID.  */
+  /* One of REG_UNAVAILBLE, REG_VALID or REG_UNKNOWN.  REG_UNKNOWN is
+     only used by thread regcaches, for registers the target left out
+     when the registers were fetched at stop time, usually because
+     they live in a large regset (e.g., vector state) that is costly
+     to fetch.  Such registers are fetched the first time they are
+     accessed.  */
   unsigned char *register_status = nullptr;
+
+  /* The thread whose registers this is, or NULL if this regcache
+     isn't a thread's regcache.  */
+  struct thread_info *thread = nullptr;
+
+  /* Whether the target is currently supplying registers into this
+     regcache, as opposed to someone modifying them.  */
+  int fetching = 0;
+
+  /* Whether any register was modified since the registers were
+     fetched.  Only dirty regcaches are written back to the target
+     when invalidated.  */
+  int registers_dirty = 0;
 #endif
 
   /* See gdbsupport/common-regcache.h.  */
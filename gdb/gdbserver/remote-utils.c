@@ -26,6 +26,7 @@
 #include "debug.h"
 #include "dll.h"
 #include "gdbsupport/rsp-low.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/netstuff.h"
 #include "gdbsupport/filestuff.h"
 #include <ctype.h>
@@ -71,6 +72,10 @@
 #include <sys/iomgr.h>
 #endif /* __QNX__ */
 
+#if defined (HAVE_LIBZ) && defined (HAVE_ZLIB_H)
+#include <zlib.h>
+#endif
+
 #ifndef HAVE_SOCKLEN_T
 typedef int socklen_t;
 #endif
@@ -1103,6 +1108,110 @@ write_enn (char *buf)
 
 #ifndef IN_PROCESS_AGENT
 
+/* The names of the compressed reply kinds, as used in the
+   QCompressReplies packet, and the request prefix each applies to.  */
+
+static const struct
+{
+  const char *name;
+  const char *request;
+  int kind;
+} compressed_reply_kinds[] =
+{
+  { "m", "m", COMPRESSED_REPLY_m },
+  { "vFile:pread", "vFile:pread:", COMPRESSED_REPLY_vFile_pread },
+  { "qXfer", "qXfer:", COMPRESSED_REPLY_qXfer },
+};
+
+/* See remote-utils.h.  */
+
+int
+parse_compressed_reply_kinds (const char *list)
+{
+  int kinds = 0;
+
+  while (*list != '\0')
+    {
+      const char *end = strchrnul (list, ';');
+
+      for (const auto &k : compressed_reply_kinds)
+	if (strlen (k.name) == (size_t) (end - list)
+	    && strncmp (k.name, list, end - list) == 0)
+	  kinds |= k.kind;
+
+      list = *end == ';' ? end + 1 : end;
+    }
+
+  return kinds;
+}
+
+/* See remote-utils.h.  */
+
+int
+compressed_reply_kind (const char *request)
+{
+  for (const auto &k : compressed_reply_kinds)
+    if (startswith (request, k.request))
+      return k.kind;
+
+  return 0;
+}
+
+/* Replies shorter than this are never compressed, zlib's overhead
+   would eat any gain.  */
+#define COMPRESS_REPLY_MIN 64
+
+/* See remote-utils.h.  */
+
+int
+compress_reply (char *buf, int len)
+{
+#if defined (HAVE_LIBZ) && defined (HAVE_ZLIB_H)
+  if (len < COMPRESS_REPLY_MIN)
+    return len;
+
+  uLongf zlen = compressBound (len);
+  gdb::byte_vector zbuf (zlen);
+
+  if (compress2 (zbuf.data (), &zlen, (const Bytef *) buf, len,
+		 Z_BEST_SPEED) != Z_OK)
+    return len;
+
+  /* The compressed reply is "Z<length>;<escaped data>".  Only use it
+     if it ends up smaller than the original.  */
+  char header[16];
+  int header_len = xsnprintf (header, sizeof (header), "Z%x;", len);
+
+  if (header_len >= len)
+    return len;
+
+  gdb::byte_vector out (len - header_len);
+  int used;
+  int out_len = remote_escape_output (zbuf.data (), zlen, 1, out.data (),
+				      &used, out.size ());
+
+  if (used != (int) zlen)
+    return len;
+
+  if (remote_debug)
+    {
+      debug_printf ("compressed reply: %d -> %d bytes\n", len,
+		    header_len + out_len);
+      debug_flush ();
+    }
+
+  memcpy (buf, header, header_len);
+  memcpy (buf + header_len, out.data (), out_len);
+  return header_len + out_len;
+#else
+  return len;
+#endif
+}
+
+#endif
+
+#ifndef IN_PROCESS_AGENT
+
 static char *
 outreg (struct regcache *regcache, int regno, char *buf)
 {
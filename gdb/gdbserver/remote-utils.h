@@ -36,6 +36,34 @@ void remote_open (const char *name);
 void remote_close (void);
 void write_ok (char *buf);
 void write_enn (char *buf);
+
+/* Kinds of replies the server may compress, as requested by GDB with
+   the QCompressReplies packet.  */
+
+enum compressed_reply_kind
+{
+  /* Replies to "m" memory reads.  */
+  COMPRESSED_REPLY_m = 1 << 0,
+
+  /* Replies to "vFile:pread" file reads.  */
+  COMPRESSED_REPLY_vFile_pread = 1 << 1,
+
+  /* Replies to "qXfer" object reads.  */
+  COMPRESSED_REPLY_qXfer = 1 << 2,
+};
+
+/* Parse LIST, the ';'-separated list of reply kinds of a
+   QCompressReplies packet, into a mask of compressed_reply_kind.
+   Unknown kinds are ignored.  */
+int parse_compressed_reply_kinds (const char *list);
+
+/* Return the compressed_reply_kind the reply to REQUEST would be, or
+   0 if that reply is never compressed.  */
+int compressed_reply_kind (const char *request);
+
+/* Compress the LEN bytes reply in BUF in place, if that makes it
+   smaller.  Return the new length of the reply.  */
+int compress_reply (char *buf, int len);
 void initialize_async_io (void);
 void enable_async_io (void);
 void disable_async_io (void);
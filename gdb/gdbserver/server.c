@@ -719,6 +719,25 @@ handle_general_set (char *own_buf)
       return;
     }
 
+#if defined (HAVE_LIBZ) && defined (HAVE_ZLIB_H)
+  if (startswith (own_buf, "QCompressReplies:"))
+    {
+      cs.compressed_replies
+	= parse_compressed_reply_kinds (own_buf
+					+ strlen ("QCompressReplies:"));
+
+      if (remote_debug)
+	{
+	  debug_printf ("[compressed replies: 0x%x]\n",
+			cs.compressed_replies);
+	  debug_flush ();
+	}
+
+      write_ok (own_buf);
+      return;
+    }
+#endif
+
   if (startswith (own_buf, "QNonStop:"))
     {
       char *mode = own_buf + 9;
@@ -1124,7 +1143,7 @@ handle_search_memory (char *own_buf, int packet_len)
   gdb_byte *pattern;
   unsigned int pattern_len;
   /* NOTE: also defined in find.c testcase.  */
-#define SEARCH_CHUNK_SIZE 16000
+#define SEARCH_CHUNK_SIZE (256 * 1024)
   const unsigned chunk_size = SEARCH_CHUNK_SIZE;
   /* Buffer to hold memory contents for searching.  */
   gdb_byte *search_buf;
@@ -2458,6 +2477,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      sprintf (own_buf + strlen (own_buf), ";PipelineWindow=%x",
+	       PIPELINE_WINDOW);
+
+#if defined (HAVE_LIBZ) && defined (HAVE_ZLIB_H)
+      strcat (own_buf, ";QCompressReplies+");
+#endif
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -3823,6 +3849,7 @@ captured_main (int argc, char *argv[])
   while (1)
     {
       cs.noack_mode = 0;
+      cs.compressed_replies = 0;
       cs.multi_process = 0;
       cs.report_fork_events = 0;
       cs.report_vfork_events = 0;
@@ -4022,6 +4049,11 @@ process_serial_event (void)
     }
   response_needed = true;
 
+  /* Whether GDB asked for the reply to this request to be
+     compressed.  */
+  bool compress = (compressed_reply_kind (cs.own_buf)
+		   & cs.compressed_replies) != 0;
+
   char ch = cs.own_buf[0];
   switch (ch)
     {
@@ -4345,6 +4377,13 @@ process_serial_event (void)
       break;
     }
 
+  if (compress)
+    {
+      if (new_packet_len == -1)
+	new_packet_len = strlen (cs.own_buf);
+      new_packet_len = compress_reply (cs.own_buf, new_packet_len);
+    }
+
   if (new_packet_len != -1)
     putpkt_binary (cs.own_buf, new_packet_len);
   else
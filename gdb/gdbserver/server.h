@@ -115,6 +115,13 @@ extern int in_queued_stop_replies (ptid_t ptid);
    as large as the largest register set supported by gdbserver.  */
 #define PBUFSIZ 18432
 
+/* Number of requests GDB may send without waiting for the replies,
+   reported in the "PipelineWindow" qSupported feature.  Requests are
+   read from the connection and handled one at a time, in the order
+   they were sent, so this only bounds how much unread data may pile
+   up in the connection's buffers.  */
+#define PIPELINE_WINDOW 16
+
 /* Definition for an unknown syscall, used basically in error-cases.  */
 #define UNKNOWN_SYSCALL (-1)
 
@@ -190,6 +197,9 @@ struct client_state
 
   /* If true, then GDB has requested noack mode.  */
   int noack_mode = 0;
+  /* The mask of compressed_reply_kind GDB asked us to compress, with
+     the QCompressReplies packet.  */
+  int compressed_replies = 0;
   /* If true, then we tell GDB to use noack mode by default.  */
   int transport_is_reliable = 0;
 
@@ -130,7 +130,10 @@ struct target_ops
 
   /* Fetch registers from the inferior process.
 
-     If REGNO is -1, fetch all registers; otherwise, fetch at least REGNO.  */
+     If REGNO is -1, fetch all registers; otherwise, fetch at least REGNO.
+     When REGNO is -1, the target may leave registers that are costly
+     to fetch with REG_UNKNOWN status; the regcache then asks for each
+     of them individually when first accessed.  */
 
   void (*fetch_registers) (struct regcache *regcache, int regno);
 
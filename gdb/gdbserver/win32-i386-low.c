@@ -129,6 +129,7 @@ struct x86_dr_low_type x86_dr_low =
     x86_dr_low_get_status,
     x86_dr_low_get_control,
     sizeof (void *),
+    0,
   };
 
 /* Breakpoint/watchpoint support.  */
@@ -35,4 +35,7 @@ x86_low_init_dregs (struct x86_debug_reg_state *state)
     }
   state->dr_control_mirror = 0;
   state->dr_status_mirror  = 0;
+
+  for (i = 0; i < X86_DR_MAX_REGIONS; i++)
+    state->regions[i].ref_count = 0;
 }
@@ -20,6 +20,8 @@
 #ifndef COMMON_PTID_H
 #define COMMON_PTID_H
 
+#include <functional>
+
 /* The ptid struct is a collection of the various "ids" necessary for
    identifying the inferior process/thread being debugged.  This
    consists of the process id (pid), lightweight process id (lwp) and
@@ -152,4 +154,19 @@ extern const ptid_t null_ptid;
 
 extern const ptid_t minus_one_ptid;
 
+/* Functor to hash a ptid, for use as the hash of unordered
+   containers keyed by ptid.  */
+
+struct hash_ptid
+{
+  size_t operator() (const ptid_t &ptid) const
+  {
+    std::hash<long> long_hash;
+
+    return (long_hash (ptid.pid ())
+	    + long_hash (ptid.lwp ())
+	    + long_hash (ptid.tid ()));
+  }
+};
+
 #endif /* COMMON_PTID_H */
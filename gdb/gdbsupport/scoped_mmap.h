@@ -42,17 +42,29 @@ public:
     destroy ();
   }
 
-  scoped_mmap (scoped_mmap &&rhs)
+  scoped_mmap (scoped_mmap &&rhs) noexcept
+    : m_mem (rhs.m_mem), m_length (rhs.m_length)
   {
-    destroy ();
-
-    m_mem = rhs.m_mem;
-    m_length = rhs.m_length;
-
     rhs.m_mem = MAP_FAILED;
     rhs.m_length = 0;
   }
 
+  scoped_mmap &operator= (scoped_mmap &&rhs) noexcept
+  {
+    if (this != &rhs)
+      {
+	destroy ();
+
+	m_mem = rhs.m_mem;
+	m_length = rhs.m_length;
+
+	rhs.m_mem = MAP_FAILED;
+	rhs.m_length = 0;
+      }
+
+    return *this;
+  }
+
   DISABLE_COPY_AND_ASSIGN (scoped_mmap);
 
   ATTRIBUTE_UNUSED_RESULT void *release () noexcept
@@ -1065,6 +1065,8 @@ i386_linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
   set_gdbarch_displaced_step_fixup (gdbarch, i386_displaced_step_fixup);
   set_gdbarch_displaced_step_location (gdbarch,
                                        linux_displaced_step_location);
+  set_gdbarch_displaced_step_buffer_count
+    (gdbarch, linux_displaced_step_buffer_count);
 
   /* Functions for 'catch syscall'.  */
   set_xml_syscall_file_name (gdbarch, XML_SYSCALL_FILENAME_I386);
@@ -56,6 +56,8 @@ struct thread_info;
 #include "gdbsupport/common-inferior.h"
 #include "gdbthread.h"
 
+#include <unordered_map>
+
 struct infcall_suspend_state;
 struct infcall_control_state;
 
@@ -347,6 +349,18 @@ public:
   /* This inferior's thread list.  */
   thread_info *thread_list = nullptr;
 
+  /* The last thread of THREAD_LIST, so that new threads can be
+     appended without walking the list.  */
+  thread_info *thread_list_tail = nullptr;
+
+  /* Map of the ptids of the threads in THREAD_LIST to the threads
+     themselves, so that find_thread_ptid doesn't need to walk the
+     list, which matters for inferiors with thousands of threads.  If
+     several threads in the list share a ptid (an exited thread that
+     could not be deleted yet, and the new thread that reused its
+     id), the most recently added one is recorded.  */
+  std::unordered_map<ptid_t, thread_info *, hash_ptid> ptid_thread_map;
+
   /* Returns a range adapter covering the inferior's threads,
      including exited threads.  Used like this:
 
@@ -69,6 +69,8 @@
 #include "arch-utils.h"
 #include "gdbsupport/scope-exit.h"
 #include "gdbsupport/forward-scope-exit.h"
+#include <chrono>
+#include <unordered_set>
 
 /* Prototypes for local functions */
 
@@ -1460,14 +1462,15 @@ step_over_info_valid_p (void)
 
    In non-stop mode, we can have independent and simultaneous step
    requests, so more than one thread may need to simultaneously step
-   over a breakpoint.  The current implementation assumes there is
-   only one scratch space per process.  In this case, we have to
-   serialize access to the scratch space.  If thread A wants to step
-   over a breakpoint, but we are currently waiting for some other
-   thread to complete a displaced step, we leave thread A stopped and
-   place it in the displaced_step_request_queue.  Whenever a displaced
-   step finishes, we pick the next thread in the queue and start a new
-   displaced step operation on it.  See displaced_step_prepare and
+   over a breakpoint.  Each process has a pool of scratch spaces
+   ("buffers"), as many as gdbarch_displaced_step_buffer_count says
+   fit at gdbarch_displaced_step_location, and each displaced step
+   uses one of them until it finishes.  If thread A wants to step over
+   a breakpoint, but all buffers are in use by other threads'
+   displaced steps, we leave thread A stopped and place it in the
+   step-over queue.  Whenever a displaced step finishes, we pick the
+   next thread in the queue and start a new displaced step operation
+   on it, in the buffer just freed.  See displaced_step_prepare and
    displaced_step_fixup for details.  */
 
 /* Default destructor for displaced_step_closure.  */
@@ -1490,7 +1493,7 @@ displaced_step_in_progress_any_inferior ()
 {
   for (inferior *i : all_inferiors ())
     {
-      if (i->displaced_step_state.step_thread != nullptr)
+      if (i->displaced_step_state.in_progress ())
 	return true;
     }
 
@@ -1505,7 +1508,8 @@ displaced_step_in_progress_thread (thread_info *thread)
 {
   gdb_assert (thread != NULL);
 
-  return get_displaced_stepping_state (thread->inf)->step_thread == thread;
+  return (get_displaced_stepping_state (thread->inf)->thread_buffer (thread)
+	  != nullptr);
 }
 
 /* Return true if process PID has a thread doing a displaced step.  */
@@ -1513,7 +1517,7 @@ displaced_step_in_progress_thread (thread_info *thread)
 static int
 displaced_step_in_progress (inferior *inf)
 {
-  return get_displaced_stepping_state (inf)->step_thread != nullptr;
+  return get_displaced_stepping_state (inf)->in_progress ();
 }
 
 /* If inferior is in displaced stepping, and ADDR equals to starting address
@@ -1527,9 +1531,10 @@ get_displaced_step_closure_by_addr (CORE_ADDR addr)
     = get_displaced_stepping_state (current_inferior ());
 
   /* If checking the mode of displaced instruction in copy area.  */
-  if (displaced->step_thread != nullptr
-      && displaced->step_copy == addr)
-    return displaced->step_closure;
+  for (const displaced_step_buffer &buffer : displaced->buffers)
+    if (buffer.step_thread != nullptr
+	&& buffer.step_copy == addr)
+      return buffer.step_closure;
 
   return NULL;
 }
@@ -1585,15 +1590,16 @@ use_displaced_stepping (struct thread_info *tp)
 	  && !displaced_state->failed_before);
 }
 
-/* Clean out any stray displaced stepping state.  */
+/* Clean out any stray displaced stepping state of BUFFER, making it
+   available for another displaced step.  */
 static void
-displaced_step_clear (struct displaced_step_inferior_state *displaced)
+displaced_step_clear (struct displaced_step_buffer *buffer)
 {
   /* Indicate that there is no cleanup pending.  */
-  displaced->step_thread = nullptr;
+  buffer->step_thread = nullptr;
 
-  delete displaced->step_closure;
-  displaced->step_closure = NULL;
+  delete buffer->step_closure;
+  buffer->step_closure = NULL;
 }
 
 /* A cleanup that wraps displaced_step_clear.  */
@@ -1638,7 +1644,7 @@ displaced_step_prepare_throw (thread_info *tp)
   CORE_ADDR original, copy;
   ULONGEST len;
   struct displaced_step_closure *closure;
-  int status;
+  int status, index;
 
   /* We should never reach this function if the architecture does not
      support displaced stepping.  */
@@ -1653,16 +1659,17 @@ displaced_step_prepare_throw (thread_info *tp)
      jump/branch).  */
   tp->control.may_range_step = 0;
 
-  /* We have to displaced step one thread at a time, as we only have
-     access to a single scratch space per inferior.  */
+  /* Each displaced step needs a scratch space of its own; we can
+     only step as many threads of an inferior at a time as there are
+     buffers.  */
 
   displaced_step_inferior_state *displaced
     = get_displaced_stepping_state (tp->inf);
 
-  if (displaced->step_thread != nullptr)
+  if (!displaced->has_free_buffer ())
     {
-      /* Already waiting for a displaced step to finish.  Defer this
-	 request and place in queue.  */
+      /* Already waiting for displaced steps to finish in all buffers.
+	 Defer this request and place in queue.  */
 
       if (debug_displaced)
 	fprintf_unfiltered (gdb_stdlog,
@@ -1680,16 +1687,26 @@ displaced_step_prepare_throw (thread_info *tp)
 			    target_pid_to_str (tp->ptid).c_str ());
     }
 
-  displaced_step_clear (displaced);
-
   scoped_restore_current_thread restore_thread;
 
   switch_to_thread (tp);
 
+  /* Lay out the buffers while none is in use.  How many fit may
+     change from run to run, e.g. if the program is rebuilt.  */
+  if (!displaced->in_progress ())
+    displaced->buffers.resize
+      (std::max (1, gdbarch_displaced_step_buffer_count (gdbarch)));
+
+  for (index = 0; displaced->buffers[index].step_thread != nullptr; index++)
+    ;
+  displaced_step_buffer *buffer = &displaced->buffers[index];
+
+  displaced_step_clear (buffer);
+
   original = regcache_read_pc (regcache);
 
-  copy = gdbarch_displaced_step_location (gdbarch);
   len = gdbarch_max_insn_length (gdbarch);
+  copy = gdbarch_displaced_step_location (gdbarch) + index * len;
 
   if (breakpoint_in_range_p (aspace, copy, len))
     {
@@ -1712,9 +1729,13 @@ displaced_step_prepare_throw (thread_info *tp)
       return -1;
     }
 
+  if (debug_displaced)
+    fprintf_unfiltered (gdb_stdlog, "displaced: using buffer %d of %d\n",
+			index, (int) displaced->buffers.size ());
+
   /* Save the original contents of the copy area.  */
-  displaced->step_saved_copy.resize (len);
-  status = target_read_memory (copy, displaced->step_saved_copy.data (), len);
+  buffer->step_saved_copy.resize (len);
+  status = target_read_memory (copy, buffer->step_saved_copy.data (), len);
   if (status != 0)
     throw_error (MEMORY_ERROR,
 		 _("Error accessing memory address %s (%s) for "
@@ -1725,7 +1746,7 @@ displaced_step_prepare_throw (thread_info *tp)
       fprintf_unfiltered (gdb_stdlog, "displaced: saved %s: ",
 			  paddress (gdbarch, copy));
       displaced_step_dump_bytes (gdb_stdlog,
-				 displaced->step_saved_copy.data (),
+				 buffer->step_saved_copy.data (),
 				 len);
     };
 
@@ -1741,14 +1762,14 @@ displaced_step_prepare_throw (thread_info *tp)
 
   /* Save the information we need to fix things up if the step
      succeeds.  */
-  displaced->step_thread = tp;
-  displaced->step_gdbarch = gdbarch;
-  displaced->step_closure = closure;
-  displaced->step_original = original;
-  displaced->step_copy = copy;
+  buffer->step_thread = tp;
+  buffer->step_gdbarch = gdbarch;
+  buffer->step_closure = closure;
+  buffer->step_original = original;
+  buffer->step_copy = copy;
 
   {
-    displaced_step_clear_cleanup cleanup (displaced);
+    displaced_step_clear_cleanup cleanup (buffer);
 
     /* Resume execution at the copy.  */
     regcache_write_pc (regcache, copy);
@@ -1817,21 +1838,21 @@ write_memory_ptid (ptid_t ptid, CORE_ADDR memaddr,
   write_memory (memaddr, myaddr, len);
 }
 
-/* Restore the contents of the copy area for thread PTID.  */
+/* Restore the contents of BUFFER's copy area for thread PTID.  */
 
 static void
-displaced_step_restore (struct displaced_step_inferior_state *displaced,
+displaced_step_restore (struct displaced_step_buffer *buffer,
 			ptid_t ptid)
 {
-  ULONGEST len = gdbarch_max_insn_length (displaced->step_gdbarch);
+  ULONGEST len = gdbarch_max_insn_length (buffer->step_gdbarch);
 
-  write_memory_ptid (ptid, displaced->step_copy,
-		     displaced->step_saved_copy.data (), len);
+  write_memory_ptid (ptid, buffer->step_copy,
+		     buffer->step_saved_copy.data (), len);
   if (debug_displaced)
     fprintf_unfiltered (gdb_stdlog, "displaced: restored %s %s\n",
 			target_pid_to_str (ptid).c_str (),
-			paddress (displaced->step_gdbarch,
-				  displaced->step_copy));
+			paddress (buffer->step_gdbarch,
+				  buffer->step_copy));
 }
 
 /* If we displaced stepped an instruction successfully, adjust
@@ -1843,17 +1864,18 @@ displaced_step_restore (struct displaced_step_inferior_state *displaced,
 static int
 displaced_step_fixup (thread_info *event_thread, enum gdb_signal signal)
 {
-  struct displaced_step_inferior_state *displaced
-    = get_displaced_stepping_state (event_thread->inf);
+  struct displaced_step_buffer *buffer
+    = get_displaced_stepping_state (event_thread->inf)->thread_buffer
+	(event_thread);
   int ret;
 
-  /* Was this event for the thread we displaced?  */
-  if (displaced->step_thread != event_thread)
+  /* Was this event for a thread we displaced?  */
+  if (buffer == nullptr)
     return 0;
 
-  displaced_step_clear_cleanup cleanup (displaced);
+  displaced_step_clear_cleanup cleanup (buffer);
 
-  displaced_step_restore (displaced, displaced->step_thread->ptid);
+  displaced_step_restore (buffer, event_thread->ptid);
 
   /* Fixup may need to read memory/registers.  Switch to the thread
      that we're fixing up.  Also, target_stopped_by_watchpoint checks
@@ -1863,15 +1885,16 @@ displaced_step_fixup (thread_info *event_thread, enum gdb_signal signal)
   /* Did the instruction complete successfully?  */
   if (signal == GDB_SIGNAL_TRAP
       && !(target_stopped_by_watchpoint ()
-	   && (gdbarch_have_nonsteppable_watchpoint (displaced->step_gdbarch)
-	       || target_have_steppable_watchpoint)))
+	   && (gdbarch_have_nonsteppable_watchpoint (buffer->step_gdbarch)
+	       || target_have_steppable_watchpoint
+	       || target_stopped_by_nonsteppable_watchpoint ())))
     {
       /* Fix up the resulting state.  */
-      gdbarch_displaced_step_fixup (displaced->step_gdbarch,
-                                    displaced->step_closure,
-                                    displaced->step_original,
-                                    displaced->step_copy,
-                                    get_thread_regcache (displaced->step_thread));
+      gdbarch_displaced_step_fixup (buffer->step_gdbarch,
+                                    buffer->step_closure,
+                                    buffer->step_original,
+                                    buffer->step_copy,
+                                    get_thread_regcache (event_thread));
       ret = 1;
     }
   else
@@ -1881,7 +1904,7 @@ displaced_step_fixup (thread_info *event_thread, enum gdb_signal signal)
       struct regcache *regcache = get_thread_regcache (event_thread);
       CORE_ADDR pc = regcache_read_pc (regcache);
 
-      pc = displaced->step_original + (pc - displaced->step_copy);
+      pc = buffer->step_original + (pc - buffer->step_copy);
       regcache_write_pc (regcache, pc);
       ret = -1;
     }
@@ -1951,9 +1974,9 @@ start_step_over (void)
 
       next = thread_step_over_chain_next (tp);
 
-      /* If this inferior already has a displaced step in process,
-	 don't start a new one.  */
-      if (displaced_step_in_progress (tp->inf))
+      /* If all of this inferior's displaced stepping buffers are in
+	 use, don't start a new one.  */
+      if (!get_displaced_stepping_state (tp->inf)->has_free_buffer ())
 	continue;
 
       step_what = thread_still_needs_step_over (tp);
@@ -2215,6 +2238,25 @@ do_target_resume (ptid_t resume_ptid, int step, enum gdb_signal sig)
   target_commit_resume ();
 }
 
+/* Return true if resuming TP is a plain continue, for which neither
+   resume nor the event handling that follows look at the PC the
+   thread was resumed from: TP is not stepping, not stepping over a
+   breakpoint or watchpoint, and it can't be sitting at a permanent
+   breakpoint.  Threads stopped by a stop request have no registers
+   cached, so not reading the PC of such threads saves a register
+   fetch per thread on every resume.  */
+
+static bool
+thread_plain_continue_p (struct thread_info *tp)
+{
+  return (tp->control.step_range_end == 0
+	  && tp->control.step_resume_breakpoint == NULL
+	  && !tp->stepping_over_breakpoint
+	  && !tp->stepping_over_watchpoint
+	  && !currently_stepping (tp)
+	  && !permanent_breakpoint_location_p ());
+}
+
 /* Resume the inferior.  SIG is the signal to give the inferior
    (GDB_SIGNAL_0 for none).  Note: don't call this directly; instead
    call 'resume', which handles exceptions.  */
@@ -2225,7 +2267,7 @@ resume_1 (enum gdb_signal sig)
   struct regcache *regcache = get_current_regcache ();
   struct gdbarch *gdbarch = regcache->arch ();
   struct thread_info *tp = inferior_thread ();
-  CORE_ADDR pc = regcache_read_pc (regcache);
+  CORE_ADDR pc = 0;
   const address_space *aspace = regcache->aspace ();
   ptid_t resume_ptid;
   /* This represents the user's step vs continue request.  When
@@ -2303,6 +2345,11 @@ resume_1 (enum gdb_signal sig)
       step = 0;
     }
 
+  /* Nothing below looks at PC when plainly continuing the thread.  */
+  bool pc_read = step || !thread_plain_continue_p (tp);
+  if (pc_read)
+    pc = regcache_read_pc (regcache);
+
   if (debug_infrun)
     fprintf_unfiltered (gdb_stdlog,
 			"infrun: resume (step=%d, signal=%s), "
@@ -2310,7 +2357,7 @@ resume_1 (enum gdb_signal sig)
 			step, gdb_signal_to_symbol_string (sig),
 			tp->control.trap_expected,
 			target_pid_to_str (inferior_ptid).c_str (),
-			paddress (gdbarch, pc));
+			pc_read ? paddress (gdbarch, pc) : "<pc not read>");
 
   /* Normally, by the time we reach `resume', the breakpoints are either
      removed or inserted, as appropriate.  The exception is if we're sitting
@@ -2439,15 +2486,15 @@ resume_1 (enum gdb_signal sig)
 	}
       else if (prepared > 0)
 	{
-	  struct displaced_step_inferior_state *displaced;
+	  struct displaced_step_buffer *buffer;
 
 	  /* Update pc to reflect the new address from which we will
 	     execute instructions due to displaced stepping.  */
 	  pc = regcache_read_pc (get_thread_regcache (tp));
 
-	  displaced = get_displaced_stepping_state (tp->inf);
+	  buffer = get_displaced_stepping_state (tp->inf)->thread_buffer (tp);
 	  step = gdbarch_displaced_step_hw_singlestep (gdbarch,
-						       displaced->step_closure);
+						       buffer->step_closure);
 	}
     }
 
@@ -3457,7 +3504,7 @@ prepare_for_detach (void)
 
   /* Is any thread of this process displaced stepping?  If not,
      there's nothing else to do.  */
-  if (displaced->step_thread == nullptr)
+  if (!displaced->in_progress ())
     return;
 
   if (debug_infrun)
@@ -3466,7 +3513,7 @@ prepare_for_detach (void)
 
   scoped_restore restore_detaching = make_scoped_restore (&inf->detaching, true);
 
-  while (displaced->step_thread != nullptr)
+  while (displaced->in_progress ())
     {
       struct execution_control_state ecss;
       struct execution_control_state *ecs;
@@ -4277,6 +4324,83 @@ save_waitstatus (struct thread_info *tp, struct target_waitstatus *ws)
     }
 }
 
+/* Statistics about stop_all_threads, shown by "maint print
+   stop-all-threads-stats".  */
+
+struct stop_all_threads_stats
+{
+  /* Number of calls to stop_all_threads.  */
+  ULONGEST calls = 0;
+
+  /* Number of times the thread list was scanned for threads to
+     stop.  */
+  ULONGEST scans = 0;
+
+  /* Number of threads that were asked to stop, and number of stop
+     requests sent to the target for them.  The latter is lower when
+     whole processes are stopped with a single request.  */
+  ULONGEST threads_stopped = 0;
+  ULONGEST stop_requests = 0;
+
+  /* Number of events reaped while waiting for the threads to
+     stop.  */
+  ULONGEST events = 0;
+
+  /* Wall-clock time spent in stop_all_threads: in total, in the
+     slowest call and in the last call.  */
+  std::chrono::steady_clock::duration total_time {};
+  std::chrono::steady_clock::duration max_time {};
+  std::chrono::steady_clock::duration last_time {};
+};
+
+static struct stop_all_threads_stats stop_all_threads_stats;
+
+/* Ask the target to stop the threads in TO_STOP, which are executing
+   and not being stopped already.  Threads of the same inferior are
+   adjacent in TO_STOP, and for each inferior, TO_STOP holds all its
+   threads that need stopping.  So when there are several, stop the
+   whole process with a single request instead of sending one per
+   thread; stopping a thread that is stopped already, or already
+   being stopped, has no effect.  With thousands of threads, that
+   saves as many target calls, or remote round trips.  */
+
+static void
+request_thread_stops (const std::vector<thread_info *> &to_stop)
+{
+  size_t first = 0;
+
+  while (first < to_stop.size ())
+    {
+      inferior *inf = to_stop[first]->inf;
+      size_t last = first;
+
+      while (last < to_stop.size () && to_stop[last]->inf == inf)
+	last++;
+
+      if (last - first > 1)
+	{
+	  if (debug_infrun)
+	    fprintf_unfiltered (gdb_stdlog,
+				"infrun:   stopping %s threads of "
+				"process %d at once\n",
+				pulongest (last - first), inf->pid);
+	  target_stop (ptid_t (inf->pid));
+	  stop_all_threads_stats.stop_requests++;
+	}
+      else
+	{
+	  target_stop (to_stop[first]->ptid);
+	  stop_all_threads_stats.stop_requests++;
+	}
+
+      for (size_t i = first; i < last; i++)
+	to_stop[i]->stop_requested = 1;
+      stop_all_threads_stats.threads_stopped += last - first;
+
+      first = last;
+    }
+}
+
 /* See infrun.h.  */
 
 void
@@ -4286,6 +4410,10 @@ stop_all_threads (void)
   int pass;
   int iterations = 0;
 
+  /* The threads we have asked to stop, and haven't reported a stop
+     yet.  */
+  std::unordered_set<ptid_t, hash_ptid> pending;
+
   gdb_assert (target_is_non_stop_p ());
 
   if (debug_infrun)
@@ -4296,6 +4424,18 @@ stop_all_threads (void)
   target_thread_events (1);
   SCOPE_EXIT { target_thread_events (0); };
 
+  auto start_time = std::chrono::steady_clock::now ();
+  stop_all_threads_stats.calls++;
+  SCOPE_EXIT
+    {
+      auto elapsed = std::chrono::steady_clock::now () - start_time;
+
+      stop_all_threads_stats.total_time += elapsed;
+      stop_all_threads_stats.last_time = elapsed;
+      if (elapsed > stop_all_threads_stats.max_time)
+	stop_all_threads_stats.max_time = elapsed;
+    };
+
   /* Request threads to stop, and then wait for the stops.  Because
      threads we already know about can spawn more threads while we're
      trying to stop them, and we only learn about new threads when we
@@ -4309,14 +4449,14 @@ stop_all_threads (void)
 			    "iterations=%d\n", pass, iterations);
       while (1)
 	{
-	  ptid_t event_ptid;
-	  struct target_waitstatus ws;
-	  int need_wait = 0;
+	  std::vector<thread_info *> to_stop;
 
 	  update_thread_list ();
+	  stop_all_threads_stats.scans++;
 
 	  /* Go through all threads looking for threads that we need
 	     to tell the target to stop.  */
+	  pending.clear ();
 	  for (thread_info *t : all_non_exited_threads ())
 	    {
 	      if (t->executing)
@@ -4330,8 +4470,7 @@ stop_all_threads (void)
 					    "infrun:   %s executing, "
 					    "need stop\n",
 					    target_pid_to_str (t->ptid).c_str ());
-		      target_stop (t->ptid);
-		      t->stop_requested = 1;
+		      to_stop.push_back (t);
 		    }
 		  else
 		    {
@@ -4342,8 +4481,7 @@ stop_all_threads (void)
 					    target_pid_to_str (t->ptid).c_str ());
 		    }
 
-		  if (t->stop_requested)
-		    need_wait = 1;
+		  pending.insert (t->ptid);
 		}
 	      else
 		{
@@ -4358,7 +4496,9 @@ stop_all_threads (void)
 		}
 	    }
 
-	  if (!need_wait)
+	  request_thread_stops (to_stop);
+
+	  if (pending.empty ())
 	    break;
 
 	  /* If we find new threads on the second iteration, restart
@@ -4367,109 +4507,138 @@ stop_all_threads (void)
 	  if (pass > 0)
 	    pass = -1;
 
-	  event_ptid = wait_one (&ws);
-	  if (debug_infrun)
-	    {
-	      fprintf_unfiltered (gdb_stdlog,
-				  "infrun: stop_all_threads %s %s\n",
-				  target_waitstatus_to_string (&ws).c_str (),
-				  target_pid_to_str (event_ptid).c_str ());
-	    }
+	  /* Reap stop events without rescanning the thread list after
+	     each one, which would make stopping N threads cost
+	     O(N^2).  Rescan when half of the threads we are waiting
+	     for have reported, to find new threads, and threads that
+	     went away without reporting an exit.  */
+	  size_t rescan_threshold = pending.size () / 2;
 
-	  if (ws.kind == TARGET_WAITKIND_NO_RESUMED
-	      || ws.kind == TARGET_WAITKIND_THREAD_EXITED
-	      || ws.kind == TARGET_WAITKIND_EXITED
-	      || ws.kind == TARGET_WAITKIND_SIGNALLED)
-	    {
-	      /* All resumed threads exited
-		 or one thread/process exited/signalled.  */
-	    }
-	  else
+	  while (pending.size () > rescan_threshold)
 	    {
-	      thread_info *t = find_thread_ptid (event_ptid);
-	      if (t == NULL)
-		t = add_thread (event_ptid);
-
-	      t->stop_requested = 0;
-	      t->executing = 0;
-	      t->resumed = 0;
-	      t->control.may_range_step = 0;
-
-	      /* This may be the first time we see the inferior report
-		 a stop.  */
-	      inferior *inf = find_inferior_ptid (event_ptid);
-	      if (inf->needs_setup)
+	      ptid_t event_ptid;
+	      struct target_waitstatus ws;
+
+	      event_ptid = wait_one (&ws);
+	      stop_all_threads_stats.events++;
+	      if (debug_infrun)
 		{
-		  switch_to_thread_no_regs (t);
-		  setup_inferior (0);
+		  fprintf_unfiltered (gdb_stdlog,
+				      "infrun: stop_all_threads %s %s\n",
+				      (target_waitstatus_to_string (&ws)
+				       .c_str ()),
+				      target_pid_to_str (event_ptid).c_str ());
 		}
 
-	      if (ws.kind == TARGET_WAITKIND_STOPPED
-		  && ws.value.sig == GDB_SIGNAL_0)
+	      if (ws.kind == TARGET_WAITKIND_NO_RESUMED
+		  || ws.kind == TARGET_WAITKIND_THREAD_EXITED
+		  || ws.kind == TARGET_WAITKIND_EXITED
+		  || ws.kind == TARGET_WAITKIND_SIGNALLED)
 		{
-		  /* We caught the event that we intended to catch, so
-		     there's no event pending.  */
-		  t->suspend.waitstatus.kind = TARGET_WAITKIND_IGNORE;
-		  t->suspend.waitstatus_pending_p = 0;
-
-		  if (displaced_step_fixup (t, GDB_SIGNAL_0) < 0)
+		  /* All resumed threads exited
+		     or one thread/process exited/signalled.  */
+		  if (ws.kind == TARGET_WAITKIND_THREAD_EXITED)
+		    pending.erase (event_ptid);
+		  else
 		    {
-		      /* Add it back to the step-over queue.  */
-		      if (debug_infrun)
-			{
-			  fprintf_unfiltered (gdb_stdlog,
-					      "infrun: displaced-step of %s "
-					      "canceled: adding back to the "
-					      "step-over queue\n",
-					      target_pid_to_str (t->ptid).c_str ());
-			}
-		      t->control.trap_expected = 0;
-		      thread_step_over_chain_enqueue (t);
+		      /* Rescan to see which threads are left.  */
+		      pending.clear ();
 		    }
 		}
 	      else
 		{
-		  enum gdb_signal sig;
-		  struct regcache *regcache;
+		  thread_info *t = find_thread_ptid (event_ptid);
+		  if (t == NULL)
+		    t = add_thread (event_ptid);
 
-		  if (debug_infrun)
-		    {
-		      std::string statstr = target_waitstatus_to_string (&ws);
-
-		      fprintf_unfiltered (gdb_stdlog,
-					  "infrun: target_wait %s, saving "
-					  "status for %d.%ld.%ld\n",
-					  statstr.c_str (),
-					  t->ptid.pid (),
-					  t->ptid.lwp (),
-					  t->ptid.tid ());
-		    }
-
-		  /* Record for later.  */
-		  save_waitstatus (t, &ws);
+		  pending.erase (event_ptid);
 
-		  sig = (ws.kind == TARGET_WAITKIND_STOPPED
-			 ? ws.value.sig : GDB_SIGNAL_0);
+		  t->stop_requested = 0;
+		  t->executing = 0;
+		  t->resumed = 0;
+		  t->control.may_range_step = 0;
 
-		  if (displaced_step_fixup (t, sig) < 0)
+		  /* This may be the first time we see the inferior report
+		     a stop.  */
+		  inferior *inf = find_inferior_ptid (event_ptid);
+		  if (inf->needs_setup)
 		    {
-		      /* Add it back to the step-over queue.  */
-		      t->control.trap_expected = 0;
-		      thread_step_over_chain_enqueue (t);
+		      switch_to_thread_no_regs (t);
+		      setup_inferior (0);
 		    }
 
-		  regcache = get_thread_regcache (t);
-		  t->suspend.stop_pc = regcache_read_pc (regcache);
+		  if (ws.kind == TARGET_WAITKIND_STOPPED
+		      && ws.value.sig == GDB_SIGNAL_0)
+		    {
+		      /* We caught the event that we intended to catch, so
+			 there's no event pending.  */
+		      t->suspend.waitstatus.kind = TARGET_WAITKIND_IGNORE;
+		      t->suspend.waitstatus_pending_p = 0;
 
-		  if (debug_infrun)
+		      if (displaced_step_fixup (t, GDB_SIGNAL_0) < 0)
+			{
+			  /* Add it back to the step-over queue.  */
+			  if (debug_infrun)
+			    {
+			      std::string pidstr = target_pid_to_str (t->ptid);
+
+			      fprintf_unfiltered (gdb_stdlog,
+						  "infrun: displaced-step of "
+						  "%s canceled: adding back "
+						  "to the step-over queue\n",
+						  pidstr.c_str ());
+			    }
+			  t->control.trap_expected = 0;
+			  thread_step_over_chain_enqueue (t);
+			}
+		    }
+		  else
 		    {
-		      fprintf_unfiltered (gdb_stdlog,
-					  "infrun: saved stop_pc=%s for %s "
-					  "(currently_stepping=%d)\n",
-					  paddress (target_gdbarch (),
-						    t->suspend.stop_pc),
-					  target_pid_to_str (t->ptid).c_str (),
-					  currently_stepping (t));
+		      enum gdb_signal sig;
+		      struct regcache *regcache;
+
+		      if (debug_infrun)
+			{
+			  std::string statstr
+			    = target_waitstatus_to_string (&ws);
+
+			  fprintf_unfiltered (gdb_stdlog,
+					      "infrun: target_wait %s, saving "
+					      "status for %d.%ld.%ld\n",
+					      statstr.c_str (),
+					      t->ptid.pid (),
+					      t->ptid.lwp (),
+					      t->ptid.tid ());
+			}
+
+		      /* Record for later.  */
+		      save_waitstatus (t, &ws);
+
+		      sig = (ws.kind == TARGET_WAITKIND_STOPPED
+			     ? ws.value.sig : GDB_SIGNAL_0);
+
+		      if (displaced_step_fixup (t, sig) < 0)
+			{
+			  /* Add it back to the step-over queue.  */
+			  t->control.trap_expected = 0;
+			  thread_step_over_chain_enqueue (t);
+			}
+
+		      regcache = get_thread_regcache (t);
+		      t->suspend.stop_pc = regcache_read_pc (regcache);
+
+		      if (debug_infrun)
+			{
+			  std::string pidstr = target_pid_to_str (t->ptid);
+
+			  fprintf_unfiltered (gdb_stdlog,
+					      "infrun: saved stop_pc=%s for "
+					      "%s (currently_stepping=%d)\n",
+					      paddress (target_gdbarch (),
+							t->suspend.stop_pc),
+					      pidstr.c_str (),
+					      currently_stepping (t));
+			}
 		    }
 		}
 	    }
@@ -4480,6 +4649,31 @@ stop_all_threads (void)
     fprintf_unfiltered (gdb_stdlog, "infrun: stop_all_threads done\n");
 }
 
+/* The "maint print stop-all-threads-stats" command.  */
+
+static void
+maintenance_print_stop_all_threads_stats (const char *args, int from_tty)
+{
+  using namespace std::chrono;
+
+  const struct stop_all_threads_stats &stats = stop_all_threads_stats;
+
+  printf_filtered (_("Calls: %s\n"), pulongest (stats.calls));
+  printf_filtered (_("Thread list scans: %s\n"), pulongest (stats.scans));
+  printf_filtered (_("Threads stopped: %s, with %s stop requests\n"),
+		   pulongest (stats.threads_stopped),
+		   pulongest (stats.stop_requests));
+  printf_filtered (_("Events reaped: %s\n"), pulongest (stats.events));
+  printf_filtered (_("Time: %.6f total, %.6f last, %.6f max, "
+		     "%.6f average (seconds)\n"),
+		   duration<double> (stats.total_time).count (),
+		   duration<double> (stats.last_time).count (),
+		   duration<double> (stats.max_time).count (),
+		   (stats.calls == 0 ? 0.0
+		    : duration<double> (stats.total_time).count ()
+		      / stats.calls));
+}
+
 /* Handle a TARGET_WAITKIND_NO_RESUMED event.  */
 
 static int
@@ -4929,8 +5123,14 @@ Cannot fill $_exitsignal with the correct signal number.\n"));
 		struct displaced_step_inferior_state *displaced
 		  = get_displaced_stepping_state (parent_inf);
 
-		/* Restore scratch pad for child process.  */
-		displaced_step_restore (displaced, ecs->ws.value.related_pid);
+		/* Restore scratch pads for child process.  The child
+		   inherited the copies of all displaced steps in flight,
+		   and every buffer that was ever used holds the
+		   original contents of its copy area.  */
+		for (displaced_step_buffer &buffer : displaced->buffers)
+		  if (!buffer.step_saved_copy.empty ())
+		    displaced_step_restore (&buffer,
+					    ecs->ws.value.related_pid);
 	      }
 
 	    /* Since the vfork/fork syscall instruction was executed in the scratchpad,
@@ -5569,7 +5769,8 @@ handle_signal_stop (struct execution_control_state *ecs)
      it in a moment.  */
   if (stopped_by_watchpoint
       && (target_have_steppable_watchpoint
-	  || gdbarch_have_nonsteppable_watchpoint (gdbarch)))
+	  || gdbarch_have_nonsteppable_watchpoint (gdbarch)
+	  || target_stopped_by_nonsteppable_watchpoint ()))
     {
       /* At this point, we are stopped at an instruction which has
          attempted to write to a piece of memory under control of
@@ -5691,6 +5892,25 @@ handle_signal_stop (struct execution_control_state *ecs)
 	}
     }
 
+  /* If the target already found the conditions of the breakpoints at
+     the stop PC false, there is nothing to check; just step over the
+     breakpoint.  */
+  if (ecs->event_thread->suspend.stop_signal == GDB_SIGNAL_TRAP
+      && !currently_stepping (ecs->event_thread)
+      && ecs->event_thread->control.step_resume_breakpoint == NULL
+      && target_stopped_by_false_breakpoint_condition ()
+      && only_target_conditional_breakpoints_here_p
+	   (get_current_regcache ()->aspace (),
+	    ecs->event_thread->suspend.stop_pc))
+    {
+      if (debug_infrun)
+	fprintf_unfiltered (gdb_stdlog,
+			    "infrun: breakpoint conditions false\n");
+      ecs->event_thread->stepping_over_breakpoint = 1;
+      keep_going (ecs);
+      return;
+    }
+
   /* See if there is a breakpoint/watchpoint/catchpoint/etc. that
      handles this event.  */
   ecs->event_thread->control.stop_bpstat
@@ -7439,9 +7659,13 @@ keep_going_pass_signal (struct execution_control_state *ecs)
   gdb_assert (ecs->event_thread->ptid == inferior_ptid);
   gdb_assert (!ecs->event_thread->resumed);
 
-  /* Save the pc before execution, to compare with pc after stop.  */
-  ecs->event_thread->prev_pc
-    = regcache_read_pc (get_thread_regcache (ecs->event_thread));
+  /* Save the pc before execution, to compare with pc after stop.
+     Only stepping threads compare it, so don't fetch the registers of
+     a thread that is just being continued.  */
+  if (ecs->hit_singlestep_breakpoint
+      || !thread_plain_continue_p (ecs->event_thread))
+    ecs->event_thread->prev_pc
+      = regcache_read_pc (get_thread_regcache (ecs->event_thread));
 
   if (ecs->event_thread->control.trap_expected)
     {
@@ -8955,6 +9179,13 @@ When non-zero, displaced stepping specific debugging is enabled."),
 			    show_debug_displaced,
 			    &setdebuglist, &showdebuglist);
 
+  add_cmd ("stop-all-threads-stats", class_maintenance,
+	   maintenance_print_stop_all_threads_stats, _("\
+Print statistics about stopping all threads.\n\
+Shows how often GDB had to stop all threads, how many threads and\n\
+events that involved, and how long it took."),
+	   &maintenanceprintlist);
+
   add_setshow_boolean_cmd ("non-stop", no_class,
 			   &non_stop_1, _("\
 Set whether gdb controls the inferior in non-stop mode."), _("\
@@ -259,6 +259,30 @@ struct buf_displaced_step_closure : displaced_step_closure
   gdb::byte_vector buf;
 };
 
+/* One displaced stepping buffer of an inferior, and the state of the
+   displaced step using it, if any.  */
+struct displaced_step_buffer
+{
+  /* If this is not nullptr, this is the thread carrying out a
+     displaced single-step using this buffer.  This thread's state
+     will require fixing up once it has completed its step.  */
+  thread_info *step_thread = nullptr;
+
+  /* The architecture the thread had when we stepped it.  */
+  gdbarch *step_gdbarch = nullptr;
+
+  /* The closure provided gdbarch_displaced_step_copy_insn, to be used
+     for post-step cleanup.  */
+  displaced_step_closure *step_closure = nullptr;
+
+  /* The address of the original instruction, and the copy we
+     made.  */
+  CORE_ADDR step_original = 0, step_copy = 0;
+
+  /* Saved contents of copy area.  */
+  gdb::byte_vector step_saved_copy;
+};
+
 /* Per-inferior displaced stepping state.  */
 struct displaced_step_inferior_state
 {
@@ -271,36 +295,49 @@ struct displaced_step_inferior_state
   void reset ()
   {
     failed_before = 0;
-    step_thread = nullptr;
-    step_gdbarch = nullptr;
-    step_closure = nullptr;
-    step_original = 0;
-    step_copy = 0;
-    step_saved_copy.clear ();
+    buffers.clear ();
   }
 
-  /* True if preparing a displaced step ever failed.  If so, we won't
-     try displaced stepping for this inferior again.  */
-  int failed_before;
-
-  /* If this is not nullptr, this is the thread carrying out a
-     displaced single-step in process PID.  This thread's state will
-     require fixing up once it has completed its step.  */
-  thread_info *step_thread;
+  /* Return the buffer THREAD is displaced stepping with, or nullptr
+     if THREAD isn't doing a displaced step.  */
+  displaced_step_buffer *thread_buffer (const thread_info *thread)
+  {
+    for (displaced_step_buffer &buffer : buffers)
+      if (buffer.step_thread == thread)
+	return &buffer;
+    return nullptr;
+  }
 
-  /* The architecture the thread had when we stepped it.  */
-  gdbarch *step_gdbarch;
+  /* Return true if any thread is doing a displaced step.  */
+  bool in_progress () const
+  {
+    for (const displaced_step_buffer &buffer : buffers)
+      if (buffer.step_thread != nullptr)
+	return true;
+    return false;
+  }
 
-  /* The closure provided gdbarch_displaced_step_copy_insn, to be used
-     for post-step cleanup.  */
-  displaced_step_closure *step_closure;
+  /* Return true if a new displaced step can start now.  The buffers
+     are only laid out when the first displaced step starts, so an
+     empty pool counts as having a free buffer.  */
+  bool has_free_buffer () const
+  {
+    if (buffers.empty ())
+      return true;
+    for (const displaced_step_buffer &buffer : buffers)
+      if (buffer.step_thread == nullptr)
+	return true;
+    return false;
+  }
 
-  /* The address of the original instruction, and the copy we
-     made.  */
-  CORE_ADDR step_original, step_copy;
+  /* True if preparing a displaced step ever failed.  If so, we won't
+     try displaced stepping for this inferior again.  */
+  int failed_before;
 
-  /* Saved contents of copy area.  */
-  gdb::byte_vector step_saved_copy;
+  /* The displaced stepping buffers, see
+     gdbarch_displaced_step_buffer_count.  Buffer N is at
+     gdbarch_displaced_step_location + N * gdbarch_max_insn_length.  */
+  std::vector<displaced_step_buffer> buffers;
 };
 
 #endif /* INFRUN_H */
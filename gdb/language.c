@@ -894,7 +894,8 @@ const struct language_defn unknown_language_defn =
   NULL,
   NULL,
   default_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 /* These two structs define fake entries for the "local" and "auto"
@@ -946,7 +947,8 @@ const struct language_defn auto_language_defn =
   NULL,
   NULL,
   default_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 
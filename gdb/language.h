@@ -458,6 +458,12 @@ struct language_defn
        deep" this string is displayed instead.  */
     const char *la_struct_too_deep_ellipsis;
 
+    /* True if la_val_print reads the parts of a lazy value as it
+       prints them, so that GDB may leave the value to be read in
+       parts (see value_begin_fetch_in_parts) instead of reading all of
+       it first.  */
+    bool la_val_print_fetches_in_parts;
+
   };
 
 /* Pointer to the language_defn for our current language.  This pointer
@@ -67,6 +67,10 @@
 #include "nat/linux-namespaces.h"
 #include "gdbsupport/fileio.h"
 #include "gdbsupport/scope-exit.h"
+#include "ax.h"
+#include "breakpoint.h"
+#include <unordered_map>
+#include <sys/mman.h>
 
 /* This comment documents high-level logic of this file.
 
@@ -122,6 +126,25 @@ event, it's bad.  OTOH, if we notify the event loop when there's no
 event from the target, linux_nat_wait will detect that there's no real
 event to report, and return event of type TARGET_WAITKIND_IGNORE.
 This is mostly harmless, but it will waste time and is better avoided.
+For the same reason, the SIGCHLD handler doesn't write to the pipe
+again while a previous byte hasn't been consumed yet: a burst of
+SIGCHLDs results in a single wakeup, and that wakeup reaps every
+pending waitpid status in one go.
+
+Neither signalfd nor pidfds replace the SIGCHLD handler.  A signalfd
+requires SIGCHLD to be blocked at all times, and the blocked mask
+would be inherited by every child GDB spawns (the shell that starts
+the inferior, for one), while a pidfd only reports process exits, not
+ptrace stops.
+
+Once the events are reaped, linux_nat_wait looks for an LWP with a
+pending status to report, and resumes the LWPs that stopped for
+events the core isn't interested in.  Only LWPs that are stopped can
+be in either state, so those scans walk a list of the LWPs that
+stopped since they were last seen running (see
+iterate_over_stopped_lwps), instead of all LWPs.  With thousands of
+threads, most of them running, this keeps the cost of each wakeup
+proportional to the number of events.
 
 The main design point is that every time GDB is outside linux-nat.c,
 we have a SIGCHLD handler installed that is called when something
@@ -217,6 +240,14 @@ static int linux_nat_event_pipe[2] = { -1, -1 };
 /* True if we're currently in async mode.  */
 #define linux_is_async_p() (linux_nat_event_pipe[0] != -1)
 
+/* Set while the event pipe holds a byte the event loop hasn't
+   consumed yet.  A burst of SIGCHLDs (e.g., many threads stopping or
+   exiting at once) then costs a single write and a single wakeup:
+   linux_nat_wait always reaps every pending waitpid status after
+   flushing the pipe, so the extra marks would carry no
+   information.  */
+static volatile sig_atomic_t linux_nat_event_pipe_marked;
+
 /* Flush the event pipe.  */
 
 static void
@@ -230,6 +261,10 @@ async_file_flush (void)
       ret = read (linux_nat_event_pipe[0], &buf, 1);
     }
   while (ret >= 0 || (ret == -1 && errno == EINTR));
+
+  /* Clear the flag only after draining, so that a SIGCHLD arriving
+     from here on writes a fresh byte.  */
+  linux_nat_event_pipe_marked = 0;
 }
 
 /* Put something (anything, doesn't matter what, or how much) in event
@@ -241,10 +276,16 @@ async_file_mark (void)
 {
   int ret;
 
+  /* If a mark is already pending, the event loop will wake up
+     anyway.  */
+  if (linux_nat_event_pipe_marked)
+    return;
+
   /* It doesn't really matter what the pipe contains, as long we end
      up with something in it.  Might as well flush the previous
      left-overs.  */
   async_file_flush ();
+  linux_nat_event_pipe_marked = 1;
 
   do
     {
@@ -268,11 +309,135 @@ static struct lwp_info *add_lwp (ptid_t ptid);
 static void purge_lwp_list (int pid);
 static void delete_lwp (ptid_t ptid);
 static struct lwp_info *find_lwp_pid (ptid_t ptid);
+static void mark_lwp_stopped (struct lwp_info *lp);
 
 static int lwp_status_pending_p (struct lwp_info *lp);
 
 static void save_stop_reason (struct lwp_info *lp);
 
+static bool page_protection_fault_p (struct lwp_info *lp,
+				     CORE_ADDR *fault_addr);
+
+static bool breakpoint_conditions_false_p (struct lwp_info *lp);
+static bool can_step_over_cond_breakpoint_p (struct lwp_info *lp);
+static bool cond_step_over_in_progress_p (int pid);
+static bool cond_step_over_holds_p (struct lwp_info *lp);
+static void hold_lwp (struct lwp_info *lp, int step, enum gdb_signal signo);
+static void cancel_cond_step_overs (ptid_t filter);
+
+/* Whether the native target evaluates breakpoint conditions itself
+   (see "set breakpoint condition-evaluation").  */
+
+static bool native_condition_evaluation = false;
+
+static void
+show_native_condition_evaluation (struct ui_file *file, int from_tty,
+				  struct cmd_list_element *c,
+				  const char *value)
+{
+  fprintf_filtered (file,
+		    _("Evaluation of breakpoint conditions by the native "
+		      "target is %s.\n"),
+		    value);
+}
+
+/* Implement "set native-condition-evaluation".  */
+
+static void
+set_native_condition_evaluation (const char *args, int from_tty,
+				 struct cmd_list_element *c)
+{
+  breakpoint_condition_evaluation_support_changed ();
+}
+
+/* A software breakpoint inserted with target-side conditions.  */
+
+struct linux_nat_cond_breakpoint
+{
+  /* The architecture the breakpoint was inserted for.  */
+  struct gdbarch *gdbarch;
+
+  /* The memory contents under the breakpoint, and the breakpoint
+     instruction, for stepping an LWP over the breakpoint.  */
+  gdb::byte_vector shadow;
+  gdb::byte_vector insn;
+
+  /* The bytecode of the conditions.  A thread that hits the
+     breakpoint is only reported as having stopped at a breakpoint
+     with false conditions if they are all false.  */
+  std::vector<gdb::byte_vector> conditions;
+};
+
+/* The conditional breakpoints inserted in each process, by process
+   ID and then by placed address.  */
+
+static std::unordered_map<int, std::unordered_map<CORE_ADDR,
+						  linux_nat_cond_breakpoint>>
+  cond_breakpoints;
+
+/* A step over a breakpoint whose conditions are false, in progress in
+   a process.  While it is, the other LWPs of the process are kept
+   stopped, and their events aren't reported to the core.  */
+
+struct cond_step_over
+{
+  /* The LWP stepping over the breakpoint, or NULL if it is gone.  */
+  struct lwp_info *lp;
+
+  /* The address of the breakpoint.  */
+  CORE_ADDR addr;
+
+  /* True once the breakpoint has been taken out of memory and LP is
+     being single-stepped; false while the other LWPs are still being
+     stopped.  */
+  bool stepping;
+};
+
+/* The steps over breakpoints in progress, by process ID.  At most one
+   LWP of each process steps over a breakpoint at a time.  */
+
+static std::unordered_map<int, cond_step_over> cond_step_overs;
+
+/* See linux-nat.h.  */
+
+bool page_protection_watchpoints = false;
+
+static void
+show_page_protection_watchpoints (struct ui_file *file, int from_tty,
+				  struct cmd_list_element *c,
+				  const char *value)
+{
+  fprintf_filtered (file,
+		    _("Watching memory by protecting pages is %s.\n"),
+		    value);
+}
+
+/* A range of memory watched by protecting the pages that hold it.  */
+
+struct page_protection_region
+{
+  CORE_ADDR addr;
+  int len;
+  enum target_hw_bp_type type;
+};
+
+/* A page protected for watchpoints.  */
+
+struct protected_page
+{
+  /* The protection the page had before it was first protected.  */
+  int orig_prot;
+
+  /* The watched regions that overlap the page.  */
+  std::vector<page_protection_region> regions;
+};
+
+/* The pages protected for watchpoints in each process, by process ID
+   and then by page address.  */
+
+static std::unordered_map<int, std::unordered_map<CORE_ADDR, protected_page>>
+  protected_pages;
+
 
 /* LWP accessors.  */
 
@@ -406,19 +571,19 @@ linux_nat_target::post_startup_inferior (ptid_t ptid)
   linux_init_ptrace_procfs (ptid.pid (), 0);
 }
 
+/* Number of known LWPs of each tgid, kept up to date by lwp_list_add
+   and lwp_list_remove.  Looked up on every LWP exit, so it shouldn't
+   take a walk of a list that may hold thousands of LWPs.  */
+static std::unordered_map<int, int> lwp_count_by_pid;
+
 /* Return the number of known LWPs in the tgid given by PID.  */
 
 static int
 num_lwps (int pid)
 {
-  int count = 0;
-  struct lwp_info *lp;
+  auto it = lwp_count_by_pid.find (pid);
 
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (lp->ptid.pid () == pid)
-      count++;
-
-  return count;
+  return it != lwp_count_by_pid.end () ? it->second : 0;
 }
 
 /* Deleter for lwp_info unique_ptr specialisation.  */
@@ -458,7 +623,7 @@ linux_nat_target::follow_fork (int follow_child, int detach_fork)
 
       /* We're already attached to the parent, by default.  */
       child_lp = add_lwp (child_ptid);
-      child_lp->stopped = 1;
+      mark_lwp_stopped (child_lp);
       child_lp->last_resume_kind = resume_stop;
 
       /* Detach new forked process?  */
@@ -535,7 +700,7 @@ linux_nat_target::follow_fork (int follow_child, int detach_fork)
   		fprintf_unfiltered (gdb_stdlog,
   				    "LCFF: waiting for VFORK_DONE on %d\n",
   				    parent_pid);
-	      parent_lp->stopped = 1;
+	      mark_lwp_stopped (parent_lp);
 
 	      /* We'll handle the VFORK_DONE event like any other
 		 event, in target_wait.  */
@@ -586,7 +751,7 @@ linux_nat_target::follow_fork (int follow_child, int detach_fork)
 		 resuming the inferior.  */
 	      parent_lp->status = 0;
 	      parent_lp->waitstatus.kind = TARGET_WAITKIND_VFORK_DONE;
-	      parent_lp->stopped = 1;
+	      mark_lwp_stopped (parent_lp);
 
 	      /* If we're in async mode, need to tell the event loop
 		 there's something here to process.  */
@@ -600,7 +765,7 @@ linux_nat_target::follow_fork (int follow_child, int detach_fork)
       struct lwp_info *child_lp;
 
       child_lp = add_lwp (inferior_ptid);
-      child_lp->stopped = 1;
+      mark_lwp_stopped (child_lp);
       child_lp->last_resume_kind = resume_stop;
 
       /* Let the thread_db layer learn about this new process.  */
@@ -725,6 +890,49 @@ lwp_list_add (struct lwp_info *lp)
   if (lwp_list != NULL)
     lwp_list->prev = lp;
   lwp_list = lp;
+
+  lwp_count_by_pid[lp->ptid.pid ()]++;
+}
+
+/* LWPs that were marked stopped since they were last seen running
+   with no pending status.  linux_nat_wait_1 looks for pending events
+   and stopped-but-resumed LWPs on every wakeup; walking this list
+   instead of all LWPs keeps that proportional to the number of
+   events rather than to the number of threads.  Entries whose LWP
+   was resumed since are dropped lazily, by
+   iterate_over_stopped_lwps.  */
+static std::vector<struct lwp_info *> stopped_lwp_list;
+
+/* Remove LP from the stopped LWPs list, if it is there.  */
+
+static void
+stopped_lwp_list_remove (struct lwp_info *lp)
+{
+  int index = lp->stopped_list_index;
+
+  if (index < 0)
+    return;
+
+  struct lwp_info *last = stopped_lwp_list.back ();
+
+  stopped_lwp_list[index] = last;
+  last->stopped_list_index = index;
+  stopped_lwp_list.pop_back ();
+  lp->stopped_list_index = -1;
+}
+
+/* Mark LP as stopped, and record it in the stopped LWPs list.  */
+
+static void
+mark_lwp_stopped (struct lwp_info *lp)
+{
+  lp->stopped = 1;
+
+  if (lp->stopped_list_index < 0)
+    {
+      lp->stopped_list_index = stopped_lwp_list.size ();
+      stopped_lwp_list.push_back (lp);
+    }
 }
 
 /* Remove LP from sorted-by-reverse-creation-order doubly-linked
@@ -740,6 +948,13 @@ lwp_list_remove (struct lwp_info *lp)
     lp->prev->next = lp->next;
   if (lp == lwp_list)
     lwp_list = lp->next;
+
+  auto it = lwp_count_by_pid.find (lp->ptid.pid ());
+  gdb_assert (it != lwp_count_by_pid.end ());
+  if (--it->second == 0)
+    lwp_count_by_pid.erase (it);
+
+  stopped_lwp_list_remove (lp);
 }
 
 
@@ -872,6 +1087,7 @@ add_initial_lwp (ptid_t ptid)
 
   lp->ptid = ptid;
   lp->core = -1;
+  lp->stopped_list_index = -1;
 
   /* Add to sorted-by-reverse-creation-order list.  */
   lwp_list_add (lp);
@@ -919,6 +1135,9 @@ delete_lwp (ptid_t ptid)
   lp = *(struct lwp_info **) slot;
   gdb_assert (lp != NULL);
 
+  if (lp->cond_step_over)
+    cond_step_overs.at (lp->ptid.pid ()).lp = NULL;
+
   htab_clear_slot (lwp_lwpid_htab, slot);
 
   /* Remove from sorted-by-creation-order list.  */
@@ -956,6 +1175,16 @@ iterate_over_lwps (ptid_t filter,
 {
   struct lwp_info *lp, *lpnext;
 
+  /* A filter naming a single LWP can only match that LWP; look it up
+     instead of walking a list that may hold thousands of LWPs.  */
+  if (filter.lwp_p ())
+    {
+      lp = find_lwp_pid (filter);
+      if (lp != NULL && lp->ptid.matches (filter) && callback (lp) != 0)
+	return lp;
+      return NULL;
+    }
+
   for (lp = lwp_list; lp; lp = lpnext)
     {
       lpnext = lp->next;
@@ -970,6 +1199,49 @@ iterate_over_lwps (ptid_t filter,
   return NULL;
 }
 
+/* Like iterate_over_lwps, but only visit the LWPs that are stopped or
+   have a pending status, relying on an LWP never being resumed with a
+   status pending.  The callback may resume or delete LWPs.  */
+
+static struct lwp_info *
+iterate_over_stopped_lwps
+  (ptid_t filter, gdb::function_view<iterate_over_lwps_ftype> callback)
+{
+  if (filter.lwp_p ())
+    return iterate_over_lwps (filter, callback);
+
+  /* Drop the LWPs that were resumed since they were listed, and take
+     a snapshot of the rest, as the callback may change the list.  */
+  std::vector<ptid_t> ptids;
+  size_t ix = 0;
+
+  while (ix < stopped_lwp_list.size ())
+    {
+      struct lwp_info *lp = stopped_lwp_list[ix];
+
+      if (!lp->stopped && !lwp_status_pending_p (lp))
+	{
+	  /* This moves the last entry to IX.  */
+	  stopped_lwp_list_remove (lp);
+	  continue;
+	}
+
+      if (lp->ptid.matches (filter))
+	ptids.push_back (lp->ptid);
+      ix++;
+    }
+
+  for (const ptid_t &ptid : ptids)
+    {
+      struct lwp_info *lp = find_lwp_pid (ptid);
+
+      if (lp != NULL && callback (lp) != 0)
+	return lp;
+    }
+
+  return NULL;
+}
+
 /* Update our internal state when changing from one checkpoint to
    another indicated by NEW_PTID.  We can only switch single-threaded
    applications, so we only create one new LWP, and the previous list
@@ -983,7 +1255,7 @@ linux_nat_switch_fork (ptid_t new_ptid)
   purge_lwp_list (inferior_ptid.pid ());
 
   lp = add_lwp (new_ptid);
-  lp->stopped = 1;
+  mark_lwp_stopped (lp);
 
   /* This changes the thread's ptid while preserving the gdb thread
      num.  Also changes the inferior pid, while preserving the
@@ -1241,7 +1513,7 @@ linux_nat_target::attach (const char *args, int from_tty)
 		      status, (long) ptid.lwp ());
     }
 
-  lp->stopped = 1;
+  mark_lwp_stopped (lp);
 
   /* Save the wait status to report later.  */
   lp->resumed = 1;
@@ -1473,6 +1745,7 @@ linux_nat_target::detach (inferior *inf, int from_tty)
   /* ... and wait until all of them have reported back that
      they're no longer running.  */
   iterate_over_lwps (ptid_t (pid), stop_wait_callback);
+  cancel_cond_step_overs (ptid_t (pid));
 
   iterate_over_lwps (ptid_t (pid), detach_callback);
 
@@ -1535,6 +1808,8 @@ linux_resume_one_lwp_throw (struct lwp_info *lp, int step,
   lp->stopped = 0;
   lp->core = -1;
   lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+  lp->cond_false = 0;
+  lp->page_protection_fault = 0;
   registers_changed_ptid (lp->ptid);
 }
 
@@ -1603,6 +1878,8 @@ resume_lwp (struct lwp_info *lp, int step, enum gdb_signal signo)
 				"RC: Not resuming %s (vfork parent)\n",
 				target_pid_to_str (lp->ptid).c_str ());
 	}
+      else if (cond_step_over_holds_p (lp))
+	hold_lwp (lp, step, signo);
       else if (!lwp_status_pending_p (lp))
 	{
 	  if (debug_linux_nat)
@@ -1770,7 +2047,10 @@ linux_nat_target::resume (ptid_t ptid, int step, enum gdb_signal signo)
 			(signo != GDB_SIGNAL_0
 			 ? strsignal (gdb_signal_to_host (signo)) : "0"));
 
-  linux_resume_one_lwp (lp, step, signo);
+  if (cond_step_over_holds_p (lp))
+    hold_lwp (lp, step, signo);
+  else
+    linux_resume_one_lwp (lp, step, signo);
 
   if (target_can_async_p ())
     target_async (1);
@@ -1973,6 +2253,17 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
 	  linux_target->low_new_fork (lp, new_pid);
 	}
 
+      /* A forked child inherits the protection of its parent's pages,
+	 which GDB removes along with the other watchpoints before
+	 detaching it.  A vfork child shares the parent's pages.  */
+      if (event == PTRACE_EVENT_FORK)
+	{
+	  auto it = protected_pages.find (lp->ptid.pid ());
+
+	  if (it != protected_pages.end ())
+	    protected_pages[new_pid] = it->second;
+	}
+
       if (event == PTRACE_EVENT_FORK
 	  && linux_fork_checkpointing_p (lp->ptid.pid ()))
 	{
@@ -2014,7 +2305,7 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
 				pid, new_pid);
 
 	  new_lp = add_lwp (ptid_t (lp->ptid.pid (), new_pid, 0));
-	  new_lp->stopped = 1;
+	  mark_lwp_stopped (new_lp);
 	  new_lp->resumed = 1;
 
 	  /* If the thread_db layer is active, let it record the user
@@ -2081,6 +2372,11 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
       ourstatus->value.execd_pathname
 	= xstrdup (linux_proc_pid_to_exec_file (pid));
 
+      /* The breakpoints and watchpoints went away with the old
+	 program.  */
+      cond_breakpoints.erase (pid);
+      protected_pages.erase (pid);
+
       /* The thread that execed must have been resumed, but, when a
 	 thread execs, it changes its tid to the tgid, and the old
 	 tgid thread might have not been resumed.  */
@@ -2252,7 +2548,7 @@ wait_lwp (struct lwp_info *lp)
     }
 
   gdb_assert (WIFSTOPPED (status));
-  lp->stopped = 1;
+  mark_lwp_stopped (lp);
 
   if (lp->must_set_ptrace_flags)
     {
@@ -2347,6 +2643,8 @@ linux_stop_and_wait_all_lwps (void)
   /* ... and wait until all of them have reported back that
      they're no longer running.  */
   iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+
+  cancel_cond_step_overs (minus_one_ptid);
 }
 
 /* See linux-nat.h  */
@@ -2470,6 +2768,20 @@ linux_nat_target::stopped_data_address (CORE_ADDR *addr_p)
   return lp->stopped_data_address_p;
 }
 
+/* Implement the "stopped_by_nonsteppable_watchpoint" target method.
+   Faults in pages protected for watchpoints happen before the access
+   is made.  */
+
+bool
+linux_nat_target::stopped_by_nonsteppable_watchpoint ()
+{
+  struct lwp_info *lp = find_lwp_pid (inferior_ptid);
+
+  gdb_assert (lp != NULL);
+
+  return lp->page_protection_fault;
+}
+
 /* Commonly any breakpoint / watchpoint generate only SIGTRAP.  */
 
 bool
@@ -2518,7 +2830,17 @@ stop_wait_callback (struct lwp_info *lp)
 
       maybe_clear_ignore_sigint (lp);
 
-      if (WSTOPSIG (status) != SIGSTOP)
+      if (WSTOPSIG (status) == SIGSEGV
+	  && page_protection_fault_p (lp, NULL))
+	{
+	  /* The faulting access is retried when the thread is
+	     resumed, and handled then.  */
+	  if (debug_linux_nat)
+	    fprintf_unfiltered (gdb_stdlog,
+				"SWC: Discarding page protection fault in %s\n",
+				target_pid_to_str (lp->ptid).c_str ());
+	}
+      else if (WSTOPSIG (status) != SIGSTOP)
 	{
 	  /* The thread was stopped with a signal other than SIGSTOP.  */
 
@@ -2532,6 +2854,20 @@ stop_wait_callback (struct lwp_info *lp)
 	  lp->status = status;
 	  gdb_assert (lp->signalled);
 	  save_stop_reason (lp);
+
+	  /* Unless it's the hit of a breakpoint whose conditions are
+	     false; the LWP hits the breakpoint again when resumed,
+	     and is stepped over it then.  */
+	  if (breakpoint_conditions_false_p (lp))
+	    {
+	      if (can_step_over_cond_breakpoint_p (lp))
+		{
+		  lp->status = 0;
+		  lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+		}
+	      else
+		lp->cond_false = 1;
+	    }
 	}
       else
 	{
@@ -2573,6 +2909,10 @@ status_callback (struct lwp_info *lp)
   if (!lwp_status_pending_p (lp))
     return 0;
 
+  /* Nor while another LWP of the process steps over a breakpoint.  */
+  if (cond_step_over_in_progress_p (lp->ptid.pid ()))
+    return 0;
+
   if (lp->stop_reason == TARGET_STOPPED_BY_SW_BREAKPOINT
       || lp->stop_reason == TARGET_STOPPED_BY_HW_BREAKPOINT)
     {
@@ -2593,6 +2933,22 @@ status_callback (struct lwp_info *lp)
 	  discard = 1;
 	}
 
+      /* The breakpoint's conditions were false, and the LWP was
+	 kept stopped with the hit pending.  Have it hit the
+	 breakpoint again, for linux_nat_filter_event to step it
+	 over.  */
+      else if (lp->stop_reason == TARGET_STOPPED_BY_SW_BREAKPOINT
+	       && !lp->cond_false
+	       && lp->last_resume_kind == resume_continue
+	       && breakpoint_conditions_false_p (lp))
+	{
+	  if (debug_linux_nat)
+	    fprintf_unfiltered (gdb_stdlog,
+				"SC: breakpoint conditions false for %s\n",
+				target_pid_to_str (lp->ptid).c_str ());
+	  discard = 1;
+	}
+
 #if !USE_SIGTRAP_SIGINFO
       else if (!breakpoint_inserted_here_p (regcache->aspace (), pc))
 	{
@@ -2629,8 +2985,10 @@ count_events_callback (struct lwp_info *lp, int *count)
 {
   gdb_assert (count != NULL);
 
-  /* Select only resumed LWPs that have an event pending.  */
-  if (lp->resumed && lwp_status_pending_p (lp))
+  /* Select only resumed LWPs that have an event pending, and that
+     status_callback would report.  */
+  if (lp->resumed && lwp_status_pending_p (lp)
+      && !cond_step_over_in_progress_p (lp->ptid.pid ()))
     (*count)++;
 
   return 0;
@@ -2666,8 +3024,10 @@ select_event_lwp_callback (struct lwp_info *lp, int *selector)
 {
   gdb_assert (selector != NULL);
 
-  /* Select only resumed LWPs that have an event pending.  */
-  if (lp->resumed && lwp_status_pending_p (lp))
+  /* Select only resumed LWPs that have an event pending, and that
+     status_callback would report.  */
+  if (lp->resumed && lwp_status_pending_p (lp)
+      && !cond_step_over_in_progress_p (lp->ptid.pid ()))
     if ((*selector)-- == 0)
       return 1;
 
@@ -2923,85 +3283,998 @@ resumed_callback (struct lwp_info *lp)
   return lp->resumed;
 }
 
-/* Check if we should go on and pass this event to common code.
-   Return the affected lwp if we are, or NULL otherwise.  */
+/* ax_eval_context that reads the registers and memory of a stopped
+   LWP.  */
 
-static struct lwp_info *
-linux_nat_filter_event (int lwpid, int status)
+class lwp_ax_eval_context : public ax_eval_context
 {
-  struct lwp_info *lp;
-  int event = linux_ptrace_get_extended_event (status);
+public:
+  lwp_ax_eval_context (struct lwp_info *lp, struct regcache *regcache)
+    : m_lp (lp), m_regcache (regcache)
+  {}
 
-  lp = find_lwp_pid (ptid_t (lwpid));
+  bool read_register (int regnum, ULONGEST *val) override
+  {
+    struct gdbarch *gdbarch = m_regcache->arch ();
 
-  /* Check for stop events reported by a process we didn't already
-     know about - anything not already in our LWP list.
+    for (int i = 0; i < gdbarch_num_regs (gdbarch); i++)
+      if (gdbarch_remote_register_number (gdbarch, i) == regnum)
+	return (register_size (gdbarch, i) <= sizeof (ULONGEST)
+		&& m_regcache->raw_read (i, val) == REG_VALID);
+    return false;
+  }
 
-     If we're expecting to receive stopped processes after
-     fork, vfork, and clone events, then we'll just add the
-     new one to our list and go back to waiting for the event
-     to be reported - the stopped process might be returned
-     from waitpid before or after the event is.
+  bool read_memory (CORE_ADDR addr, gdb_byte *buf, int len) override
+  {
+    scoped_restore save_inferior_ptid
+      = make_scoped_restore (&inferior_ptid, m_lp->ptid);
 
-     But note the case of a non-leader thread exec'ing after the
-     leader having exited, and gone from our lists.  The non-leader
-     thread changes its tid to the tgid.  */
+    return target_read (linux_target, TARGET_OBJECT_MEMORY, NULL,
+			buf, addr, len) == len;
+  }
 
-  if (WIFSTOPPED (status) && lp == NULL
-      && (WSTOPSIG (status) == SIGTRAP && event == PTRACE_EVENT_EXEC))
+private:
+  struct lwp_info *m_lp;
+  struct regcache *m_regcache;
+};
+
+/* Return true if LP reported the hit of a software breakpoint with
+   target-side conditions, and they are all false.  */
+
+static bool
+breakpoint_conditions_false_p (struct lwp_info *lp)
+{
+  /* Only bother for LWPs that were continued, or that the core wants
+     stopped.  If the core was stepping the LWP, it wants to hear
+     about the hit either way.  */
+  if (lp->stop_reason != TARGET_STOPPED_BY_SW_BREAKPOINT
+      || lp->step
+      || lp->last_resume_kind == resume_step)
+    return false;
+
+  auto proc = cond_breakpoints.find (lp->ptid.pid ());
+  if (proc == cond_breakpoints.end ())
+    return false;
+  auto it = proc->second.find (lp->stop_pc);
+  if (it == proc->second.end ())
+    return false;
+  linux_nat_cond_breakpoint &bp = it->second;
+
+  try
     {
-      /* A multi-thread exec after we had seen the leader exiting.  */
-      if (debug_linux_nat)
-	fprintf_unfiltered (gdb_stdlog,
-			    "LLW: Re-adding thread group leader LWP %d.\n",
-			    lwpid);
+      struct regcache *regcache = get_thread_regcache (lp->ptid);
+      lwp_ax_eval_context context (lp, regcache);
 
-      lp = add_lwp (ptid_t (lwpid, lwpid, 0));
-      lp->stopped = 1;
-      lp->resumed = 1;
-      add_thread (lp->ptid);
+      for (const gdb::byte_vector &cond : bp.conditions)
+	{
+	  ULONGEST value;
+
+	  /* If a condition can't be evaluated here, let GDB evaluate
+	     it.  */
+	  if (!ax_eval (bp.gdbarch, cond.data (), cond.size (), &context,
+			&value)
+	      || value != 0)
+	    return false;
+	}
     }
-
-  if (WIFSTOPPED (status) && !lp)
+  catch (const gdb_exception_error &ex)
     {
-      if (debug_linux_nat)
-	fprintf_unfiltered (gdb_stdlog,
-			    "LHEW: saving LWP %ld status %s in stopped_pids list\n",
-			    (long) lwpid, status_to_str (status));
-      add_to_pid_list (&stopped_pids, lwpid, status);
-      return NULL;
+      return false;
     }
 
-  /* Make sure we don't report an event for the exit of an LWP not in
-     our list, i.e. not part of the current process.  This can happen
-     if we detach from a program we originally forked and then it
-     exits.  */
-  if (!WIFSTOPPED (status) && !lp)
-    return NULL;
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNFE: conditions false for %s at %s\n",
+			target_pid_to_str (lp->ptid).c_str (),
+			paddress (bp.gdbarch, lp->stop_pc));
+  return true;
+}
 
-  /* This LWP is stopped now.  (And if dead, this prevents it from
-     ever being continued.)  */
-  lp->stopped = 1;
+/* Return true if an LWP of process PID is stepping over a breakpoint
+   whose conditions are false.  */
 
-  if (WIFSTOPPED (status) && lp->must_set_ptrace_flags)
+static bool
+cond_step_over_in_progress_p (int pid)
+{
+  return (!cond_step_overs.empty ()
+	  && cond_step_overs.find (pid) != cond_step_overs.end ());
+}
+
+/* Return true if LP must be kept stopped, although the core resumed
+   it, because another LWP of its process is stepping over a
+   breakpoint.  */
+
+static bool
+cond_step_over_holds_p (struct lwp_info *lp)
+{
+  if (cond_step_overs.empty ())
+    return false;
+
+  auto it = cond_step_overs.find (lp->ptid.pid ());
+  return it != cond_step_overs.end () && it->second.lp != lp;
+}
+
+/* Write BUF at ADDR in process PID.  Return true on success.  This
+   writes raw memory: a TARGET_OBJECT_MEMORY write would be treated as
+   a user write under GDB's inserted breakpoints, and so would update
+   their shadows instead of memory.  */
+
+static bool
+cond_step_over_write_memory (int pid, CORE_ADDR addr,
+			     const gdb::byte_vector &buf)
+{
+  scoped_restore save_inferior_ptid
+    = make_scoped_restore (&inferior_ptid, ptid_t (pid));
+
+  return (target_write (linux_target, TARGET_OBJECT_RAW_MEMORY, NULL,
+			buf.data (), addr, buf.size ())
+	  == (LONGEST) buf.size ());
+}
+
+/* Resume LP, which was kept stopped by a step over a breakpoint in its
+   process, as the core last asked for.  */
+
+static int
+release_held_lwp (struct lwp_info *lp)
+{
+  if (lp->stopped && lp->resumed && !lwp_status_pending_p (lp))
     {
-      struct inferior *inf = find_inferior_pid (lp->ptid.pid ());
-      int options = linux_nat_ptrace_options (inf->attach_flag);
+      struct thread_info *thread = find_thread_ptid (lp->ptid);
+      enum gdb_signal signo = GDB_SIGNAL_0;
 
-      linux_enable_event_reporting (lp->ptid.lwp (), options);
-      lp->must_set_ptrace_flags = 0;
+      /* See hold_lwp.  */
+      if (thread != NULL)
+	{
+	  signo = thread->suspend.stop_signal;
+	  thread->suspend.stop_signal = GDB_SIGNAL_0;
+	}
+
+      resume_lwp (lp, lp->step, signo);
     }
 
-  /* Handle GNU/Linux's syscall SIGTRAPs.  */
-  if (WIFSTOPPED (status) && WSTOPSIG (status) == SYSCALL_SIGTRAP)
+  return 0;
+}
+
+/* End the step over a breakpoint in process PID: put the breakpoint
+   back in memory if it was taken out, and, if RELEASE, resume the
+   LWPs the core had resumed, other than the one that stepped.  */
+
+static void
+end_cond_step_over (int pid, bool release)
+{
+  auto it = cond_step_overs.find (pid);
+  gdb_assert (it != cond_step_overs.end ());
+  cond_step_over step_over = it->second;
+  cond_step_overs.erase (it);
+
+  if (step_over.stepping)
     {
-      /* No longer need the sysgood bit.  The ptrace event ends up
-	 recorded in lp->waitstatus if we care for it.  We can carry
-	 on handling the event like a regular SIGTRAP from here
-	 on.  */
-      status = W_STOPCODE (SIGTRAP);
-      if (linux_handle_syscall_trap (lp, 0))
-	return NULL;
+      /* Unless GDB removed or replaced the breakpoint meanwhile.  */
+      auto proc = cond_breakpoints.find (pid);
+      if (proc != cond_breakpoints.end ())
+	{
+	  auto bp = proc->second.find (step_over.addr);
+
+	  if (bp != proc->second.end ()
+	      && !cond_step_over_write_memory (pid, step_over.addr,
+					       bp->second.insn))
+	    warning (_("Failed to reinsert breakpoint at %s."),
+		     paddress (bp->second.gdbarch, step_over.addr));
+	}
+    }
+
+  if (step_over.lp != NULL)
+    {
+      step_over.lp->cond_step_over = 0;
+      /* The core had continued the LWP.  */
+      step_over.lp->step = 0;
+    }
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNSO: step over %s done in process %d\n",
+			core_addr_to_string (step_over.addr), pid);
+
+  if (release)
+    iterate_over_lwps (ptid_t (pid), [&] (struct lwp_info *lp)
+      {
+	if (lp != step_over.lp)
+	  release_held_lwp (lp);
+	return 0;
+      });
+}
+
+/* Move the step over a breakpoint in process PID forward: once all
+   the other LWPs of the process are stopped, take the breakpoint out
+   of memory and single-step the LWP over it.  The LWPs report their
+   stops through linux_nat_filter_event as usual, so nothing here
+   waits.  */
+
+static void
+advance_cond_step_over (int pid)
+{
+  cond_step_over &step_over = cond_step_overs.at (pid);
+  struct lwp_info *lp = step_over.lp;
+
+  /* Give up if the LWP is gone, or the core asked it to stop.  */
+  if (lp == NULL || lwp_status_pending_p (lp))
+    {
+      end_cond_step_over (pid, true);
+      return;
+    }
+
+  /* Stop the other LWPs, including any that appeared since the step
+     over started, and wait for them all to report.  */
+  struct lwp_info *running
+    = iterate_over_lwps (ptid_t (pid), [=] (struct lwp_info *other)
+	{
+	  if (other == lp)
+	    return 0;
+	  stop_callback (other);
+	  return other->stopped ? 0 : 1;
+	});
+
+  if (step_over.stepping)
+    {
+      /* A clone event leaves the LWP stopped mid-step.  */
+      if (lp->stopped)
+	linux_resume_one_lwp (lp, 1, GDB_SIGNAL_0);
+      return;
+    }
+
+  if (running != NULL)
+    return;
+
+  /* The breakpoint may have been removed meanwhile; then there is
+     nothing to step over.  */
+  auto proc = cond_breakpoints.find (pid);
+  if (proc == cond_breakpoints.end ())
+    {
+      end_cond_step_over (pid, true);
+      resume_lwp (lp, 0, GDB_SIGNAL_0);
+      return;
+    }
+  auto bp = proc->second.find (step_over.addr);
+  if (bp == proc->second.end ()
+      || !cond_step_over_write_memory (pid, step_over.addr,
+				       bp->second.shadow))
+    {
+      end_cond_step_over (pid, true);
+      resume_lwp (lp, 0, GDB_SIGNAL_0);
+      return;
+    }
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNSO: stepping %s over %s\n",
+			target_pid_to_str (lp->ptid).c_str (),
+			paddress (bp->second.gdbarch, step_over.addr));
+
+  step_over.stepping = true;
+  linux_resume_one_lwp (lp, 1, GDB_SIGNAL_0);
+
+  /* The LWP vanished.  */
+  if (lp->stopped)
+    end_cond_step_over (pid, true);
+}
+
+/* Advance the steps over breakpoints in progress, once the events the
+   kernel had for us have all been handled.  */
+
+static void
+advance_cond_step_overs ()
+{
+  std::vector<int> pids;
+
+  for (const auto &it : cond_step_overs)
+    pids.push_back (it.first);
+
+  for (int pid : pids)
+    if (cond_step_over_in_progress_p (pid))
+      advance_cond_step_over (pid);
+}
+
+/* Return true if LP, at a breakpoint whose conditions are false, can
+   be stepped over it by start_cond_step_over.  That needs hardware
+   single-step, and a process that doesn't share its memory with a
+   vfork parent or child.  */
+
+static bool
+can_step_over_cond_breakpoint_p (struct lwp_info *lp)
+{
+  struct inferior *inf = find_inferior_ptid (lp->ptid);
+  struct gdbarch *gdbarch = get_thread_regcache (lp->ptid)->arch ();
+
+  return (!gdbarch_software_single_step_p (gdbarch)
+	  && inf->vfork_child == NULL
+	  && inf->vfork_parent == NULL);
+}
+
+/* LP hit a software breakpoint whose conditions are all false.  Step
+   it over the breakpoint, without telling the core, as gdbserver's
+   linux-low does: stop the other LWPs of the process, take the
+   breakpoint out, single-step LP, put the breakpoint back and resume
+   all the LWPs.  If another LWP of the process is already stepping
+   over a breakpoint, LP just waits with the others, and hits the
+   breakpoint again once resumed.  */
+
+static void
+start_cond_step_over (struct lwp_info *lp)
+{
+  int pid = lp->ptid.pid ();
+
+  lp->status = 0;
+  lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+
+  if (cond_step_over_in_progress_p (pid))
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LNSO: %s waits for another step over\n",
+			    target_pid_to_str (lp->ptid).c_str ());
+      return;
+    }
+
+  cond_step_overs[pid] = { lp, lp->stop_pc, false };
+  lp->cond_step_over = 1;
+  advance_cond_step_over (pid);
+}
+
+/* Stop all the steps over breakpoints in progress for the LWPs
+   matching FILTER, which the caller has all just stopped, without
+   resuming anything.  A step that completed is kept, otherwise the
+   LWP is left at the breakpoint.  */
+
+static void
+cancel_cond_step_overs (ptid_t filter)
+{
+  std::vector<int> pids;
+
+  for (const auto &it : cond_step_overs)
+    if (ptid_t (it.first).matches (filter))
+      pids.push_back (it.first);
+
+  for (int pid : pids)
+    {
+      struct lwp_info *lp = cond_step_overs.at (pid).lp;
+
+      if (lp != NULL
+	  && cond_step_overs.at (pid).stepping
+	  && lp->status == W_STOPCODE (SIGTRAP)
+	  && lp->stop_reason == TARGET_STOPPED_BY_NO_REASON)
+	{
+	  lp->status = 0;
+	  lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+	}
+
+      end_cond_step_over (pid, false);
+    }
+}
+
+/* Hold LP, which the core is resuming with STEP and SIGNO while
+   another LWP of its process steps over a breakpoint.
+   release_held_lwp resumes it later.  */
+
+static void
+hold_lwp (struct lwp_info *lp, int step, enum gdb_signal signo)
+{
+  struct thread_info *thread = find_thread_ptid (lp->ptid);
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNSO: holding %s until a step over is done\n",
+			target_pid_to_str (lp->ptid).c_str ());
+
+  lp->step = step;
+  /* Keep the signal where release_held_lwp looks for it, as
+     linux_nat_resume_callback does.  */
+  if (thread != NULL)
+    thread->suspend.stop_signal = signo;
+}
+
+/* A mapping of a process, as listed in /proc/PID/maps.  */
+
+struct linux_proc_mapping
+{
+  CORE_ADDR start;
+  CORE_ADDR end;
+
+  /* The PROT_* flags of the mapping.  */
+  int prot;
+};
+
+/* Return the mappings of process PID, read from /proc/PID/maps, in
+   ascending address order.  */
+
+static std::vector<linux_proc_mapping>
+linux_proc_mappings (int pid)
+{
+  std::vector<linux_proc_mapping> mappings;
+  char buffer[PATH_MAX], fname[PATH_MAX];
+  bool line_start = true;
+
+  xsnprintf (fname, sizeof fname, "/proc/%d/maps", pid);
+  gdb_file_up procfile = gdb_fopen_cloexec (fname, "r");
+  if (procfile == NULL)
+    return mappings;
+
+  while (fgets (buffer, sizeof buffer, procfile.get ()) != NULL)
+    {
+      bool this_line_start = line_start;
+      const char *p = buffer;
+
+      /* Skip the rest of lines too long for BUFFER.  */
+      line_start = strchr (buffer, '\n') != NULL;
+      if (!this_line_start)
+	continue;
+
+      ULONGEST start = strtoulst (p, &p, 16);
+      if (*p != '-')
+	continue;
+      ULONGEST end = strtoulst (p + 1, &p, 16);
+      p = skip_spaces (p);
+
+      if (strlen (p) < 3)
+	continue;
+
+      int prot = ((p[0] == 'r' ? PROT_READ : 0)
+		  | (p[1] == 'w' ? PROT_WRITE : 0)
+		  | (p[2] == 'x' ? PROT_EXEC : 0));
+      mappings.push_back ({ start, end, prot });
+    }
+
+  return mappings;
+}
+
+/* Return the protection of the page at ADDR in MAPPINGS, or -1 if the
+   page isn't mapped.  */
+
+static int
+mapping_prot (const std::vector<linux_proc_mapping> &mappings,
+	      CORE_ADDR addr)
+{
+  auto it = std::upper_bound (mappings.begin (), mappings.end (), addr,
+			      [] (CORE_ADDR a, const linux_proc_mapping &m)
+			      {
+				return a < m.end;
+			      });
+
+  if (it == mappings.end () || addr < it->start)
+    return -1;
+  return it->prot;
+}
+
+/* See linux-nat.h.  */
+
+int
+linux_proc_page_prot (int pid, CORE_ADDR addr)
+{
+  return mapping_prot (linux_proc_mappings (pid), addr);
+}
+
+/* See linux-nat.h.  */
+
+bool
+page_protection_region_ok_p (CORE_ADDR addr, int len)
+{
+  CORE_ADDR page_size = getpagesize ();
+
+  if (len <= 0)
+    return false;
+
+  CORE_ADDR first = addr & ~(page_size - 1);
+  CORE_ADDR last = (addr + len - 1) & ~(page_size - 1);
+  return (last - first) / page_size < PAGE_PROTECTION_MAX_PAGES;
+}
+
+/* Return the protection PAGE must have for its watched regions.  */
+
+static int
+protected_page_prot (const protected_page &page)
+{
+  int prot = page.orig_prot;
+
+  for (const page_protection_region &region : page.regions)
+    {
+      /* Reads can't be trapped without trapping writes too.  */
+      if (region.type == hw_write)
+	prot &= ~PROT_WRITE;
+      else
+	prot = PROT_NONE;
+    }
+
+  return prot;
+}
+
+/* Return the ID of a stopped LWP of process PID, to run mprotect in,
+   or -1 if there is none.  */
+
+static int
+page_protection_lwpid (int pid)
+{
+  struct lwp_info *lp
+    = iterate_over_lwps (ptid_t (pid), [] (struct lwp_info *lwp)
+			 {
+			   return lwp->stopped;
+			 });
+
+  if (lp != NULL)
+    return lp->ptid.lwp ();
+
+  /* A fork child that GDB doesn't follow has no LWP, but is stopped
+     until GDB detaches it.  */
+  if (find_lwp_pid (ptid_t (pid)) == NULL)
+    return pid;
+
+  return -1;
+}
+
+/* A run of consecutive pages whose protection changes from OLD_PROT
+   to NEW_PROT.  */
+
+struct page_prot_change
+{
+  CORE_ADDR start;
+  CORE_ADDR len;
+  int old_prot;
+  int new_prot;
+};
+
+/* Record in CHANGES that the protection of PAGE changes from OLD_PROT
+   to NEW_PROT, extending the last run if possible.  Pages must be
+   recorded in ascending order.  */
+
+static void
+add_page_prot_change (std::vector<page_prot_change> &changes,
+		      CORE_ADDR page, int old_prot, int new_prot)
+{
+  if (old_prot == new_prot)
+    return;
+
+  if (!changes.empty ())
+    {
+      page_prot_change &last = changes.back ();
+
+      if (last.start + last.len == page
+	  && last.old_prot == old_prot && last.new_prot == new_prot)
+	{
+	  last.len += getpagesize ();
+	  return;
+	}
+    }
+
+  changes.push_back ({ page, (CORE_ADDR) getpagesize (), old_prot,
+		       new_prot });
+}
+
+/* Make LWPID change the protection of the LEN bytes of pages at START
+   to PROT.  */
+
+static bool
+protect_pages (int lwpid, CORE_ADDR start, CORE_ADDR len, int prot)
+{
+  bool ok = linux_target->low_inferior_mprotect (lwpid, start, len, prot);
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"PPW: mprotect (%s, %s, %d) in %d: %s\n",
+			core_addr_to_string (start), pulongest (len), prot,
+			lwpid, ok ? "OK" : "failed");
+  return ok;
+}
+
+/* See linux-nat.h.  */
+
+int
+linux_nat_target::insert_page_protection_watchpoint
+  (CORE_ADDR addr, int len, enum target_hw_bp_type type)
+{
+  int pid = inferior_ptid.pid ();
+  CORE_ADDR page_size = getpagesize ();
+
+  if (!page_protection_watchpoints || !page_protection_region_ok_p (addr, len))
+    return 1;
+
+  int lwpid = page_protection_lwpid (pid);
+  if (lwpid == -1)
+    return 1;
+
+  auto &pages = protected_pages[pid];
+  page_protection_region region = { addr, len, type };
+  CORE_ADDR first = addr & ~(page_size - 1);
+  CORE_ADDR last = (addr + len - 1) & ~(page_size - 1);
+  std::vector<linux_proc_mapping> mappings;
+  std::vector<page_prot_change> changes;
+  CORE_ADDR page;
+
+  for (page = first; page <= last; page += page_size)
+    {
+      auto it = pages.find (page);
+      int old_prot;
+
+      if (it == pages.end ())
+	{
+	  /* Read the mappings once for the whole range.  */
+	  if (mappings.empty ())
+	    mappings = linux_proc_mappings (pid);
+	  old_prot = mapping_prot (mappings, page);
+	  if (old_prot == -1)
+	    break;
+	  it = pages.emplace (page, protected_page { old_prot, {} }).first;
+	}
+      else
+	old_prot = protected_page_prot (it->second);
+
+      it->second.regions.push_back (region);
+      add_page_prot_change (changes, page, old_prot,
+			    protected_page_prot (it->second));
+    }
+
+  auto change = changes.begin ();
+  if (page > last)
+    {
+      for (; change != changes.end (); ++change)
+	if (!protect_pages (lwpid, change->start, change->len,
+			    change->new_prot))
+	  break;
+    }
+
+  if (page <= last || change != changes.end ())
+    {
+      /* Undo the changes done so far.  */
+      for (auto done = changes.begin (); done != change; ++done)
+	protect_pages (lwpid, done->start, done->len, done->old_prot);
+      for (CORE_ADDR p = first; p < page; p += page_size)
+	{
+	  auto it = pages.find (p);
+	  it->second.regions.pop_back ();
+	  if (it->second.regions.empty ())
+	    pages.erase (it);
+	}
+      if (pages.empty ())
+	protected_pages.erase (pid);
+      return 1;
+    }
+
+  return 0;
+}
+
+/* See linux-nat.h.  */
+
+int
+linux_nat_target::remove_page_protection_watchpoint
+  (CORE_ADDR addr, int len, enum target_hw_bp_type type)
+{
+  int pid = inferior_ptid.pid ();
+  CORE_ADDR page_size = getpagesize ();
+  std::vector<page_prot_change> changes;
+  bool found = false;
+
+  auto proc = protected_pages.find (pid);
+  if (proc == protected_pages.end () || len <= 0)
+    return 1;
+
+  auto &pages = proc->second;
+  CORE_ADDR first = addr & ~(page_size - 1);
+  CORE_ADDR last = (addr + len - 1) & ~(page_size - 1);
+
+  for (CORE_ADDR page = first; page <= last; page += page_size)
+    {
+      auto it = pages.find (page);
+      if (it == pages.end ())
+	continue;
+
+      std::vector<page_protection_region> &regions = it->second.regions;
+      auto region = std::find_if (regions.begin (), regions.end (),
+				  [&] (const page_protection_region &r)
+				  {
+				    return (r.addr == addr && r.len == len
+					    && r.type == type);
+				  });
+      if (region == regions.end ())
+	continue;
+
+      found = true;
+      int old_prot = protected_page_prot (it->second);
+      regions.erase (region);
+      add_page_prot_change (changes, page, old_prot,
+			    protected_page_prot (it->second));
+      if (regions.empty ())
+	pages.erase (it);
+    }
+
+  int lwpid = page_protection_lwpid (pid);
+  if (lwpid != -1)
+    for (const page_prot_change &change : changes)
+      protect_pages (lwpid, change.start, change.len, change.new_prot);
+
+  if (pages.empty ())
+    protected_pages.erase (proc);
+
+  return found ? 0 : 1;
+}
+
+/* Return true if LP stopped with a SIGSEGV caused by a page protected
+   for watchpoints, and store the faulting address in *FAULT_ADDR if
+   it isn't NULL.  */
+
+static bool
+page_protection_fault_p (struct lwp_info *lp, CORE_ADDR *fault_addr)
+{
+  siginfo_t siginfo;
+
+  auto proc = protected_pages.find (lp->ptid.pid ());
+  if (proc == protected_pages.end ())
+    return false;
+
+  if (!linux_nat_get_siginfo (lp->ptid, &siginfo)
+      || siginfo.si_signo != SIGSEGV
+      || siginfo.si_code != SEGV_ACCERR)
+    return false;
+
+  CORE_ADDR addr = (CORE_ADDR) (uintptr_t) siginfo.si_addr;
+  CORE_ADDR page = addr & ~((CORE_ADDR) getpagesize () - 1);
+  if (proc->second.find (page) == proc->second.end ())
+    return false;
+
+  if (fault_addr != NULL)
+    *fault_addr = addr;
+  return true;
+}
+
+/* Return true if SIGINFO describes a fault raised by the kernel for
+   the instruction the LWP was running, rather than a signal sent to
+   it.  */
+
+static bool
+synchronous_fault_p (const siginfo_t &siginfo)
+{
+  switch (siginfo.si_signo)
+    {
+    case SIGSEGV:
+    case SIGBUS:
+    case SIGILL:
+    case SIGFPE:
+      return siginfo.si_code > 0;
+    default:
+      return false;
+    }
+}
+
+/* Single-step LWPID, which GDB doesn't track as an LWP, e.g. a fork
+   child being detached, and return its wait status.  */
+
+static int
+step_untracked_lwp (int lwpid)
+{
+  int status;
+
+  if (ptrace (PTRACE_SINGLESTEP, lwpid, 0, 0) != 0
+      || my_waitpid (lwpid, &status, __WALL) != lwpid)
+    return 0;
+  return status;
+}
+
+/* See linux-nat.h.  */
+
+bool
+linux_nat_step_injected_lwp (int lwpid)
+{
+  struct lwp_info *lp = find_lwp_pid (ptid_t (lwpid));
+  std::vector<int> signals;
+  bool stepped = false;
+
+  /* Events other than the step's are left pending in LP, for
+     linux_nat_wait_1 to report as usual; hide the one it may already
+     have meanwhile.  */
+  int pending_status = 0;
+  if (lp != NULL)
+    {
+      pending_status = lp->status;
+      lp->status = 0;
+    }
+
+  for (;;)
+    {
+      int status;
+
+      if (lp == NULL)
+	status = step_untracked_lwp (lwpid);
+      else
+	{
+	  if (ptrace (PTRACE_SINGLESTEP, lwpid, 0, 0) != 0)
+	    break;
+	  lp->stopped = 0;
+	  status = wait_lwp (lp);
+	  /* wait_lwp deletes LP if it exited.  */
+	  lp = find_lwp_pid (ptid_t (lwpid));
+	}
+
+      if (status == 0 || !WIFSTOPPED (status))
+	break;
+
+      if (WSTOPSIG (status) == SIGTRAP)
+	{
+	  stepped = true;
+	  break;
+	}
+
+      siginfo_t siginfo;
+      if (linux_nat_get_siginfo (ptid_t (lwpid, lwpid, 0), &siginfo)
+	  && synchronous_fault_p (siginfo))
+	{
+	  /* The injected instruction itself faulted, e.g. because its
+	     page isn't executable.  Stepping again would fault again.
+	     The fault is the caller's doing, and goes away when it
+	     restores the LWP's registers: don't report it.  */
+	  if (debug_linux_nat)
+	    fprintf_unfiltered (gdb_stdlog,
+				"LNSIL: injected instruction faulted in %d "
+				"with signal %d at %s\n",
+				lwpid, siginfo.si_signo,
+				host_address_to_string (siginfo.si_addr));
+	  break;
+	}
+
+      /* A signal arrived before the step; the instruction hasn't run
+	 yet.  */
+      signals.push_back (WSTOPSIG (status));
+    }
+
+  if (lp != NULL)
+    {
+      lp->status = pending_status;
+      if (lwp_status_pending_p (lp) && target_is_async_p ())
+	async_file_mark ();
+    }
+
+  /* Raise the signals again, for the LWP to report them normally
+     once it is resumed.  */
+  for (int signo : signals)
+    kill_lwp (lwpid, signo);
+
+  return stepped;
+}
+
+/* The largest access a single instruction makes, other than string
+   instructions, which fault again for each element.  */
+#define MAX_ACCESS_SIZE 64
+
+/* Make LP, which faulted at FAULT_ADDR in a page protected for
+   watchpoints, report a watchpoint trigger instead.  The faulting
+   instruction didn't run; infrun steps LP over it with the
+   watchpoints removed, that is, with the pages unprotected, as with
+   non-steppable watchpoints (see stopped_by_nonsteppable_watchpoint),
+   and then checks the watchpoints.  The data address reported is the
+   fault address if it is in a watched region, otherwise that of a
+   watched region the access may have reached past the fault
+   address, if any.  */
+
+static void
+report_page_protection_fault (struct lwp_info *lp, CORE_ADDR fault_addr)
+{
+  CORE_ADDR page_size = getpagesize ();
+  CORE_ADDR page = fault_addr & ~(page_size - 1);
+  const auto &pages = protected_pages.at (lp->ptid.pid ());
+  CORE_ADDR data_address = fault_addr;
+  bool found = false;
+
+  for (CORE_ADDR p : { page, page + page_size })
+    {
+      auto it = pages.find (p);
+      if (it == pages.end ())
+	continue;
+
+      for (const page_protection_region &region : it->second.regions)
+	if (fault_addr >= region.addr
+	    && fault_addr < region.addr + region.len)
+	  {
+	    data_address = fault_addr;
+	    found = true;
+	  }
+	else if (!found
+		 && region.addr > fault_addr
+		 && region.addr < fault_addr + MAX_ACCESS_SIZE
+		 && (data_address == fault_addr
+		     || region.addr < data_address))
+	  data_address = region.addr;
+    }
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"PPW: protection fault for %s at %s, "
+			"reporting watchpoint at %s\n",
+			target_pid_to_str (lp->ptid).c_str (),
+			core_addr_to_string (fault_addr),
+			core_addr_to_string (data_address));
+
+  lp->status = W_STOPCODE (SIGTRAP);
+  lp->stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
+  lp->stopped_data_address_p = 1;
+  lp->stopped_data_address = data_address;
+  lp->page_protection_fault = 1;
+  lp->stop_pc = regcache_read_pc (get_thread_regcache (lp->ptid));
+}
+
+/* Check if we should go on and pass this event to common code.
+   Return the affected lwp if we are, or NULL otherwise.  */
+
+static struct lwp_info *
+linux_nat_filter_event (int lwpid, int status)
+{
+  struct lwp_info *lp;
+  int event = linux_ptrace_get_extended_event (status);
+
+  lp = find_lwp_pid (ptid_t (lwpid));
+
+  /* Check for stop events reported by a process we didn't already
+     know about - anything not already in our LWP list.
+
+     If we're expecting to receive stopped processes after
+     fork, vfork, and clone events, then we'll just add the
+     new one to our list and go back to waiting for the event
+     to be reported - the stopped process might be returned
+     from waitpid before or after the event is.
+
+     But note the case of a non-leader thread exec'ing after the
+     leader having exited, and gone from our lists.  The non-leader
+     thread changes its tid to the tgid.  */
+
+  if (WIFSTOPPED (status) && lp == NULL
+      && (WSTOPSIG (status) == SIGTRAP && event == PTRACE_EVENT_EXEC))
+    {
+      /* A multi-thread exec after we had seen the leader exiting.  */
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LLW: Re-adding thread group leader LWP %d.\n",
+			    lwpid);
+
+      lp = add_lwp (ptid_t (lwpid, lwpid, 0));
+      mark_lwp_stopped (lp);
+      lp->resumed = 1;
+      add_thread (lp->ptid);
+    }
+
+  if (WIFSTOPPED (status) && !lp)
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LHEW: saving LWP %ld status %s in stopped_pids list\n",
+			    (long) lwpid, status_to_str (status));
+      add_to_pid_list (&stopped_pids, lwpid, status);
+      return NULL;
+    }
+
+  /* Make sure we don't report an event for the exit of an LWP not in
+     our list, i.e. not part of the current process.  This can happen
+     if we detach from a program we originally forked and then it
+     exits.  */
+  if (!WIFSTOPPED (status) && !lp)
+    return NULL;
+
+  /* This LWP is stopped now.  (And if dead, this prevents it from
+     ever being continued.)  */
+  mark_lwp_stopped (lp);
+
+  if (WIFSTOPPED (status) && lp->must_set_ptrace_flags)
+    {
+      struct inferior *inf = find_inferior_pid (lp->ptid.pid ());
+      int options = linux_nat_ptrace_options (inf->attach_flag);
+
+      linux_enable_event_reporting (lp->ptid.lwp (), options);
+      lp->must_set_ptrace_flags = 0;
+    }
+
+  /* Handle GNU/Linux's syscall SIGTRAPs.  */
+  if (WIFSTOPPED (status) && WSTOPSIG (status) == SYSCALL_SIGTRAP)
+    {
+      /* No longer need the sysgood bit.  The ptrace event ends up
+	 recorded in lp->waitstatus if we care for it.  We can carry
+	 on handling the event like a regular SIGTRAP from here
+	 on.  */
+      status = W_STOPCODE (SIGTRAP);
+      if (linux_handle_syscall_trap (lp, 0))
+	return NULL;
     }
   else
     {
@@ -3022,6 +4295,39 @@ linux_nat_filter_event (int lwpid, int status)
 	return NULL;
     }
 
+  /* Finish stepping over a breakpoint whose conditions are false.  */
+  if (lp->cond_step_over && WIFSTOPPED (status))
+    {
+      int pid = lp->ptid.pid ();
+
+      if (WSTOPSIG (status) == SIGTRAP
+	  && !linux_is_extended_waitstatus (status))
+	{
+	  lp->status = status;
+	  save_stop_reason (lp);
+	  end_cond_step_over (pid, true);
+
+	  /* save_stop_reason gives no reason for a plain single-step
+	     trap.  */
+	  if (lp->stop_reason == TARGET_STOPPED_BY_NO_REASON)
+	    {
+	      lp->status = 0;
+	      lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+	      resume_lwp (lp, 0, GDB_SIGNAL_0);
+	      return NULL;
+	    }
+
+	  /* E.g., the instruction triggered a watchpoint.  */
+	  return lp;
+	}
+
+      /* Otherwise the instruction didn't run, or ran as far as a
+	 fork or exec event the core wants to hear about; put the
+	 breakpoint back (an exec took it away with the old program
+	 already) and handle the event as usual.  */
+      end_cond_step_over (pid, true);
+    }
+
   /* Check if the thread has exited.  */
   if (WIFEXITED (status) || WIFSIGNALED (status))
     {
@@ -3072,6 +4378,16 @@ linux_nat_filter_event (int lwpid, int status)
 				"LLW: resume_stop SIGSTOP caught for %s.\n",
 				target_pid_to_str (lp->ptid).c_str ());
 	}
+      else if (cond_step_over_in_progress_p (lp->ptid.pid ()))
+	{
+	  /* Stopped for another LWP to step over a breakpoint; see
+	     advance_cond_step_over.  */
+	  if (debug_linux_nat)
+	    fprintf_unfiltered (gdb_stdlog,
+				"LLW: %s stopped for a step over\n",
+				target_pid_to_str (lp->ptid).c_str ());
+	  return NULL;
+	}
       else
 	{
 	  /* This is a delayed SIGSTOP.  Filter out the event.  */
@@ -3102,6 +4418,12 @@ linux_nat_filter_event (int lwpid, int status)
       /* This is a delayed SIGINT.  */
       lp->ignore_sigint = 0;
 
+      if (cond_step_over_holds_p (lp))
+	{
+	  hold_lwp (lp, lp->step, GDB_SIGNAL_0);
+	  return NULL;
+	}
+
       linux_resume_one_lwp (lp, lp->step, GDB_SIGNAL_0);
       if (debug_linux_nat)
 	fprintf_unfiltered (gdb_stdlog,
@@ -3115,6 +4437,16 @@ linux_nat_filter_event (int lwpid, int status)
       return NULL;
     }
 
+  /* Accesses to pages protected for watchpoints are reported as
+     watchpoint triggers.  */
+  CORE_ADDR fault_addr;
+  if (WIFSTOPPED (status) && WSTOPSIG (status) == SIGSEGV
+      && page_protection_fault_p (lp, &fault_addr))
+    {
+      report_page_protection_fault (lp, fault_addr);
+      return lp;
+    }
+
   /* Don't report signals that GDB isn't interested in, such as
      signals that are neither printed nor stopped upon.  Stopping all
      threads can be a bit time-consuming so if we want decent
@@ -3154,6 +4486,12 @@ linux_nat_filter_event (int lwpid, int status)
 	      || !find_thread_ptid (lp->ptid)->stop_requested)
 	  && !linux_wstatus_maybe_breakpoint (status))
 	{
+	  if (cond_step_over_holds_p (lp))
+	    {
+	      hold_lwp (lp, lp->step, signo);
+	      return NULL;
+	    }
+
 	  linux_resume_one_lwp (lp, lp->step, signo);
 	  if (debug_linux_nat)
 	    fprintf_unfiltered (gdb_stdlog,
@@ -3172,6 +4510,42 @@ linux_nat_filter_event (int lwpid, int status)
   gdb_assert (lp);
   lp->status = status;
   save_stop_reason (lp);
+
+  /* If the breakpoint's conditions are false for this LWP, step it
+     over the breakpoint without telling the core.  Where that can't
+     be done here, say that the conditions are false; the core then
+     steps over the breakpoint without evaluating them again.  */
+  if (breakpoint_conditions_false_p (lp))
+    {
+      if (lp->last_resume_kind == resume_stop)
+	{
+	  /* The core asked for LP to stop, and its SIGSTOP is still
+	     to come: forget the hit, and let LP report the SIGSTOP
+	     instead.  With its PC backed up, LP hits the breakpoint
+	     again once resumed.  */
+	  if (lp->signalled)
+	    {
+	      if (debug_linux_nat)
+		fprintf_unfiltered (gdb_stdlog,
+				    "LNFE: %s hit a breakpoint with false "
+				    "conditions while stopping\n",
+				    target_pid_to_str (lp->ptid).c_str ());
+
+	      lp->status = 0;
+	      lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+	      linux_resume_one_lwp (lp, 0, GDB_SIGNAL_0);
+	      return NULL;
+	    }
+	}
+      else if (can_step_over_cond_breakpoint_p (lp))
+	{
+	  start_cond_step_over (lp);
+	  return NULL;
+	}
+
+      lp->cond_false = 1;
+    }
+
   return lp;
 }
 
@@ -3282,7 +4656,7 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
   block_child_signals (&prev_mask);
 
   /* First check if there is a LWP with a wait status pending.  */
-  lp = iterate_over_lwps (ptid, status_callback);
+  lp = iterate_over_stopped_lwps (ptid, status_callback);
   if (lp != NULL)
     {
       if (debug_linux_nat)
@@ -3336,17 +4710,22 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 	  continue;
 	}
 
-      /* Now that we've pulled all events out of the kernel, resume
-	 LWPs that don't have an interesting event to report.  */
-      iterate_over_lwps (minus_one_ptid,
-			 [] (struct lwp_info *info)
-			 {
-			   return resume_stopped_resumed_lwps (info, minus_one_ptid);
-			 });
+      /* Now that we've pulled all events out of the kernel, move the
+	 steps over breakpoints forward, ...  */
+      advance_cond_step_overs ();
+
+      /* ... resume LWPs that don't have an interesting event to
+	 report.  */
+      iterate_over_stopped_lwps (minus_one_ptid,
+				 [] (struct lwp_info *info)
+				 {
+				   return resume_stopped_resumed_lwps
+				     (info, minus_one_ptid);
+				 });
 
       /* ... and find an LWP with a status to report to the core, if
 	 any.  */
-      lp = iterate_over_lwps (ptid, status_callback);
+      lp = iterate_over_stopped_lwps (ptid, status_callback);
       if (lp != NULL)
 	break;
 
@@ -3399,12 +4778,20 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
       /* ... and wait until all of them have reported back that
 	 they're no longer running.  */
       iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+      cancel_cond_step_overs (minus_one_ptid);
     }
 
   /* If we're not waiting for a specific LWP, choose an event LWP from
      among those that have had events.  Giving equal priority to all
-     LWPs that have had events helps prevent starvation.  */
-  if (ptid == minus_one_ptid || ptid.is_pid ())
+     LWPs that have had events helps prevent starvation.  In non-stop,
+     the SIGSTOP that acknowledges a stop the core requested isn't an
+     event that can starve others, so report it as is; otherwise,
+     stopping N threads would walk the LWP list 2*N times here.  */
+  if ((ptid == minus_one_ptid || ptid.is_pid ())
+      && !(target_is_non_stop_p ()
+	   && lp->last_resume_kind == resume_stop
+	   && lp->waitstatus.kind == TARGET_WAITKIND_IGNORE
+	   && WIFSTOPPED (status) && WSTOPSIG (status) == SIGSTOP))
     select_event_lwp (ptid, &lp, &status);
 
   gdb_assert (lp != NULL);
@@ -3475,11 +4862,10 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
       ourstatus->value.sig = GDB_SIGNAL_0;
     }
 
-  if (ourstatus->kind == TARGET_WAITKIND_EXITED
-      || ourstatus->kind == TARGET_WAITKIND_SIGNALLED)
-    lp->core = -1;
-  else
-    lp->core = linux_common_core_of_thread (lp->ptid);
+  /* The core the LWP stopped on is read from /proc on demand, by
+     core_of_thread or update_thread_list, rather than here for every
+     event, which adds up when stopping thousands of LWPs.  */
+  lp->core = -1;
 
   if (ourstatus->kind == TARGET_WAITKIND_EXITED)
     return filter_exit_event (lp, ourstatus);
@@ -3514,6 +4900,14 @@ resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid)
 			    "RSRL: NOT resuming LWP %s, has pending status\n",
 			    target_pid_to_str (lp->ptid).c_str ());
     }
+  else if (cond_step_over_in_progress_p (lp->ptid.pid ()))
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "RSRL: NOT resuming LWP %s, stepping over "
+			    "a breakpoint\n",
+			    target_pid_to_str (lp->ptid).c_str ());
+    }
   else
     {
       struct regcache *regcache = get_thread_regcache (lp->ptid);
@@ -3582,11 +4976,11 @@ linux_nat_target::wait (ptid_t ptid, struct target_waitstatus *ourstatus,
      meanwhile the event became uninteresting.  Don't bother resuming
      LWPs we're not going to wait for if they'd stop immediately.  */
   if (target_is_non_stop_p ())
-    iterate_over_lwps (minus_one_ptid,
-		       [=] (struct lwp_info *info)
-		       {
-			 return resume_stopped_resumed_lwps (info, ptid);
-		       });
+    iterate_over_stopped_lwps (minus_one_ptid,
+			       [=] (struct lwp_info *info)
+			       {
+				 return resume_stopped_resumed_lwps (info, ptid);
+			       });
 
   event_ptid = linux_nat_wait_1 (ptid, ourstatus, target_options);
 
@@ -3742,12 +5136,102 @@ linux_nat_target::kill ()
   target_mourn_inferior (inferior_ptid);
 }
 
+/* The conditions of the breakpoint at ADDR in process PID are
+   changing; forget what the LWPs stopped there found about them.  */
+
+static void
+forget_false_conditions (int pid, CORE_ADDR addr)
+{
+  iterate_over_lwps (ptid_t (pid), [=] (struct lwp_info *lp)
+    {
+      if (lp->stop_pc == addr)
+	lp->cond_false = 0;
+      return 0;
+    });
+}
+
+/* Implement the "insert_breakpoint" target method.  Software
+   breakpoints are inserted as usual; those with target-side
+   conditions are also recorded, for linux_nat_filter_event to check
+   their conditions when they are hit.  */
+
+int
+linux_nat_target::insert_breakpoint (struct gdbarch *gdbarch,
+				     struct bp_target_info *bp_tgt)
+{
+  int ret = inf_ptrace_target::insert_breakpoint (gdbarch, bp_tgt);
+
+  /* GDB re-inserts breakpoints that are already inserted, when their
+     conditions change.  */
+  auto &bps = cond_breakpoints[inferior_ptid.pid ()];
+  bps.erase (bp_tgt->placed_address);
+  forget_false_conditions (inferior_ptid.pid (), bp_tgt->placed_address);
+
+  if (ret == 0 && !bp_tgt->conditions.empty ())
+    {
+      linux_nat_cond_breakpoint &bp = bps[bp_tgt->placed_address];
+
+      int insn_len;
+      const gdb_byte *insn
+	= gdbarch_sw_breakpoint_from_kind (gdbarch, bp_tgt->kind, &insn_len);
+
+      bp.gdbarch = gdbarch;
+      bp.shadow.assign (bp_tgt->shadow_contents,
+			bp_tgt->shadow_contents + bp_tgt->shadow_len);
+      bp.insn.assign (insn, insn + insn_len);
+      for (agent_expr *cond : bp_tgt->conditions)
+	bp.conditions.emplace_back (cond->buf, cond->buf + cond->len);
+    }
+
+  return ret;
+}
+
+/* Implement the "remove_breakpoint" target method.  */
+
+int
+linux_nat_target::remove_breakpoint (struct gdbarch *gdbarch,
+				     struct bp_target_info *bp_tgt,
+				     enum remove_bp_reason reason)
+{
+  auto proc = cond_breakpoints.find (inferior_ptid.pid ());
+  if (proc != cond_breakpoints.end ())
+    proc->second.erase (bp_tgt->placed_address);
+  forget_false_conditions (inferior_ptid.pid (), bp_tgt->placed_address);
+
+  return inf_ptrace_target::remove_breakpoint (gdbarch, bp_tgt, reason);
+}
+
+/* Implement the "supports_evaluation_of_breakpoint_conditions" target
+   method.  */
+
+bool
+linux_nat_target::supports_evaluation_of_breakpoint_conditions ()
+{
+  return native_condition_evaluation;
+}
+
+/* Implement the "stopped_by_false_breakpoint_condition" target
+   method.  */
+
+bool
+linux_nat_target::stopped_by_false_breakpoint_condition ()
+{
+  struct lwp_info *lp = find_lwp_pid (inferior_ptid);
+
+  gdb_assert (lp != NULL);
+
+  return lp->cond_false;
+}
+
 void
 linux_nat_target::mourn_inferior ()
 {
   int pid = inferior_ptid.pid ();
 
   purge_lwp_list (pid);
+  cond_breakpoints.erase (pid);
+  cond_step_overs.erase (pid);
+  protected_pages.erase (pid);
 
   if (! forks_exist_p ())
     /* Normal case, no other forks available.  */
@@ -4257,6 +5741,7 @@ linux_async_pipe (int enable)
 	  linux_nat_event_pipe[0] = -1;
 	  linux_nat_event_pipe[1] = -1;
 	}
+      linux_nat_event_pipe_marked = 0;
 
       restore_child_signals_mask (&prev_mask);
     }
@@ -4315,6 +5800,21 @@ linux_nat_stop_lwp (struct lwp_info *lwp)
       stop_callback (lwp);
       lwp->last_resume_kind = resume_stop;
     }
+  else if (lwp->resumed && !lwp_status_pending_p (lwp)
+	   && cond_step_over_in_progress_p (lwp->ptid.pid ()))
+    {
+      /* Stopped by a step over a breakpoint, or stepping over one
+	 and waiting for the others to stop; report the stop once the
+	 step over is done (or abandoned, see
+	 advance_cond_step_over).  */
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LNSL: held -> stopped %s\n",
+			    target_pid_to_str (lwp->ptid).c_str ());
+
+      lwp->last_resume_kind = resume_stop;
+      lwp->status = W_STOPCODE (SIGSTOP);
+    }
   else
     {
       /* Already known to be stopped; do nothing.  */
@@ -4383,16 +5883,20 @@ linux_nat_target::thread_address_space (ptid_t ptid)
   return inf->aspace;
 }
 
-/* Return the cached value of the processor core for thread PTID.  */
+/* Return the cached value of the processor core for thread PTID,
+   fetching it first if the LWP stopped since we last looked.  */
 
 int
 linux_nat_target::core_of_thread (ptid_t ptid)
 {
   struct lwp_info *info = find_lwp_pid (ptid);
 
-  if (info)
-    return info->core;
-  return -1;
+  if (info == NULL)
+    return -1;
+
+  if (info->core == -1 && info->stopped)
+    info->core = linux_common_core_of_thread (info->ptid);
+  return info->core;
 }
 
 /* Implementation of to_filesystem_is_local.  */
@@ -4546,6 +6050,29 @@ Enables printf debugging output."),
 			     show_debug_linux_nat,
 			     &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("page-protection-watchpoints", class_breakpoint,
+			   &page_protection_watchpoints, _("\
+Set whether to watch memory by protecting the pages holding it."), _("\
+Show whether to watch memory by protecting the pages holding it."), _("\
+If on, watchpoints that don't fit in the debug registers are implemented\n\
+by making the pages that hold the watched memory inaccessible, and\n\
+trapping the faults, instead of by single-stepping the program."),
+			   NULL,
+			   show_page_protection_watchpoints,
+			   &setlist, &showlist);
+
+  add_setshow_boolean_cmd ("native-condition-evaluation", class_breakpoint,
+			   &native_condition_evaluation, _("\
+Set whether the native target may evaluate breakpoint conditions."), _("\
+Show whether the native target may evaluate breakpoint conditions."), _("\
+If on, \"set breakpoint condition-evaluation target\" makes GDB evaluate\n\
+the conditions of software breakpoints as soon as a thread hits them,\n\
+and step over those whose conditions are false without evaluating them\n\
+again."),
+			   set_native_condition_evaluation,
+			   show_native_condition_evaluation,
+			   &setlist, &showlist);
+
   add_setshow_boolean_cmd ("linux-namespaces", class_maintenance,
 			   &debug_linux_namespaces, _("\
 Set debugging of GNU/Linux namespaces module."), _("\
@@ -74,6 +74,14 @@ public:
 
   bool stopped_data_address (CORE_ADDR *) override;
 
+  bool stopped_by_nonsteppable_watchpoint () override;
+
+  int insert_breakpoint (struct gdbarch *, struct bp_target_info *) override;
+  int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
+			 enum remove_bp_reason) override;
+  bool supports_evaluation_of_breakpoint_conditions () override;
+  bool stopped_by_false_breakpoint_condition () override;
+
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
 
@@ -137,6 +145,24 @@ public:
   std::vector<static_tracepoint_marker>
     static_tracepoint_markers_by_strid (const char *id) override;
 
+  /* Watch the LEN bytes at ADDR by protecting the pages that hold
+     them: write watchpoints make the pages read-only, read and access
+     watchpoints make them inaccessible.  Accesses that fault are
+     stepped over, and reported as watchpoint triggers if they touched
+     the watched bytes.  Return 0 on success, or 1 if
+     "page-protection-watchpoints" is off or the pages can't be
+     protected.  For use by the insert_watchpoint method of
+     arch-specific targets, for watchpoints that don't fit in the
+     debug registers.  */
+  int insert_page_protection_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type);
+
+  /* Stop watching a range watched by
+     insert_page_protection_watchpoint.  Return 0 on success, or 1 if
+     the range isn't watched that way.  */
+  int remove_page_protection_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type);
+
   /* Methods that are meant to overridden by the concrete
      arch-specific target instance.  */
 
@@ -184,6 +210,14 @@ public:
   /* SIGTRAP-like breakpoint status events recognizer.  The default
      recognizes SIGTRAP only.  */
   virtual bool low_status_is_event (int status);
+
+  /* Make the stopped LWP LWPID call mprotect to change the protection
+     of the LEN bytes at ADDR to PROT, restoring its state afterwards.
+     Return true on success.  Used for page protection
+     watchpoints.  */
+  virtual bool low_inferior_mprotect (int lwpid, CORE_ADDR addr,
+				      ULONGEST len, int prot)
+  { return false; }
 };
 
 /* The final/concrete instance.  */
@@ -240,6 +274,20 @@ struct lwp_info
      (breakpoint, watchpoint, etc.)  */
   enum target_stop_reason stop_reason;
 
+  /* Non-zero if the LWP stopped at a software breakpoint whose
+     target-side conditions all evaluated false, and it is left to
+     the core to step it over the breakpoint.  */
+  int cond_false;
+
+  /* Non-zero if we are stepping the LWP over a software breakpoint
+     whose target-side conditions all evaluated false, without
+     reporting the hit to the core.  See start_cond_step_over.  */
+  int cond_step_over;
+
+  /* Non-zero if the LWP's watchpoint trigger is a fault in a page
+     protected for watchpoints, before the access was made.  */
+  int page_protection_fault;
+
   /* On architectures where it is possible to know the data address of
      a triggered watchpoint, STOPPED_DATA_ADDRESS_P is non-zero, and
      STOPPED_DATA_ADDRESS contains such data address.  Otherwise,
@@ -263,7 +311,8 @@ struct lwp_info
      - TARGET_WAITKIND_SYSCALL_RETURN */
   enum target_waitkind syscall_state;
 
-  /* The processor core this LWP was last seen on.  */
+  /* The processor core this LWP was last seen on, or -1 if it hasn't
+     been read from /proc since the LWP last ran.  */
   int core;
 
   /* Arch-specific additions.  */
@@ -273,6 +322,11 @@ struct lwp_info
      sorted by reverse creation order.  */
   struct lwp_info *prev;
   struct lwp_info *next;
+
+  /* Index of this LWP in the list of LWPs that may be stopped or have
+     a pending status, or -1 if it isn't there.  See
+     iterate_over_stopped_lwps.  */
+  int stopped_list_index;
 };
 
 /* The global list of LWPs, for ALL_LWPS.  Unlike the threads list,
@@ -308,6 +362,31 @@ void linux_proc_pending_signals (int pid, sigset_t *pending,
 
 /* For linux_stop_lwp see nat/linux-nat.h.  */
 
+/* Whether watchpoints that don't fit in the debug registers are
+   implemented by protecting the pages holding the watched memory.  */
+extern bool page_protection_watchpoints;
+
+/* The largest number of pages a page protection watchpoint may
+   cover.  */
+#define PAGE_PROTECTION_MAX_PAGES 1024
+
+/* Return true if the LEN bytes at ADDR can be watched by protecting
+   their pages.  */
+extern bool page_protection_region_ok_p (CORE_ADDR addr, int len);
+
+/* Return the protection of the page at ADDR in process PID, as
+   PROT_* flags, read from /proc/PID/maps.  Return -1 if the page
+   isn't mapped.  */
+extern int linux_proc_page_prot (int pid, CORE_ADDR addr);
+
+/* Single-step the stopped LWP LWPID, which is set up to run an
+   instruction injected by GDB, until the instruction has run.
+   Signals the LWP reports meanwhile are raised again for it to
+   report them later; other events are left pending.  Return false if
+   the LWP couldn't be stepped, e.g. because it exited, or if the
+   instruction faulted.  */
+extern bool linux_nat_step_injected_lwp (int lwpid);
+
 /* Stop all LWPs, synchronously.  (Any events that trigger while LWPs
    are being stopped are left pending.)  */
 extern void linux_stop_and_wait_all_lwps (void);
@@ -34,6 +34,7 @@
 #include "gdb_obstack.h"
 #include "observable.h"
 #include "objfiles.h"
+#include "minsyms.h"
 #include "infcall.h"
 #include "gdbcmd.h"
 #include "gdb_regex.h"
@@ -98,6 +99,11 @@ static bool use_coredump_filter = true;
    the dump.  */
 static bool dump_excluded_mappings = false;
 
+/* Whether gcore should read the contents of private anonymous
+   mappings that /proc/PID/smaps shows were never touched.  If false,
+   they are saved as all zeroes without being read.  */
+static bool read_untouched_mappings = true;
+
 /* This enum represents the signals' numbers on a generic architecture
    running the Linux kernel.  The definition of "generic" comes from
    the file <include/uapi/asm-generic/signal.h>, from the Linux kernel
@@ -1174,6 +1180,7 @@ typedef int linux_find_memory_region_ftype (ULONGEST vaddr, ULONGEST size,
 					    ULONGEST offset, ULONGEST inode,
 					    int read, int write,
 					    int exec, int modified,
+					    bool zeroed,
 					    const char *filename,
 					    void *data);
 
@@ -1239,6 +1246,8 @@ linux_find_memory_regions_full (struct gdbarch *gdbarch,
 	  size_t permissions_len, device_len;
 	  int read, write, exec, priv;
 	  int has_anonymous = 0;
+	  int has_rss = 0;
+	  unsigned long rss = 0, swap = 0;
 	  int should_dump_p = 0;
 	  int mapping_anon_p;
 	  int mapping_file_p;
@@ -1295,6 +1304,10 @@ linux_find_memory_regions_full (struct gdbarch *gdbarch,
 		}
 	      else if (strcmp (keyword, "VmFlags:") == 0)
 		decode_vmflags (line, &v);
+	      else if (strcmp (keyword, "Rss:") == 0)
+		has_rss = sscanf (line, "%*s%lu", &rss) == 1;
+	      else if (strcmp (keyword, "Swap:") == 0)
+		sscanf (line, "%*s%lu", &swap);
 
 	      if (strcmp (keyword, "AnonHugePages:") == 0
 		  || strcmp (keyword, "Anonymous:") == 0)
@@ -1343,10 +1356,20 @@ linux_find_memory_regions_full (struct gdbarch *gdbarch,
 
 	  /* Invoke the callback function to create the corefile segment.  */
 	  if (should_dump_p)
-	    func (addr, endaddr - addr, offset, inode,
-		  read, write, exec, 1, /* MODIFIED is true because we
-					   want to dump the mapping.  */
-		  filename, obfd);
+	    {
+	      /* MODIFIED is true because we want to dump the mapping.
+		 A writable private anonymous mapping with no resident or
+		 swapped pages was never touched, so it holds only zeroes
+		 and need not be read.  */
+	      bool zeroed = (!read_untouched_mappings
+			     && has_rss && rss == 0 && swap == 0
+			     && write && priv && !v.shared_mapping
+			     && (*filename == '\0'
+				 || strcmp (filename, "[heap]") == 0));
+
+	      func (addr, endaddr - addr, offset, inode,
+		    read, write, exec, 1, zeroed, filename, obfd);
+	    }
 	}
 
       return 0;
@@ -1376,12 +1399,13 @@ static int
 linux_find_memory_regions_thunk (ULONGEST vaddr, ULONGEST size,
 				 ULONGEST offset, ULONGEST inode,
 				 int read, int write, int exec, int modified,
-				 const char *filename, void *arg)
+				 bool zeroed, const char *filename, void *arg)
 {
   struct linux_find_memory_regions_data *data
     = (struct linux_find_memory_regions_data *) arg;
 
-  return data->func (vaddr, size, read, write, exec, modified, data->obfd);
+  return data->func (vaddr, size, read, write, exec, modified, zeroed,
+		     data->obfd);
 }
 
 /* A variant of linux_find_memory_regions_full that is suitable as the
@@ -1441,7 +1465,7 @@ static int
 linux_make_mappings_callback (ULONGEST vaddr, ULONGEST size,
 			      ULONGEST offset, ULONGEST inode,
 			      int read, int write, int exec, int modified,
-			      const char *filename, void *data)
+			      bool zeroed, const char *filename, void *data)
 {
   struct linux_make_mappings_data *map_data
     = (struct linux_make_mappings_data *) data;
@@ -2418,6 +2442,38 @@ linux_displaced_step_location (struct gdbarch *gdbarch)
 
 /* See linux-tdep.h.  */
 
+int
+linux_displaced_step_buffer_count (struct gdbarch *gdbarch)
+{
+  CORE_ADDR entry;
+
+  if (target_auxv_search (current_top_target (), AT_ENTRY, &entry) <= 0)
+    return 1;
+  entry = gdbarch_convert_from_func_ptr_addr (gdbarch, entry,
+					      current_top_target ());
+
+  /* The entry point function (normally _start) only runs once, at
+     program startup, so the whole of it can be used for displaced
+     stepping buffers.  Without a sized symbol for it we don't know
+     how far it extends, so only use the one buffer that was always
+     assumed to fit.  */
+  bound_minimal_symbol msym = lookup_minimal_symbol_by_pc (entry);
+  if (msym.minsym == NULL
+      || BMSYMBOL_VALUE_ADDRESS (msym) != entry
+      || !MSYMBOL_HAS_SIZE (msym.minsym))
+    return 1;
+
+  CORE_ADDR start = linux_displaced_step_location (gdbarch);
+  CORE_ADDR end = entry + MSYMBOL_SIZE (msym.minsym);
+  int len = gdbarch_max_insn_length (gdbarch);
+
+  if (end <= start + len)
+    return 1;
+  return (end - start) / len;
+}
+
+/* See linux-tdep.h.  */
+
 CORE_ADDR
 linux_get_hwcap (struct target_ops *target)
 {
@@ -2460,6 +2516,17 @@ show_dump_excluded_mappings (struct ui_file *file, int from_tty,
 			    " flag is %s.\n"), value);
 }
 
+/* Display whether the gcore command reads the contents of untouched
+   anonymous mappings.  */
+
+static void
+show_read_untouched_mappings (struct ui_file *file, int from_tty,
+			      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Reading of untouched anonymous mappings"
+			    " is %s.\n"), value);
+}
+
 /* To be called from the various GDB_OSABI_LINUX handlers for the
    various GNU/Linux architectures and machine types.  */
 
@@ -2517,4 +2584,18 @@ VM_DONTDUMP flag (\"dd\" in /proc/PID/smaps) when generating the corefile.  For\
 more information about this file, refer to the manpage of proc(5) and core(5)."),
 			   NULL, show_dump_excluded_mappings,
 			   &setlist, &showlist);
+
+  add_setshow_boolean_cmd ("read-untouched-mappings", class_files,
+			   &read_untouched_mappings, _("\
+Set whether gcore should read untouched anonymous mappings."),
+			   _("\
+Show whether gcore should read untouched anonymous mappings."),
+			   _("\
+When off, gcore consults /proc/PID/smaps and does not read private anonymous\n\
+mappings that have no resident or swapped pages.  Such mappings were never\n\
+written to, so they are saved in the corefile as zeroes without reading\n\
+them.  This makes dumping processes with large reserved but unused\n\
+memory much faster."),
+			   NULL, show_read_untouched_mappings,
+			   &setlist, &showlist);
 }
@@ -57,6 +57,12 @@ extern int linux_gdb_signal_to_target (struct gdbarch *gdbarch,
    the target auxiliary vector.  */
 extern CORE_ADDR linux_displaced_step_location (struct gdbarch *gdbarch);
 
+/* GNU/Linux implementation of `displaced_step_buffer_count', as
+   defined in gdbarch.h, for use together with
+   linux_displaced_step_location.  Lays out as many buffers as fit in
+   the entry point function.  */
+extern int linux_displaced_step_buffer_count (struct gdbarch *gdbarch);
+
 extern void linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch);
 
 extern int linux_is_uclinux (void);
@@ -422,7 +422,8 @@ extern const struct language_defn m2_language_defn =
   NULL,
   NULL,
   m2_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
 
 static void *
@@ -43,7 +43,9 @@ static void list_args_or_locals (const frame_print_options &fp_opts,
 				 enum what_to_list what,
 				 enum print_values values,
 				 struct frame_info *fi,
-				 int skip_unavailable);
+				 int skip_unavailable,
+				 int from = -1, int to = -1,
+				 bool *has_more = NULL);
 
 /* True if we want to allow Python-based frame filters.  */
 static int frame_filters = 0;
@@ -207,6 +209,58 @@ mi_cmd_stack_info_depth (const char *command, char **argv, int argc)
   current_uiout->field_signed ("depth", i);
 }
 
+/* Print the backtraces of all threads.  With the --unique option,
+   print each distinct backtrace once, along with the threads that
+   share it.  With a MAX_DEPTH argument, only the innermost MAX_DEPTH
+   frames of each thread are considered.  */
+
+void
+mi_cmd_thread_list_stacks (const char *command, char **argv, int argc)
+{
+  int max_depth = -1;
+  bool unique = false;
+  int oind = 0;
+  enum opt
+    {
+      UNIQUE
+    };
+  static const struct mi_opt opts[] =
+    {
+      {"-unique", UNIQUE, 0},
+      { 0, 0, 0 }
+    };
+
+  while (1)
+    {
+      char *oarg;
+      int opt = mi_getopt ("-thread-list-stacks", argc, argv,
+			   opts, &oind, &oarg);
+      if (opt < 0)
+	break;
+      switch ((enum opt) opt)
+	{
+	case UNIQUE:
+	  unique = true;
+	  break;
+	}
+    }
+
+  if (argc - oind > 1)
+    error (_("-thread-list-stacks: Usage: [--unique] [MAX_DEPTH]"));
+
+  if (argc - oind == 1)
+    {
+      max_depth = atoi (argv[oind]);
+      if (max_depth < 0)
+	error (_("-thread-list-stacks: MAX_DEPTH must not be negative"));
+    }
+
+  if (!target_has_stack)
+    error (_("No stack."));
+
+  backtrace_all_threads (max_depth, unique, 0);
+}
+
 /* Print a list of the locals for the current frame.  With argument of
    0, print only the names, with argument of 1 print also the
    values.  */
@@ -412,51 +466,65 @@ mi_cmd_stack_list_variables (const char *command, char **argv, int argc)
   enum print_values print_value;
   int oind = 0;
   int skip_unavailable = 0;
-
-  if (argc > 1)
+  int from = -1, to = -1;
+  enum opt
+  {
+    NO_FRAME_FILTERS,
+    SKIP_UNAVAILABLE,
+  };
+  static const struct mi_opt opts[] =
     {
-      enum opt
-      {
-	NO_FRAME_FILTERS,
-	SKIP_UNAVAILABLE,
-      };
-      static const struct mi_opt opts[] =
-	{
-	  {"-no-frame-filters", NO_FRAME_FILTERS, 0},
-	  {"-skip-unavailable", SKIP_UNAVAILABLE, 0},
-	  { 0, 0, 0 }
-	};
+      {"-no-frame-filters", NO_FRAME_FILTERS, 0},
+      {"-skip-unavailable", SKIP_UNAVAILABLE, 0},
+      { 0, 0, 0 }
+    };
 
-      while (1)
+  while (1)
+    {
+      char *oarg;
+      /* Don't fail on 'print-values', which may look like an
+	 option.  */
+      int opt = mi_getopt_allow_unknown ("-stack-list-variables", argc,
+					 argv, opts, &oind, &oarg);
+      if (opt < 0)
+	break;
+      switch ((enum opt) opt)
 	{
-	  char *oarg;
-	  /* Don't parse 'print-values' as an option.  */
-	  int opt = mi_getopt ("-stack-list-variables", argc - 1,
-			       argv, opts, &oind, &oarg);
-	  if (opt < 0)
-	    break;
-	  switch ((enum opt) opt)
-	    {
-	    case NO_FRAME_FILTERS:
-	      raw_arg = oind;
-	      break;
-	    case SKIP_UNAVAILABLE:
-	      skip_unavailable = 1;
-	      break;
-	    }
+	case NO_FRAME_FILTERS:
+	  raw_arg = oind;
+	  break;
+	case SKIP_UNAVAILABLE:
+	  skip_unavailable = 1;
+	  break;
 	}
     }
 
   /* After the last option is parsed, there should be only
-     'print-values'.  */
-  if (argc - oind != 1)
+     'print-values', and maybe a range of variables.  */
+  if (argc - oind != 1 && argc - oind != 3)
     error (_("-stack-list-variables: Usage: [--no-frame-filters] " \
-	     "[--skip-unavailable] PRINT_VALUES"));
+	     "[--skip-unavailable] PRINT_VALUES [FROM TO]"));
+
+  bool ranged = argc - oind == 3;
+  if (ranged)
+    {
+      from = atoi (argv[1 + oind]);
+      to = atoi (argv[2 + oind]);
+      if (from < 0 || to < 0)
+	{
+	  from = -1;
+	  to = -1;
+	}
+      else if (from > to)
+	from = to;
+    }
 
    frame = get_selected_frame (NULL);
    print_value = mi_parse_print_values (argv[oind]);
 
-   if (! raw_arg && frame_filters)
+   /* Frame filters list all the variables at once, so they aren't used
+      when only a range of them is requested.  */
+   if (! raw_arg && frame_filters && from < 0)
      {
        frame_filter_flags flags = PRINT_LEVEL | PRINT_ARGS | PRINT_LOCALS;
 
@@ -467,11 +535,16 @@ mi_cmd_stack_list_variables (const char *command, char **argv, int argc)
 
    /* Run the inbuilt backtrace if there are no filters registered, or
       if "--no-frame-filters" has been specified from the command.  */
-   if (! frame_filters || raw_arg  || result == EXT_LANG_BT_NO_FILTERS)
+   if (! frame_filters || raw_arg  || result == EXT_LANG_BT_NO_FILTERS
+       || from >= 0)
      {
+       bool has_more = false;
+
        list_args_or_locals (user_frame_print_options,
 			    all, print_value, frame,
-			    skip_unavailable);
+			    skip_unavailable, from, to, &has_more);
+       if (ranged)
+	 current_uiout->field_signed ("has_more", has_more);
      }
 }
 
@@ -559,12 +632,20 @@ list_arg_or_local (const struct frame_arg *arg, enum what_to_list what,
    which is determined by VALUES.  The objects can be locals,
    arguments or both, which is determined by WHAT.  If SKIP_UNAVAILABLE
    is true, only print the arguments or local variables whose values
-   are available.  */
+   are available.
+
+   If FROM is not negative, only the objects numbered FROM (starting
+   at zero) up to and excluding TO are listed, and the others are not
+   read at all.  The objects are numbered in the order they are listed
+   in, which only depends on the frame's pc; they are numbered whether
+   they are then skipped for being unavailable or not.  *HAS_MORE is
+   then set to whether there are objects after TO.  */
 
 static void
 list_args_or_locals (const frame_print_options &fp_opts,
 		     enum what_to_list what, enum print_values values,
-		     struct frame_info *fi, int skip_unavailable)
+		     struct frame_info *fi, int skip_unavailable,
+		     int from, int to, bool *has_more)
 {
   const struct block *block;
   struct symbol *sym;
@@ -572,6 +653,7 @@ list_args_or_locals (const frame_print_options &fp_opts,
   struct type *type;
   const char *name_of_result;
   struct ui_out *uiout = current_uiout;
+  int index = 0;
 
   block = get_frame_block (fi, 0);
 
@@ -628,11 +710,23 @@ list_args_or_locals (const frame_print_options &fp_opts,
 		print_me = SYMBOL_IS_ARGUMENT (sym);
 	      break;
 	    }
+	  if (print_me && from >= 0)
+	    {
+	      if (index >= to)
+		{
+		  *has_more = true;
+		  return;
+		}
+	      if (index++ < from)
+		print_me = 0;
+	    }
 	  if (print_me)
 	    {
 	      struct symbol *sym2;
 	      struct frame_arg arg, entryarg;
 
+	      QUIT;
+
 	      if (SYMBOL_IS_ARGUMENT (sym))
 		sym2 = lookup_symbol (SYMBOL_LINKAGE_NAME (sym),
 				      block, VAR_DOMAIN,
@@ -30,7 +30,12 @@
    whether a given region can be watched, etc.
 
    The functions below implement debug registers sharing by reference
-   counts, and allow to watch regions up to 16 bytes long.  */
+   counts, and allow to watch regions up to 16 bytes long.
+
+   The debug registers are allocated from scratch from the list of
+   regions to watch whenever one is inserted or removed.  Regions that
+   don't fit otherwise are coalesced into fewer registers, if the
+   client allows it; see x86_dr_low_type.coalesce_regions.  */
 
 /* Accessor macros for low-level function vector.  */
 
@@ -168,9 +173,6 @@
 /* Did the watchpoint whose address is in the I'th register break?  */
 #define X86_DR_WATCH_HIT(dr6, i) ((dr6) & (1 << (i)))
 
-/* Types of operations supported by x86_handle_nonaligned_watchpoint.  */
-typedef enum { WP_INSERT, WP_REMOVE, WP_COUNT } x86_wp_op_t;
-
 /* Print the values of the mirrored debug registers.  */
 
 static void
@@ -204,6 +206,13 @@ x86_show_dr (struct x86_debug_reg_state *state,
 			     x86_get_debug_register_length ()),
 		    state->dr_ref_count[i]);
     }
+
+  for (i = 0; i < X86_DR_MAX_REGIONS; i++)
+    if (state->regions[i].ref_count > 0)
+      debug_printf ("\tregion: addr=0x%s, len=%d, type=%d, ref.count=%d\n",
+		    phex (state->regions[i].addr, 8), state->regions[i].len,
+		    (int) state->regions[i].type,
+		    state->regions[i].ref_count);
 }
 
 /* Return the value of a 4-bit field for DR7 suitable for watching a
@@ -260,183 +269,339 @@ Invalid hardware breakpoint length %d in x86_length_and_rw_bits.\n"), len);
     }
 }
 
-/* Insert a watchpoint at address ADDR, which is assumed to be aligned
-   according to the length of the region to watch.  LEN_RW_BITS is the
-   value of the bits from DR7 which describes the length and access
-   type of the region to be watched by this watchpoint.  Return 0 on
-   success, -1 on failure.  */
+/* Return the length of the region watched by a debug register whose
+   DR7 LEN field is in LEN_RW_BITS.  */
 
 static int
-x86_insert_aligned_watchpoint (struct x86_debug_reg_state *state,
-			       CORE_ADDR addr, unsigned len_rw_bits)
+x86_length_from_len_rw_bits (unsigned len_rw_bits)
 {
-  int i;
+  switch (len_rw_bits & (0x3 << 2))
+    {
+      case DR_LEN_1:
+	return 1;
+      case DR_LEN_2:
+	return 2;
+      case DR_LEN_4:
+	return 4;
+      default:
+	return 8;
+    }
+}
 
-  if (!x86_dr_low_can_set_addr () || !x86_dr_low_can_set_control ())
-    return -1;
+/* An aligned region that one debug register can watch.  */
 
-  /* First, look for an occupied debug register with the same address
-     and the same RW and LEN definitions.  If we find one, we can
-     reuse it for this watchpoint as well (and save a register).  */
-  ALL_DEBUG_ADDRESS_REGISTERS (i)
+struct x86_dr_cover
+{
+  CORE_ADDR addr;
+  int len;
+  enum target_hw_bp_type type;
+};
+
+/* The maximum number of covers considered while allocating the debug
+   registers.  Covers never straddle an aligned 8-byte (4-byte on
+   32-bit hosts) window, and one window needs at most 4 exact covers,
+   so more covers than this always touch more windows than there are
+   debug registers.  */
+#define X86_DR_MAX_COVERS (DR_NADDR * 16)
+
+/* Append to the N covers in COVERS the aligned covers needed to watch
+   exactly the LEN bytes at ADDR for accesses of type TYPE, reusing
+   identical covers that are already there.  Return the new number of
+   covers, or -1 if that would be more than X86_DR_MAX_COVERS.  */
+
+static int
+x86_split_region (struct x86_dr_cover *covers, int n,
+		  CORE_ADDR addr, int len, enum target_hw_bp_type type)
+{
+  int max_wp_len = TARGET_HAS_DR_LEN_8 ? 8 : 4;
+
+  static const int size_try_array[8][8] =
+  {
+    {1, 1, 1, 1, 1, 1, 1, 1},	/* Trying size one.  */
+    {2, 1, 2, 1, 2, 1, 2, 1},	/* Trying size two.  */
+    {2, 1, 2, 1, 2, 1, 2, 1},	/* Trying size three.  */
+    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size four.  */
+    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size five.  */
+    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size six.  */
+    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size seven.  */
+    {8, 1, 2, 1, 4, 1, 2, 1},	/* Trying size eight.  */
+  };
+
+  while (len > 0)
     {
-      if (!X86_DR_VACANT (state, i)
-	  && state->dr_mirror[i] == addr
-	  && X86_DR_GET_RW_LEN (state->dr_control_mirror, i) == len_rw_bits)
+      int align = addr % max_wp_len;
+      /* Four (eight on AMD64) is the maximum length a debug register
+	 can watch.  */
+      int attempt = (len > max_wp_len ? (max_wp_len - 1) : len - 1);
+      int size = size_try_array[attempt][align];
+      int i;
+
+      /* size_try_array[] is defined such that each iteration through
+	 the loop is guaranteed to produce an address and a size that
+	 can be watched with a single debug register.  */
+      for (i = 0; i < n; i++)
+	if (covers[i].addr == addr && covers[i].len == size
+	    && covers[i].type == type)
+	  break;
+
+      if (i == n)
 	{
-	  state->dr_ref_count[i]++;
-	  return 0;
+	  if (n == X86_DR_MAX_COVERS)
+	    return -1;
+
+	  covers[n].addr = addr;
+	  covers[n].len = size;
+	  covers[n].type = type;
+	  n++;
 	}
+
+      addr += size;
+      len -= size;
     }
 
-  /* Next, look for a vacant debug register.  */
-  ALL_DEBUG_ADDRESS_REGISTERS (i)
+  return n;
+}
+
+/* Compute the covers needed to watch exactly all the regions of
+   STATE, in COVERS.  If MERGE, overlapping and adjacent write regions
+   are watched as one, so that e.g. two adjacent struct fields can
+   share a register.  Otherwise each region gets its own covers, and
+   only identical covers are shared.  Access regions are never merged:
+   a hit of the shared register could not be told apart from a hit of
+   a neighbour, while GDB filters out spurious write hits by checking
+   whether the watched values changed.  Return the number of covers,
+   or -1 if there are too many.  */
+
+static int
+x86_exact_covers (struct x86_debug_reg_state *state,
+		  struct x86_dr_cover *covers, int merge)
+{
+  static const enum target_hw_bp_type types[]
+    = { hw_execute, hw_write, hw_access };
+  int n = 0;
+
+  for (enum target_hw_bp_type type : types)
     {
-      if (X86_DR_VACANT (state, i))
-	break;
-    }
+      struct x86_dr_region spans[X86_DR_MAX_REGIONS];
+      int nspans = 0;
+      int i, j;
 
-  /* No more debug registers!  */
-  if (i >= DR_NADDR)
-    return -1;
+      for (i = 0; i < X86_DR_MAX_REGIONS; i++)
+	if (state->regions[i].ref_count > 0
+	    && state->regions[i].type == type)
+	  spans[nspans++] = state->regions[i];
 
-  /* Now set up the register I to watch our region.  */
+      if (merge && type == hw_write)
+	{
+	  /* Sort by address, then merge each span into the previous
+	     one if they overlap or touch.  */
+	  for (i = 1; i < nspans; i++)
+	    for (j = i; j > 0 && spans[j - 1].addr > spans[j].addr; j--)
+	      std::swap (spans[j - 1], spans[j]);
 
-  /* Record the info in our local mirrored array.  */
-  state->dr_mirror[i] = addr;
-  state->dr_ref_count[i] = 1;
-  X86_DR_SET_RW_LEN (state, i, len_rw_bits);
-  /* Note: we only enable the watchpoint locally, i.e. in the current
-     task.  Currently, no x86 target allows or supports global
-     watchpoints; however, if any target would want that in the
-     future, GDB should probably provide a command to control whether
-     to enable watchpoints globally or locally, and the code below
-     should use global or local enable and slow-down flags as
-     appropriate.  */
-  X86_DR_LOCAL_ENABLE (state, i);
-  state->dr_control_mirror |= DR_LOCAL_SLOWDOWN;
-  state->dr_control_mirror &= X86_DR_CONTROL_MASK;
+	  for (i = 1, j = 0; i < nspans; i++)
+	    {
+	      CORE_ADDR end = spans[j].addr + spans[j].len;
+
+	      if (spans[i].addr <= end)
+		{
+		  if (spans[i].addr + spans[i].len > end)
+		    spans[j].len = spans[i].addr + spans[i].len - spans[j].addr;
+		}
+	      else
+		spans[++j] = spans[i];
+	    }
+	  if (nspans > 0)
+	    nspans = j + 1;
+	}
 
-  return 0;
+      for (i = 0; i < nspans; i++)
+	{
+	  n = x86_split_region (covers, n, spans[i].addr, spans[i].len,
+				spans[i].type);
+	  if (n < 0)
+	    return -1;
+	}
+    }
+
+  return n;
 }
 
-/* Remove a watchpoint at address ADDR, which is assumed to be aligned
-   according to the length of the region to watch.  LEN_RW_BITS is the
-   value of the bits from DR7 which describes the length and access
-   type of the region watched by this watchpoint.  Return 0 on
-   success, -1 on failure.  */
+/* Reduce the N covers in COVERS until they fit in the debug
+   registers, by replacing all the write covers within an aligned
+   window with a single cover of the whole window, most crowded window
+   first.  Such a register also traps writes to bytes nobody watches;
+   GDB filters those out by checking whether the watched values
+   changed.  Read and access covers are never widened, since GDB could
+   not tell such spurious hits apart.  Return the new number of
+   covers, or -1 if they still don't fit.  */
 
 static int
-x86_remove_aligned_watchpoint (struct x86_debug_reg_state *state,
-			       CORE_ADDR addr, unsigned len_rw_bits)
+x86_widen_covers (struct x86_dr_cover *covers, int n)
 {
-  int i, retval = -1;
-  int all_vacant = 1;
+  int max_wp_len = TARGET_HAS_DR_LEN_8 ? 8 : 4;
 
-  ALL_DEBUG_ADDRESS_REGISTERS (i)
+  while (n > DR_NADDR)
     {
-      if (!X86_DR_VACANT (state, i)
-	  && state->dr_mirror[i] == addr
-	  && X86_DR_GET_RW_LEN (state->dr_control_mirror, i) == len_rw_bits)
+      CORE_ADDR best_window = 0;
+      int best_count = 1;
+      int i, j;
+
+      for (i = 0; i < n; i++)
 	{
-	  if (--state->dr_ref_count[i] == 0) /* No longer in use?  */
+	  CORE_ADDR window = covers[i].addr - covers[i].addr % max_wp_len;
+	  int count = 0;
+
+	  if (covers[i].type != hw_write)
+	    continue;
+
+	  for (j = 0; j < n; j++)
+	    if (covers[j].type == hw_write
+		&& covers[j].addr - covers[j].addr % max_wp_len == window)
+	      count++;
+
+	  if (count > best_count)
 	    {
-	      /* Reset our mirror.  */
-	      state->dr_mirror[i] = 0;
-	      X86_DR_DISABLE (state, i);
-	      /* Even though not strictly necessary, clear out all
-		 bits in DR_CONTROL related to this debug register.
-		 Debug output is clearer when we don't have stale bits
-		 in place.  This also allows the assertion below.  */
-	      X86_DR_SET_RW_LEN (state, i, 0);
+	      best_window = window;
+	      best_count = count;
 	    }
-	  retval = 0;
 	}
 
-      if (!X86_DR_VACANT (state, i))
-	all_vacant = 0;
-    }
+      /* Nothing left to widen.  */
+      if (best_count == 1)
+	return -1;
 
-  if (all_vacant)
-    {
-      /* Even though not strictly necessary, clear out all of
-	 DR_CONTROL, so that when we have no debug registers in use,
-	 we end up with DR_CONTROL == 0.  The Linux support relies on
-	 this for an optimization.  Plus, it makes for clearer debug
-	 output.  */
-      state->dr_control_mirror &= ~DR_LOCAL_SLOWDOWN;
-
-      gdb_assert (state->dr_control_mirror == 0);
+      for (i = 0, j = 0; i < n; i++)
+	if (covers[i].type != hw_write
+	    || covers[i].addr - covers[i].addr % max_wp_len != best_window)
+	  covers[j++] = covers[i];
+
+      covers[j].addr = best_window;
+      covers[j].len = max_wp_len;
+      covers[j].type = hw_write;
+      n = j + 1;
     }
-  return retval;
+
+  return n;
 }
 
-/* Insert or remove a (possibly non-aligned) watchpoint, or count the
-   number of debug registers required to watch a region at address
-   ADDR whose length is LEN for accesses of type TYPE.  Return 0 on
-   successful insertion or removal, a positive number when queried
-   about the number of registers, or -1 on failure.  If WHAT is not a
-   valid value, bombs through internal_error.  */
+/* Put the N covers in COVERS in the debug registers of STATE, keeping
+   covers that are already in a register where they are.  Return 0 on
+   success, -1 if there are too many covers.  */
 
 static int
-x86_handle_nonaligned_watchpoint (struct x86_debug_reg_state *state,
-				  x86_wp_op_t what, CORE_ADDR addr, int len,
-				  enum target_hw_bp_type type)
+x86_assign_covers (struct x86_debug_reg_state *state,
+		   const struct x86_dr_cover *covers, int n)
 {
-  int retval = 0;
-  int max_wp_len = TARGET_HAS_DR_LEN_8 ? 8 : 4;
+  int where[DR_NADDR];
+  int used[DR_NADDR] = { 0 };
+  unsigned control = 0;
+  int c, i;
 
-  static const int size_try_array[8][8] =
-  {
-    {1, 1, 1, 1, 1, 1, 1, 1},	/* Trying size one.  */
-    {2, 1, 2, 1, 2, 1, 2, 1},	/* Trying size two.  */
-    {2, 1, 2, 1, 2, 1, 2, 1},	/* Trying size three.  */
-    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size four.  */
-    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size five.  */
-    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size six.  */
-    {4, 1, 2, 1, 4, 1, 2, 1},	/* Trying size seven.  */
-    {8, 1, 2, 1, 4, 1, 2, 1},	/* Trying size eight.  */
-  };
+  if (n > DR_NADDR)
+    return -1;
 
-  while (len > 0)
+  for (c = 0; c < n; c++)
     {
-      int align = addr % max_wp_len;
-      /* Four (eight on AMD64) is the maximum length a debug register
-	 can watch.  */
-      int attempt = (len > max_wp_len ? (max_wp_len - 1) : len - 1);
-      int size = size_try_array[attempt][align];
+      unsigned len_rw = x86_length_and_rw_bits (covers[c].len,
+						covers[c].type);
+
+      where[c] = -1;
+      ALL_DEBUG_ADDRESS_REGISTERS (i)
+	if (!used[i] && !X86_DR_VACANT (state, i)
+	    && state->dr_mirror[i] == covers[c].addr
+	    && X86_DR_GET_RW_LEN (state->dr_control_mirror, i) == len_rw)
+	  {
+	    where[c] = i;
+	    used[i] = 1;
+	    break;
+	  }
+    }
 
-      if (what == WP_COUNT)
-	{
-	  /* size_try_array[] is defined such that each iteration
-	     through the loop is guaranteed to produce an address and a
-	     size that can be watched with a single debug register.
-	     Thus, for counting the registers required to watch a
-	     region, we simply need to increment the count on each
-	     iteration.  */
-	  retval++;
-	}
-      else
-	{
-	  unsigned len_rw = x86_length_and_rw_bits (size, type);
-
-	  if (what == WP_INSERT)
-	    retval = x86_insert_aligned_watchpoint (state, addr, len_rw);
-	  else if (what == WP_REMOVE)
-	    retval = x86_remove_aligned_watchpoint (state, addr, len_rw);
-	  else
-	    internal_error (__FILE__, __LINE__, _("\
-Invalid value %d of operation in x86_handle_nonaligned_watchpoint.\n"),
-			    (int) what);
-	  if (retval)
+  for (c = 0; c < n; c++)
+    if (where[c] == -1)
+      ALL_DEBUG_ADDRESS_REGISTERS (i)
+	if (!used[i])
+	  {
+	    where[c] = i;
+	    used[i] = 1;
 	    break;
-	}
+	  }
 
-      addr += size;
-      len -= size;
+  ALL_DEBUG_ADDRESS_REGISTERS (i)
+    {
+      state->dr_mirror[i] = 0;
+      state->dr_ref_count[i] = 0;
     }
 
-  return retval;
+  for (c = 0; c < n; c++)
+    {
+      const struct x86_dr_cover *cover = &covers[c];
+
+      i = where[c];
+      state->dr_mirror[i] = cover->addr;
+      for (const struct x86_dr_region &region : state->regions)
+	if (region.ref_count > 0 && region.type == cover->type
+	    && region.addr < cover->addr + cover->len
+	    && cover->addr < region.addr + region.len)
+	  state->dr_ref_count[i] += region.ref_count;
+
+      control |= ((x86_length_and_rw_bits (cover->len, cover->type)
+		   << (DR_CONTROL_SHIFT + DR_CONTROL_SIZE * i))
+		  | (1 << (DR_LOCAL_ENABLE_SHIFT + DR_ENABLE_SIZE * i)));
+    }
+
+  /* Note: we only enable the watchpoints locally, i.e. in the current
+     task.  Currently, no x86 target allows or supports global
+     watchpoints; however, if any target would want that in the
+     future, GDB should probably provide a command to control whether
+     to enable watchpoints globally or locally, and the code above
+     should use global or local enable and slow-down flags as
+     appropriate.
+
+     When no debug registers are in use, we end up with DR_CONTROL ==
+     0.  The Linux support relies on this for an optimization.  */
+  if (n > 0)
+    control |= DR_LOCAL_SLOWDOWN;
+  state->dr_control_mirror = control & X86_DR_CONTROL_MASK;
+
+  return 0;
+}
+
+/* Allocate the debug registers of STATE to watch all its regions.
+   Return 0 on success, -1 if they don't fit, in which case STATE's
+   debug registers are left unchanged.  */
+
+static int
+x86_allocate_debug_regs (struct x86_debug_reg_state *state)
+{
+  struct x86_dr_cover covers[X86_DR_MAX_COVERS];
+  int n;
+
+  if (!x86_dr_low_can_set_addr () || !x86_dr_low_can_set_control ())
+    return -1;
+
+  /* First, watch each region exactly, sharing a register only between
+     regions that need the very same cover.  */
+  n = x86_exact_covers (state, covers, 0);
+  if (n >= 0 && n <= DR_NADDR)
+    return x86_assign_covers (state, covers, n);
+
+  if (!x86_dr_low.coalesce_regions)
+    return -1;
+
+  /* Next, merge overlapping and adjacent regions.  This still never
+     watches a byte that no region asked for.  */
+  n = x86_exact_covers (state, covers, 1);
+  if (n < 0)
+    return -1;
+
+  /* Last, cover whole windows with a single write watchpoint.  */
+  n = x86_widen_covers (covers, n);
+  if (n < 0)
+    return -1;
+
+  return x86_assign_covers (state, covers, n);
 }
 
 /* Update the inferior debug registers state, in STATE, with the
@@ -450,10 +615,9 @@ x86_update_inferior_debug_regs (struct x86_debug_reg_state *state,
 
   ALL_DEBUG_ADDRESS_REGISTERS (i)
     {
-      if (X86_DR_VACANT (new_state, i) != X86_DR_VACANT (state, i))
+      if (X86_DR_VACANT (new_state, i) != X86_DR_VACANT (state, i)
+	  || new_state->dr_mirror[i] != state->dr_mirror[i])
 	x86_dr_low_set_addr (new_state, i);
-      else
-	gdb_assert (new_state->dr_mirror[i] == state->dr_mirror[i]);
     }
 
   if (new_state->dr_control_mirror != state->dr_control_mirror)
@@ -471,7 +635,8 @@ x86_dr_insert_watchpoint (struct x86_debug_reg_state *state,
 			  enum target_hw_bp_type type,
 			  CORE_ADDR addr, int len)
 {
-  int retval;
+  int retval = -1;
+  int i, slot = -1;
   /* Work on a local copy of the debug registers, and on success,
      commit the change back to the inferior.  */
   struct x86_debug_reg_state local_state = *state;
@@ -479,20 +644,32 @@ x86_dr_insert_watchpoint (struct x86_debug_reg_state *state,
   if (type == hw_read)
     return 1; /* unsupported */
 
-  if (((len != 1 && len != 2 && len != 4)
-       && !(TARGET_HAS_DR_LEN_8 && len == 8))
-      || addr % len != 0)
+  for (i = 0; i < X86_DR_MAX_REGIONS; i++)
     {
-      retval = x86_handle_nonaligned_watchpoint (&local_state,
-						 WP_INSERT,
-						 addr, len, type);
+      struct x86_dr_region *region = &local_state.regions[i];
+
+      if (region->ref_count > 0 && region->addr == addr
+	  && region->len == len && region->type == type)
+	{
+	  slot = i;
+	  break;
+	}
+      else if (region->ref_count == 0 && slot == -1)
+	slot = i;
     }
-  else
+
+  if (slot != -1)
     {
-      unsigned len_rw = x86_length_and_rw_bits (len, type);
+      struct x86_dr_region *region = &local_state.regions[slot];
 
-      retval = x86_insert_aligned_watchpoint (&local_state,
-					      addr, len_rw);
+      if (region->ref_count++ == 0)
+	{
+	  region->addr = addr;
+	  region->len = len;
+	  region->type = type;
+	}
+
+      retval = x86_allocate_debug_regs (&local_state);
     }
 
   if (retval == 0)
@@ -513,25 +690,30 @@ x86_dr_remove_watchpoint (struct x86_debug_reg_state *state,
 			  enum target_hw_bp_type type,
 			  CORE_ADDR addr, int len)
 {
-  int retval;
+  int retval = -1;
+  int i;
   /* Work on a local copy of the debug registers, and on success,
      commit the change back to the inferior.  */
   struct x86_debug_reg_state local_state = *state;
 
-  if (((len != 1 && len != 2 && len != 4)
-       && !(TARGET_HAS_DR_LEN_8 && len == 8))
-      || addr % len != 0)
-    {
-      retval = x86_handle_nonaligned_watchpoint (&local_state,
-						 WP_REMOVE,
-						 addr, len, type);
-    }
-  else
+  for (i = 0; i < X86_DR_MAX_REGIONS; i++)
     {
-      unsigned len_rw = x86_length_and_rw_bits (len, type);
+      struct x86_dr_region *region = &local_state.regions[i];
 
-      retval = x86_remove_aligned_watchpoint (&local_state,
-					      addr, len_rw);
+      if (region->ref_count > 0 && region->addr == addr
+	  && region->len == len && region->type == type)
+	{
+	  region->ref_count--;
+
+	  /* Removing a region can split merged regions apart.  The
+	     remaining ones should still fit, since widening them
+	     needs no more registers than before; but don't leave the
+	     old registers watching the removed region if they
+	     don't.  */
+	  if (x86_allocate_debug_regs (&local_state) == 0)
+	    retval = 0;
+	  break;
+	}
     }
 
   if (retval == 0)
@@ -550,15 +732,92 @@ int
 x86_dr_region_ok_for_watchpoint (struct x86_debug_reg_state *state,
 				 CORE_ADDR addr, int len)
 {
+  struct x86_dr_cover covers[X86_DR_MAX_COVERS];
   int nregs;
 
-  /* Compute how many aligned watchpoints we would need to cover this
-     region.  */
-  nregs = x86_handle_nonaligned_watchpoint (state, WP_COUNT,
-					     addr, len, hw_write);
+  if (x86_dr_low.coalesce_regions)
+    {
+      int max_wp_len = TARGET_HAS_DR_LEN_8 ? 8 : 4;
+
+      /* One register per aligned window will do.  */
+      nregs = ((addr + len - 1) / max_wp_len - addr / max_wp_len) + 1;
+    }
+  else
+    {
+      /* Compute how many aligned watchpoints we would need to cover
+	 this region.  */
+      nregs = x86_split_region (covers, 0, addr, len, hw_write);
+      if (nregs < 0)
+	return 0;
+    }
+
   return nregs <= DR_NADDR ? 1 : 0;
 }
 
+/* See x86-dregs.h.  */
+
+int
+x86_dr_watchpoint_addr_within_range (struct x86_debug_reg_state *state,
+				     CORE_ADDR addr, CORE_ADDR start,
+				     int length)
+{
+  int i;
+
+  if (start <= addr && addr <= start + length - 1)
+    return 1;
+
+  if (!x86_dr_low.coalesce_regions)
+    return 0;
+
+  /* ADDR is the start of the cover of the debug register that
+     triggered.  Accept any watchpoint that overlaps that cover, if it
+     is a write cover, the only kind that regions share.  */
+  ALL_DEBUG_ADDRESS_REGISTERS (i)
+    {
+      unsigned len_rw = X86_DR_GET_RW_LEN (state->dr_control_mirror, i);
+
+      if (!X86_DR_VACANT (state, i)
+	  && (len_rw & 0x3) == DR_RW_WRITE
+	  && state->dr_mirror[i] == addr
+	  && start < addr + x86_length_from_len_rw_bits (len_rw)
+	  && addr < start + length)
+	return 1;
+    }
+
+  return 0;
+}
+
+/* See x86-dregs.h.  */
+
+int
+x86_dr_get_cover (struct x86_debug_reg_state *state, int i,
+		  CORE_ADDR *addr_p, int *len_p,
+		  enum target_hw_bp_type *type_p)
+{
+  unsigned len_rw;
+
+  if (X86_DR_VACANT (state, i))
+    return 0;
+
+  len_rw = X86_DR_GET_RW_LEN (state->dr_control_mirror, i);
+  *addr_p = state->dr_mirror[i];
+  *len_p = x86_length_from_len_rw_bits (len_rw);
+  switch (len_rw & 0x3)
+    {
+      case DR_RW_EXECUTE:
+	*type_p = hw_execute;
+	break;
+      case DR_RW_WRITE:
+	*type_p = hw_write;
+	break;
+      default:
+	*type_p = hw_access;
+	break;
+    }
+
+  return 1;
+}
+
 /* If the inferior has some break/watchpoint that triggered, set the
    address associated with that break/watchpoint and return non-zero.
    Otherwise, return zero.  */
@@ -30,7 +30,9 @@
 
    The functions below implement debug registers sharing by reference
    counts, and allow to watch regions up to 16 bytes long
-   (32 bytes on 64 bit hosts).  */
+   (32 bytes on 64 bit hosts).  When the client allows it, regions
+   that don't fit in the debug registers otherwise are coalesced into
+   fewer, larger registers.  */
 
 
 #include "gdbsupport/break-common.h" /* target_hw_bp_type */
@@ -62,6 +64,15 @@ struct x86_dr_low_type
 
     /* Number of bytes used for debug registers (4 or 8).  */
     int debug_register_length;
+
+    /* Non-zero if regions that don't otherwise fit in the debug
+       registers may share them, or be watched by a register covering
+       more than the region.  The address reported for a triggered
+       watchpoint is then the start of the register's cover, which
+       may lie outside the region that triggered, so a client setting
+       this must check watchpoint hits with
+       x86_dr_watchpoint_addr_within_range.  */
+    int coalesce_regions;
   };
 
 extern struct x86_dr_low_type x86_dr_low;
@@ -73,6 +84,25 @@ extern struct x86_dr_low_type x86_dr_low;
 #define DR_STATUS    6	/* Index of debug status register (DR6).  */
 #define DR_CONTROL   7	/* Index of debug control register (DR7).  */
 
+/* The maximum number of distinct regions the debug registers can be
+   asked to watch at the same time.  Several regions can share one
+   debug register, so this is larger than DR_NADDR.  */
+#define X86_DR_MAX_REGIONS 32
+
+/* A region of memory the client asked to watch, or the address of a
+   hardware breakpoint.  */
+
+struct x86_dr_region
+{
+  CORE_ADDR addr;
+  int len;
+  enum target_hw_bp_type type;
+
+  /* Number of insertions of this exact region.  Zero if this slot is
+     unused.  */
+  int ref_count;
+};
+
 /* Global state needed to track h/w watchpoints.  */
 
 struct x86_debug_reg_state
@@ -85,8 +115,14 @@ struct x86_debug_reg_state
   CORE_ADDR dr_mirror[DR_NADDR];
   unsigned dr_status_mirror, dr_control_mirror;
 
-  /* Reference counts for each debug address register.  */
+  /* Reference counts for each debug address register: the number of
+     insertions of the regions it covers.  */
   int dr_ref_count[DR_NADDR];
+
+  /* The regions the debug registers currently watch.  The debug
+     registers are allocated from scratch from these whenever one is
+     inserted or removed.  */
+  struct x86_dr_region regions[X86_DR_MAX_REGIONS];
 };
 
 /* A macro to loop over all debug address registers.  */
@@ -119,6 +155,20 @@ extern int x86_dr_remove_watchpoint (struct x86_debug_reg_state *state,
 extern int x86_dr_region_ok_for_watchpoint (struct x86_debug_reg_state *state,
 					    CORE_ADDR addr, int len);
 
+/* Return non-zero if a watchpoint hit at ADDR, as reported by
+   x86_dr_stopped_data_address, should be considered a hit of the
+   watchpoint watching the LENGTH bytes at START.  */
+extern int x86_dr_watchpoint_addr_within_range
+  (struct x86_debug_reg_state *state, CORE_ADDR addr, CORE_ADDR start,
+   int length);
+
+/* If debug address register I of STATE is in use, set *ADDR_P,
+   *LEN_P and *TYPE_P to the region it covers and the type of accesses
+   it traps, and return non-zero.  Otherwise return zero.  */
+extern int x86_dr_get_cover (struct x86_debug_reg_state *state, int i,
+			     CORE_ADDR *addr_p, int *len_p,
+			     enum target_hw_bp_type *type_p);
+
 /* If the inferior has some break/watchpoint that triggered, set the
    address associated with that break/watchpoint and return true.
    Otherwise, return false.  */
@@ -0,0 +1,832 @@
+/* Native pretty-printers for GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "native-printers.h"
+#include "gdbtypes.h"
+#include "value.h"
+#include "valprint.h"
+#include "gdbcore.h"
+#include "gdbcmd.h"
+#include "language.h"
+#include "cli/cli-style.h"
+
+/* The printers of the C++ standard library below decode the layouts
+   of libstdc++'s containers, and print them as the Python printers
+   shipped with GCC do, for when those aren't loaded.  Values laid out
+   otherwise are left to GDB.  */
+
+/* Whether native printers are used.  */
+
+static bool native_printers_enabled = false;
+
+/* A registered native printer.  */
+
+struct native_printer_entry
+{
+  /* The prefix of the type names the printer handles.  */
+  const char *prefix;
+
+  /* The function making the printer.  */
+  native_printer_lookup_ftype *lookup;
+};
+
+/* All the registered native printers.  */
+
+static std::vector<native_printer_entry> native_printers;
+
+/* See native-printers.h.  */
+
+void
+register_native_printer (const char *prefix,
+			 native_printer_lookup_ftype *lookup)
+{
+  native_printers.push_back ({prefix, lookup});
+}
+
+/* Return the native printer registered for TYPE, or NULL.  */
+
+static native_printer_lookup_ftype *
+find_native_printer (struct type *type)
+{
+  type = check_typedef (type);
+  if (TYPE_CODE (type) != TYPE_CODE_STRUCT || TYPE_NAME (type) == NULL)
+    return NULL;
+
+  for (const native_printer_entry &entry : native_printers)
+    if (startswith (TYPE_NAME (type), entry.prefix))
+      return entry.lookup;
+
+  return NULL;
+}
+
+/* Print the children of the value printed by PRINTER, formatting them
+   as print_children in python/py-prettyprint.c does.  */
+
+static void
+print_native_children (native_printer *printer, struct ui_file *stream,
+		       int recurse, const struct value_print_options *options,
+		       const struct language_defn *language)
+{
+  const char *hint = printer->display_hint ();
+  bool is_map = hint != NULL && strcmp (hint, "map") == 0;
+  bool is_array = hint != NULL && strcmp (hint, "array") == 0;
+  bool done = false;
+  int pretty;
+  unsigned int i;
+
+  /* Use the prettyformat_arrays option if we are printing an array,
+     and the pretty option otherwise.  */
+  if (is_array)
+    pretty = options->prettyformat_arrays;
+  else if (options->prettyformat == Val_prettyformat)
+    pretty = 1;
+  else
+    pretty = options->prettyformat_structs;
+
+  for (i = 0; i < options->print_max; ++i)
+    {
+      std::string name;
+      struct value *child;
+
+      try
+	{
+	  child = printer->next_child (&name);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  fprintf_styled (stream, metadata_style.style (),
+			  _("<error reading variable: %s>"), ex.what ());
+	  break;
+	}
+
+      if (child == NULL)
+	{
+	  done = true;
+	  break;
+	}
+
+      if (i == 0)
+	fputs_filtered (" = {", stream);
+      else if (!is_map || i % 2 == 0)
+	fputs_filtered (pretty ? "," : ", ", stream);
+
+      /* In summary mode, we just want to print "= {...}" if there is
+	 a value.  */
+      if (options->summary)
+	{
+	  ++i;
+	  pretty = 0;
+	  break;
+	}
+
+      if (!is_map || i % 2 == 0)
+	{
+	  if (pretty)
+	    {
+	      fputs_filtered ("\n", stream);
+	      print_spaces_filtered (2 + 2 * recurse, stream);
+	    }
+	  else
+	    wrap_here (n_spaces (2 + 2 * recurse));
+	}
+
+      if (is_map && i % 2 == 0)
+	fputs_filtered ("[", stream);
+      else if (is_array)
+	{
+	  if (options->print_array_indexes)
+	    fprintf_filtered (stream, "[%d] = ", i);
+	}
+      else if (!is_map)
+	{
+	  fputs_filtered (name.c_str (), stream);
+	  fputs_filtered (" = ", stream);
+	}
+
+      /* When printing the key of a map we allow one additional level
+	 of depth.  This means the key will print before the value
+	 does.  */
+      struct value_print_options opts = *options;
+      if (is_map && i % 2 == 0
+	  && opts.max_depth != -1
+	  && opts.max_depth < INT_MAX)
+	++opts.max_depth;
+      common_val_print (child, stream, recurse + 1, &opts, language);
+
+      if (is_map && i % 2 == 0)
+	fputs_filtered ("] = ", stream);
+    }
+
+  if (i > 0)
+    {
+      if (!done)
+	{
+	  if (pretty)
+	    {
+	      fputs_filtered ("\n", stream);
+	      print_spaces_filtered (2 + 2 * recurse, stream);
+	    }
+	  fputs_filtered ("...", stream);
+	}
+      if (pretty)
+	{
+	  fputs_filtered ("\n", stream);
+	  print_spaces_filtered (2 * recurse, stream);
+	}
+      fputs_filtered ("}", stream);
+    }
+}
+
+/* See native-printers.h.  */
+
+std::unique_ptr<native_printer>
+make_native_printer (struct value *val)
+{
+  if (!native_printers_enabled)
+    return NULL;
+
+  native_printer_lookup_ftype *lookup = find_native_printer (value_type (val));
+  if (lookup == NULL)
+    return NULL;
+
+  try
+    {
+      return lookup (val);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Not laid out as expected.  */
+      return NULL;
+    }
+}
+
+/* See native-printers.h.  */
+
+bool
+apply_native_val_pretty_printer (struct type *type,
+				 LONGEST embedded_offset, CORE_ADDR address,
+				 struct ui_file *stream, int recurse,
+				 struct value *val,
+				 const struct value_print_options *options,
+				 const struct language_defn *language)
+{
+  if (!native_printers_enabled || find_native_printer (type) == NULL)
+    return false;
+
+  /* Read just the container itself if VAL is being read in parts;
+     its elements are read by the printer.  */
+  value_fetch_lazy_range (val, embedded_offset, TYPE_LENGTH (type));
+  if (!value_bytes_available (val, embedded_offset, TYPE_LENGTH (type))
+      || value_bits_any_optimized_out (val,
+				       TARGET_CHAR_BIT * embedded_offset,
+				       TARGET_CHAR_BIT * TYPE_LENGTH (type)))
+    return false;
+
+  struct value *value = value_from_component (val, type, embedded_offset);
+
+  std::unique_ptr<native_printer> printer = make_native_printer (value);
+  if (printer == NULL)
+    return false;
+
+  if (val_print_check_max_depth (stream, recurse, options, language))
+    return true;
+
+  printer->to_string (stream, options);
+  print_native_children (printer.get (), stream, recurse, options, language);
+  return true;
+}
+
+/* Return the member NAME of the structure VAL.  Throw if there is no
+   such member.  */
+
+static struct value *
+member (struct value *val, const char *name)
+{
+  return value_struct_elt (&val, NULL, name, NULL, "native printer");
+}
+
+/* Return the type of template argument N of TYPE, or NULL if TYPE has
+   no such argument, or if it isn't a type.  */
+
+static struct type *
+template_type_argument (struct type *type, int n)
+{
+  type = check_typedef (type);
+  if (n >= TYPE_N_TEMPLATE_ARGUMENTS (type))
+    return NULL;
+
+  struct symbol *sym = TYPE_TEMPLATE_ARGUMENT (type, n);
+  if (SYMBOL_CLASS (sym) != LOC_TYPEDEF)
+    return NULL;
+  return SYMBOL_TYPE (sym);
+}
+
+/* Return the index of the field NAME of the structure TYPE, not
+   looking in its base classes, or -1 if there is no such field.  */
+
+static int
+field_index (struct type *type, const char *name)
+{
+  type = check_typedef (type);
+  for (int i = TYPE_N_BASECLASSES (type); i < TYPE_NFIELDS (type); i++)
+    if (!field_is_static (&TYPE_FIELD (type, i))
+	&& TYPE_FIELD_NAME (type, i) != NULL
+	&& strcmp (TYPE_FIELD_NAME (type, i), name) == 0)
+      return i;
+  return -1;
+}
+
+/* Return the number of objects of type ELTTYPE between pointers FIRST
+   and LAST, or -1 if that isn't a whole number of them.  */
+
+static LONGEST
+pointer_distance (CORE_ADDR first, CORE_ADDR last, struct type *elttype)
+{
+  LONGEST eltlen = TYPE_LENGTH (check_typedef (elttype));
+
+  if (eltlen == 0 || last < first || (last - first) % eltlen != 0)
+    return -1;
+  return (last - first) / eltlen;
+}
+
+/* The printer of std::vector.  */
+
+class vector_printer : public native_printer
+{
+public:
+
+  vector_printer (LONGEST length, LONGEST capacity,
+		  struct type *elttype, CORE_ADDR start)
+    : m_length (length), m_capacity (capacity)
+  {
+    if (length > 0)
+      {
+	struct type *array_type
+	  = lookup_array_range_type (elttype, 0, length - 1);
+	m_elements.reset
+	  (new array_element_reader (value_at_lazy (array_type, start)));
+      }
+  }
+
+  void to_string (struct ui_file *stream,
+		  const struct value_print_options *options) override
+  {
+    fprintf_filtered (stream, "std::vector of length %s, capacity %s",
+		      plongest (m_length), plongest (m_capacity));
+  }
+
+  bool has_children () const override
+  {
+    return true;
+  }
+
+  struct value *next_child (std::string *name) override
+  {
+    if (m_next >= m_length)
+      return NULL;
+
+    *name = string_printf ("[%s]", plongest (m_next));
+    return m_elements->element (m_next++);
+  }
+
+  const char *display_hint () const override
+  {
+    return "array";
+  }
+
+private:
+
+  LONGEST m_length, m_capacity;
+
+  /* Reads the elements, a chunk at a time.  */
+  std::unique_ptr<array_element_reader> m_elements;
+
+  /* The index of the next child.  */
+  LONGEST m_next = 0;
+};
+
+static std::unique_ptr<native_printer>
+make_vector_printer (struct value *val)
+{
+  /* std::vector<bool> packs its elements in bits.  */
+  if (startswith (TYPE_NAME (check_typedef (value_type (val))),
+		  "std::vector<bool,"))
+    return NULL;
+
+  struct value *impl = member (val, "_M_impl");
+  struct value *start = member (impl, "_M_start");
+  struct type *ptr_type = check_typedef (value_type (start));
+  if (TYPE_CODE (ptr_type) != TYPE_CODE_PTR)
+    return NULL;
+  struct type *elttype = TYPE_TARGET_TYPE (ptr_type);
+
+  CORE_ADDR first = value_as_address (start);
+  LONGEST length
+    = pointer_distance (first, value_as_address (member (impl, "_M_finish")),
+			elttype);
+  LONGEST capacity
+    = pointer_distance (first,
+			value_as_address (member (impl,
+						  "_M_end_of_storage")),
+			elttype);
+  if (length < 0 || capacity < length)
+    return NULL;
+
+  return std::unique_ptr<native_printer>
+    (new vector_printer (length, capacity, elttype, first));
+}
+
+/* The printer of std::basic_string, with the layout of libstdc++'s
+   C++11 ABI.  */
+
+class string_printer : public native_printer
+{
+public:
+
+  string_printer (struct type *char_type, CORE_ADDR address, int length)
+    : m_char_type (char_type), m_address (address), m_length (length)
+  {
+  }
+
+  void to_string (struct ui_file *stream,
+		  const struct value_print_options *options) override
+  {
+    struct value_print_options opts = *options;
+
+    opts.addressprint = 0;
+    val_print_string (m_char_type, NULL, m_address, m_length, stream, &opts);
+  }
+
+  const char *display_hint () const override
+  {
+    return "string";
+  }
+
+private:
+
+  struct type *m_char_type;
+  CORE_ADDR m_address;
+  int m_length;
+};
+
+static std::unique_ptr<native_printer>
+make_string_printer (struct value *val)
+{
+  struct value *p = member (member (val, "_M_dataplus"), "_M_p");
+  struct type *ptr_type = check_typedef (value_type (p));
+  if (TYPE_CODE (ptr_type) != TYPE_CODE_PTR)
+    return NULL;
+
+  LONGEST length = value_as_long (member (val, "_M_string_length"));
+  if (length < 0 || length > INT_MAX)
+    return NULL;
+
+  return std::unique_ptr<native_printer>
+    (new string_printer (TYPE_TARGET_TYPE (ptr_type), value_as_address (p),
+			 length));
+}
+
+/* The printer of std::shared_ptr and std::weak_ptr.  */
+
+class shared_ptr_printer : public native_printer
+{
+public:
+
+  shared_ptr_printer (std::string &&summary, struct value *pointer)
+    : m_summary (std::move (summary)),
+      m_pointer (value_ref_ptr::new_reference (pointer))
+  {
+  }
+
+  void to_string (struct ui_file *stream,
+		  const struct value_print_options *options) override
+  {
+    fputs_filtered (m_summary.c_str (), stream);
+  }
+
+  bool has_children () const override
+  {
+    return true;
+  }
+
+  struct value *next_child (std::string *name) override
+  {
+    if (m_done)
+      return NULL;
+
+    m_done = true;
+    *name = "get()";
+    return m_pointer.get ();
+  }
+
+private:
+
+  std::string m_summary;
+  value_ref_ptr m_pointer;
+
+  /* Whether the only child has been returned.  */
+  bool m_done = false;
+};
+
+/* Make the printer of VAL, a KIND, std::shared_ptr or
+   std::weak_ptr.  */
+
+static std::unique_ptr<native_printer>
+make_shared_ptr_printer (struct value *val, const char *kind)
+{
+  struct type *target = template_type_argument (value_type (val), 0);
+  if (target == NULL)
+    return NULL;
+
+  struct value *pointer = member (val, "_M_ptr");
+  struct value *pi = member (member (val, "_M_refcount"), "_M_pi");
+  std::string state;
+
+  if (value_as_address (pi) == 0)
+    state = "empty";
+  else
+    {
+      struct value *counted = value_ind (pi);
+      LONGEST use = value_as_long (member (counted, "_M_use_count"));
+      LONGEST weak = value_as_long (member (counted, "_M_weak_count"));
+
+      if (use == 0)
+	state = string_printf ("expired, weak count %s", plongest (weak));
+      else
+	state = string_printf ("use count %s, weak count %s",
+			       plongest (use), plongest (weak - 1));
+    }
+
+  std::string summary = string_printf ("%s<%s> (%s)", kind,
+				       type_to_string (target).c_str (),
+				       state.c_str ());
+  return std::unique_ptr<native_printer>
+    (new shared_ptr_printer (std::move (summary), pointer));
+}
+
+static std::unique_ptr<native_printer>
+make_std_shared_ptr_printer (struct value *val)
+{
+  return make_shared_ptr_printer (val, "std::shared_ptr");
+}
+
+static std::unique_ptr<native_printer>
+make_std_weak_ptr_printer (struct value *val)
+{
+  return make_shared_ptr_printer (val, "std::weak_ptr");
+}
+
+/* The printer of std::unordered_map.  */
+
+class unordered_map_printer : public native_printer
+{
+public:
+
+  unordered_map_printer (LONGEST count, CORE_ADDR first_node,
+			 struct type *node_ptr_type, struct type *pair_type,
+			 LONGEST pair_offset, int first_field, int second_field)
+    : m_count (count), m_node (first_node), m_node_ptr_type (node_ptr_type),
+      m_pair_type (pair_type), m_pair_offset (pair_offset),
+      m_first_field (first_field), m_second_field (second_field)
+  {
+  }
+
+  void to_string (struct ui_file *stream,
+		  const struct value_print_options *options) override
+  {
+    fprintf_filtered (stream, "std::unordered_map with %s %s",
+		      plongest (m_count),
+		      m_count == 1 ? "element" : "elements");
+  }
+
+  bool has_children () const override
+  {
+    return true;
+  }
+
+  struct value *next_child (std::string *name) override
+  {
+    struct value *child;
+
+    if (m_mapped != NULL)
+      {
+	/* The value of the last key returned.  */
+	child = m_mapped.release ();
+	value_decref (child);
+      }
+    else
+      {
+	if (m_node == 0)
+	  return NULL;
+
+	/* Read the link to the next node and the key/value pair at
+	   once.  */
+	struct type *type = check_typedef (m_pair_type);
+	gdb::byte_vector buf (m_pair_offset + TYPE_LENGTH (type));
+	read_memory (m_node, buf.data (), buf.size ());
+
+	struct value *pair
+	  = value_from_contents_and_address (m_pair_type,
+					     buf.data () + m_pair_offset,
+					     m_node + m_pair_offset);
+	m_node = extract_typed_address (buf.data (), m_node_ptr_type);
+
+	child = value_primitive_field (pair, 0, m_first_field, type);
+	m_mapped = value_ref_ptr::new_reference
+	  (value_primitive_field (pair, 0, m_second_field, type));
+      }
+
+    *name = string_printf ("[%s]", plongest (m_next++));
+    return child;
+  }
+
+  const char *display_hint () const override
+  {
+    return "map";
+  }
+
+private:
+
+  LONGEST m_count;
+
+  /* The address of the next node, and the type of the pointers to
+     the nodes.  */
+  CORE_ADDR m_node;
+  struct type *m_node_ptr_type;
+
+  /* The type of the key/value pairs, and their offset in the
+     nodes.  */
+  struct type *m_pair_type;
+  LONGEST m_pair_offset;
+
+  /* The indices of the pairs' "first" and "second" fields.  */
+  int m_first_field, m_second_field;
+
+  /* The value to return next, after its key was returned.  */
+  value_ref_ptr m_mapped;
+
+  /* The index of the next child.  */
+  LONGEST m_next = 0;
+};
+
+static std::unique_ptr<native_printer>
+make_unordered_map_printer (struct value *val)
+{
+  struct value *h = member (val, "_M_h");
+  struct type *pair_type = template_type_argument (value_type (h), 1);
+  if (pair_type == NULL)
+    return NULL;
+
+  LONGEST count = value_as_long (member (h, "_M_element_count"));
+  struct value *first = member (member (h, "_M_before_begin"), "_M_nxt");
+  struct type *node_ptr_type = check_typedef (value_type (first));
+  unsigned align = type_align (pair_type);
+  int first_field = field_index (pair_type, "first");
+  int second_field = field_index (pair_type, "second");
+  if (count < 0 || TYPE_CODE (node_ptr_type) != TYPE_CODE_PTR || align == 0
+      || first_field < 0 || second_field < 0)
+    return NULL;
+
+  /* The pair follows the link to the next node.  */
+  LONGEST offset = align_up (TYPE_LENGTH (node_ptr_type), align);
+
+  return std::unique_ptr<native_printer>
+    (new unordered_map_printer (count, value_as_address (first),
+				node_ptr_type, pair_type, offset,
+				first_field, second_field));
+}
+
+/* The printer of std::deque.  */
+
+class deque_printer : public native_printer
+{
+public:
+
+  deque_printer (LONGEST size, struct type *ptr_type,
+		 LONGEST buffer_size, CORE_ADDR node, CORE_ADDR cur,
+		 CORE_ADDR last, CORE_ADDR finish_node, CORE_ADDR finish)
+    : m_size (size), m_ptr_type (ptr_type),
+      m_elttype (TYPE_TARGET_TYPE (ptr_type)),
+      m_buffer_size (buffer_size), m_node (node), m_cur (cur),
+      m_last (last), m_finish_node (finish_node), m_finish (finish)
+  {
+  }
+
+  void to_string (struct ui_file *stream,
+		  const struct value_print_options *options) override
+  {
+    fprintf_filtered (stream, "std::deque with %s %s",
+		      plongest (m_size),
+		      m_size == 1 ? "element" : "elements");
+  }
+
+  bool has_children () const override
+  {
+    return true;
+  }
+
+  struct value *next_child (std::string *name) override
+  {
+    if (m_cur == m_finish)
+      return NULL;
+
+    LONGEST eltlen = TYPE_LENGTH (check_typedef (m_elttype));
+
+    /* Read the rest of the current buffer at once.  */
+    if (m_buffer == NULL)
+      {
+	CORE_ADDR end = m_node == m_finish_node ? m_finish : m_last;
+	struct type *array_type
+	  = lookup_array_range_type (m_elttype, 0,
+				     (end - m_cur) / eltlen - 1);
+	m_buffer = value_ref_ptr::new_reference (value_at (array_type,
+							   m_cur));
+	m_buffer_start = m_cur;
+      }
+
+    struct value *child = value_from_component (m_buffer.get (), m_elttype,
+						m_cur - m_buffer_start);
+
+    m_cur += eltlen;
+    if (m_cur == m_last && m_node != m_finish_node)
+      {
+	/* On to the next buffer.  */
+	m_node += TYPE_LENGTH (m_ptr_type);
+	m_cur = read_memory_typed_address (m_node, m_ptr_type);
+	m_last = m_cur + m_buffer_size * eltlen;
+	m_buffer = NULL;
+      }
+
+    *name = string_printf ("[%s]", plongest (m_next++));
+    return child;
+  }
+
+  const char *display_hint () const override
+  {
+    return "array";
+  }
+
+private:
+
+  LONGEST m_size;
+
+  /* The type of the pointers to the elements, and that of the
+     elements.  */
+  struct type *m_ptr_type;
+  struct type *m_elttype;
+
+  /* The number of elements per buffer.  */
+  LONGEST m_buffer_size;
+
+  /* The address of the map entry pointing to the current buffer, the
+     address of the next element, and the end of the current
+     buffer.  */
+  CORE_ADDR m_node, m_cur, m_last;
+
+  /* The map entry of the last buffer, and the end of the deque's
+     elements.  */
+  CORE_ADDR m_finish_node, m_finish;
+
+  /* The part of the current buffer left when it was entered, and its
+     address.  */
+  value_ref_ptr m_buffer;
+  CORE_ADDR m_buffer_start = 0;
+
+  /* The index of the next child.  */
+  LONGEST m_next = 0;
+};
+
+static std::unique_ptr<native_printer>
+make_deque_printer (struct value *val)
+{
+  struct value *impl = member (val, "_M_impl");
+  struct value *start = member (impl, "_M_start");
+  struct value *finish = member (impl, "_M_finish");
+
+  struct value *start_cur = member (start, "_M_cur");
+  struct type *ptr_type = check_typedef (value_type (start_cur));
+  if (TYPE_CODE (ptr_type) != TYPE_CODE_PTR)
+    return NULL;
+  struct type *elttype = TYPE_TARGET_TYPE (ptr_type);
+  LONGEST eltlen = TYPE_LENGTH (check_typedef (elttype));
+  if (eltlen == 0)
+    return NULL;
+
+  /* libstdc++'s __deque_buf_size.  */
+  LONGEST buffer_size = eltlen < 512 ? 512 / eltlen : 1;
+
+  CORE_ADDR cur = value_as_address (start_cur);
+  CORE_ADDR last = value_as_address (member (start, "_M_last"));
+  CORE_ADDR node = value_as_address (member (start, "_M_node"));
+  CORE_ADDR finish_cur = value_as_address (member (finish, "_M_cur"));
+  CORE_ADDR finish_first = value_as_address (member (finish, "_M_first"));
+  CORE_ADDR finish_node = value_as_address (member (finish, "_M_node"));
+
+  LONGEST nodes = pointer_distance (node, finish_node, ptr_type);
+  LONGEST in_first = pointer_distance (cur, last, elttype);
+  LONGEST in_last = pointer_distance (finish_first, finish_cur, elttype);
+  if (nodes < 0 || in_first < 0 || in_last < 0)
+    return NULL;
+
+  LONGEST size;
+  if (nodes == 0)
+    size = pointer_distance (cur, finish_cur, elttype);
+  else
+    size = buffer_size * (nodes - 1) + in_first + in_last;
+  if (size < 0)
+    return NULL;
+
+  return std::unique_ptr<native_printer>
+    (new deque_printer (size, ptr_type, buffer_size, node, cur, last,
+			finish_node, finish_cur));
+}
+
+/* Implement "show print native-printers".  */
+
+static void
+show_native_printers (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Printing with native pretty-printers is %s.\n"),
+		    value);
+}
+
+void
+_initialize_native_printers ()
+{
+  register_native_printer ("std::vector<", make_vector_printer);
+  register_native_printer ("std::__cxx11::basic_string<",
+			   make_string_printer);
+  register_native_printer ("std::shared_ptr<", make_std_shared_ptr_printer);
+  register_native_printer ("std::weak_ptr<", make_std_weak_ptr_printer);
+  register_native_printer ("std::unordered_map<", make_unordered_map_printer);
+  register_native_printer ("std::deque<", make_deque_printer);
+
+  add_setshow_boolean_cmd ("native-printers", class_support,
+			   &native_printers_enabled, _("\
+Set printing with native pretty-printers."), _("\
+Show printing with native pretty-printers."), _("\
+When on, values of some common C++ standard library types that no\n\
+extension language pretty-printer handles are printed by pretty-printers\n\
+built into GDB."),
+			   NULL,
+			   show_native_printers,
+			   &setprintlist, &showprintlist);
+}
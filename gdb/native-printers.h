@@ -0,0 +1,95 @@
+/* Native pretty-printers for GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef NATIVE_PRINTERS_H
+#define NATIVE_PRINTERS_H
+
+struct value_print_options;
+struct language_defn;
+
+/* A pretty-printer written in C++.  It prints a value the way a
+   Python pretty-printer with "to_string", "children" and
+   "display_hint" methods would, without going through Python.  Native
+   printers exist for types that are common enough, and have children
+   numerous enough, to make printing them in Python slow.  They are
+   only used if "set print native-printers" is on, and no extension
+   language printer handles the value.  */
+
+class native_printer
+{
+public:
+
+  virtual ~native_printer () = default;
+
+  /* Print the summary of the value to STREAM, like the "to_string"
+     method of a Python printer.  */
+  virtual void to_string (struct ui_file *stream,
+			  const struct value_print_options *options) = 0;
+
+  /* Whether the value has children, like a Python printer with a
+     "children" method.  */
+  virtual bool has_children () const
+  {
+    return false;
+  }
+
+  /* Return the next child of the value and set *NAME to its name, or
+     return NULL if there are no more children.  */
+  virtual struct value *next_child (std::string *name)
+  {
+    return NULL;
+  }
+
+  /* Like the "display_hint" method of a Python printer.  */
+  virtual const char *display_hint () const
+  {
+    return NULL;
+  }
+};
+
+/* A function making a native printer for VAL.  It returns NULL, or
+   throws, if VAL isn't laid out as the printer expects; VAL is then
+   printed by GDB.  */
+
+typedef std::unique_ptr<native_printer> native_printer_lookup_ftype
+  (struct value *val);
+
+/* Register LOOKUP as the native printer of the structures whose type
+   name, with typedefs stripped, starts with PREFIX.  */
+
+extern void register_native_printer (const char *prefix,
+				     native_printer_lookup_ftype *lookup);
+
+/* Return the native printer of VAL, or NULL if native printers are
+   off, or if VAL has none or isn't laid out as it expects.  */
+
+extern std::unique_ptr<native_printer> make_native_printer
+  (struct value *val);
+
+/* Try to print a value of type TYPE with a native printer.  The
+   arguments are those of apply_ext_lang_val_pretty_printer.  Return
+   true if the value was printed.  */
+
+extern bool apply_native_val_pretty_printer
+  (struct type *type, LONGEST embedded_offset, CORE_ADDR address,
+   struct ui_file *stream, int recurse, struct value *val,
+   const struct value_print_options *options,
+   const struct language_defn *language);
+
+#endif /* NATIVE_PRINTERS_H */
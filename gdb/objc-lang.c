@@ -410,7 +410,8 @@ extern const struct language_defn objc_language_defn = {
   NULL,
   NULL,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
 
 /*
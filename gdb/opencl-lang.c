@@ -1089,7 +1089,8 @@ extern const struct language_defn opencl_language_defn =
   NULL,
   NULL,
   c_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  true				/* la_val_print_fetches_in_parts */
 };
 
 static void *
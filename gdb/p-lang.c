@@ -475,5 +475,6 @@ extern const struct language_defn pascal_language_defn =
   NULL,
   NULL,
   pascal_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
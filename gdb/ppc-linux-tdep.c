@@ -2146,6 +2146,8 @@ ppc_linux_init_abi (struct gdbarch_info info,
 
   set_gdbarch_displaced_step_location (gdbarch,
 				       linux_displaced_step_location);
+  set_gdbarch_displaced_step_buffer_count (gdbarch,
+					   linux_displaced_step_buffer_count);
 
   /* Support reverse debugging.  */
   set_gdbarch_process_record (gdbarch, ppc_process_record);
@@ -346,6 +346,27 @@ print_string_repr (PyObject *printer, const char *hint,
   return result;
 }
 
+/* See python-internal.h.  */
+
+std::unique_ptr<array_element_reader>
+gdbpy_children_array (PyObject *children)
+{
+  if (!gdbpy_is_value_object (children))
+    return NULL;
+
+  struct value *array = value_object_to_value (children);
+  struct type *type = check_typedef (value_type (array));
+  LONGEST low, high;
+
+  if (TYPE_CODE (type) != TYPE_CODE_ARRAY
+      || TYPE_LENGTH (check_typedef (TYPE_TARGET_TYPE (type))) == 0
+      || get_array_bounds (type, &low, &high) == 0)
+    return NULL;
+
+  return std::unique_ptr<array_element_reader>
+    (new array_element_reader (array));
+}
+
 /* Helper for gdbpy_apply_val_pretty_printer that formats children of the
    printer, if any exist.  If is_py_none is true, then nothing has
    been printed by to_string, and format output accordingly. */
@@ -375,11 +396,19 @@ print_children (PyObject *printer, const char *hint,
       return;
     }
 
-  gdbpy_ref<> iter (PyObject_GetIter (children.get ()));
-  if (iter == NULL)
+  /* Children given as an array are read and printed here, without
+     going through Python for each of them.  */
+  std::unique_ptr<array_element_reader> array
+    = gdbpy_children_array (children.get ());
+  gdbpy_ref<> iter;
+  if (array == NULL)
     {
-      print_stack_unless_memory_error (stream);
-      return;
+      iter.reset (PyObject_GetIter (children.get ()));
+      if (iter == NULL)
+	{
+	  print_stack_unless_memory_error (stream);
+	  return;
+	}
     }
 
   /* Use the prettyformat_arrays option if we are printing an array,
@@ -397,38 +426,71 @@ print_children (PyObject *printer, const char *hint,
   done_flag = 0;
   for (i = 0; i < options->print_max; ++i)
     {
-      PyObject *py_v;
+      PyObject *py_v = NULL;
       const char *name;
+      std::string array_name;
+      struct value *array_value = NULL;
+      gdbpy_ref<> item;
 
-      gdbpy_ref<> item (PyIter_Next (iter.get ()));
-      if (item == NULL)
+      if (array != NULL)
 	{
-	  if (PyErr_Occurred ())
-	    print_stack_unless_memory_error (stream);
-	  /* Set a flag so we can know whether we printed all the
-	     available elements.  */
-	  else	
-	    done_flag = 1;
-	  break;
-	}
+	  if (i >= array->count ())
+	    {
+	      done_flag = 1;
+	      break;
+	    }
 
-      if (! PyTuple_Check (item.get ()) || PyTuple_Size (item.get ()) != 2)
-	{
-	  PyErr_SetString (PyExc_TypeError,
-			   _("Result of children iterator not a tuple"
-			     " of two elements."));
-	  gdbpy_print_stack ();
-	  continue;
+	  /* Stop at an element that can't be read, as a memory error
+	     from the children iterator does.  */
+	  try
+	    {
+	      array_value = array->element (i);
+	    }
+	  catch (const gdb_exception_error &except)
+	    {
+	      fprintf_styled (stream, metadata_style.style (),
+			      _("<error reading variable: %s>"),
+			      except.what ());
+	      break;
+	    }
+
+	  array_name = string_printf ("[%s]",
+				      plongest (array->low_bound () + i));
+	  name = array_name.c_str ();
 	}
-      if (! PyArg_ParseTuple (item.get (), "sO", &name, &py_v))
+      else
 	{
-	  /* The user won't necessarily get a stack trace here, so provide
-	     more context.  */
-	  if (gdbpy_print_python_errors_p ())
-	    fprintf_unfiltered (gdb_stderr,
-				_("Bad result from children iterator.\n"));
-	  gdbpy_print_stack ();
-	  continue;
+	  item.reset (PyIter_Next (iter.get ()));
+	  if (item == NULL)
+	    {
+	      if (PyErr_Occurred ())
+		print_stack_unless_memory_error (stream);
+	      /* Set a flag so we can know whether we printed all the
+		 available elements.  */
+	      else
+		done_flag = 1;
+	      break;
+	    }
+
+	  if (! PyTuple_Check (item.get ())
+	      || PyTuple_Size (item.get ()) != 2)
+	    {
+	      PyErr_SetString (PyExc_TypeError,
+			       _("Result of children iterator not a tuple"
+				 " of two elements."));
+	      gdbpy_print_stack ();
+	      continue;
+	    }
+	  if (! PyArg_ParseTuple (item.get (), "sO", &name, &py_v))
+	    {
+	      /* The user won't necessarily get a stack trace here, so
+		 provide more context.  */
+	      if (gdbpy_print_python_errors_p ())
+		fprintf_unfiltered (gdb_stderr,
+				    _("Bad result from children iterator.\n"));
+	      gdbpy_print_stack ();
+	      continue;
+	    }
 	}
 
       /* Print initial "{".  For other elements, there are three
@@ -485,7 +547,7 @@ print_children (PyObject *printer, const char *hint,
 	  fputs_filtered (" = ", stream);
 	}
 
-      if (gdbpy_is_lazy_string (py_v))
+      if (array == NULL && gdbpy_is_lazy_string (py_v))
 	{
 	  CORE_ADDR addr;
 	  struct type *type;
@@ -499,7 +561,7 @@ print_children (PyObject *printer, const char *hint,
 	  val_print_string (type, encoding.get (), addr, (int) length, stream,
 			    &local_opts);
 	}
-      else if (gdbpy_is_string (py_v))
+      else if (array == NULL && gdbpy_is_string (py_v))
 	{
 	  gdb::unique_xmalloc_ptr<char> output;
 
@@ -511,7 +573,9 @@ print_children (PyObject *printer, const char *hint,
 	}
       else
 	{
-	  struct value *value = convert_value_from_python (py_v);
+	  struct value *value = (array != NULL
+				 ? array_value
+				 : convert_value_from_python (py_v));
 
 	  if (value == NULL)
 	    {
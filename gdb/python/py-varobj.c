@@ -17,6 +17,8 @@
 #include "python-internal.h"
 #include "varobj.h"
 #include "varobj-iter.h"
+#include "language.h"
+#include "valprint.h"
 
 /* A dynamic varobj iterator "class" for python pretty-printed
    varobjs.  This inherits struct varobj_iter.  */
@@ -29,6 +31,10 @@ struct py_varobj_iter
   /* The python iterator returned by the printer's 'children' method,
      or NULL if not available.  */
   PyObject *iter;
+
+  /* The children, if the printer's 'children' method returned an
+     array rather than an iterable.  */
+  array_element_reader *array;
 };
 
 /* Implementation of the 'dtor' method of pretty-printed varobj
@@ -40,6 +46,46 @@ py_varobj_iter_dtor (struct varobj_iter *self)
   struct py_varobj_iter *dis = (struct py_varobj_iter *) self;
   gdbpy_enter_varobj enter_py (self->var);
   Py_XDECREF (dis->iter);
+  delete dis->array;
+}
+
+/* Implementation of the 'next' method of pretty-printed varobj
+   iterators whose children are the elements of an array.  */
+
+static varobj_item *
+py_varobj_iter_next_array (struct py_varobj_iter *t)
+{
+  struct varobj_iter *self = &t->base;
+  LONGEST i = self->next_raw_index;
+
+  if (i >= t->array->count ())
+    return NULL;
+
+  varobj_item *vitem = new varobj_item ();
+  try
+    {
+      vitem->value = t->array->element (i);
+      vitem->name = string_printf ("[%s]",
+				   plongest (t->array->low_bound () + i));
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* If we got a memory error, just use the text as the item.  */
+      if (ex.error != MEMORY_ERROR)
+	{
+	  delete vitem;
+	  throw;
+	}
+
+      vitem->value
+	= value_cstring (ex.what (), strlen (ex.what ()),
+			 language_string_char_type (python_language,
+						    python_gdbarch));
+      vitem->name = string_printf ("<error at %d>", self->next_raw_index);
+    }
+
+  self->next_raw_index++;
+  return vitem;
 }
 
 /* Implementation of the 'next' method of pretty-printed varobj
@@ -58,6 +104,9 @@ py_varobj_iter_next (struct varobj_iter *self)
 
   gdbpy_enter_varobj enter_py (self->var);
 
+  if (t->array != NULL)
+    return py_varobj_iter_next_array (t);
+
   gdbpy_ref<> item (PyIter_Next (t->iter));
 
   if (item == NULL)
@@ -121,30 +170,34 @@ static const struct varobj_iter_ops py_varobj_iter_ops =
 
 /* Constructor of pretty-printed varobj iterators.  VAR is the varobj
    whose children the iterator will be iterating over.  PYITER is the
-   python iterator actually responsible for the iteration.  */
+   python iterator actually responsible for the iteration, or NULL if
+   ARRAY holds the children instead.  */
 
 static void
 py_varobj_iter_ctor (struct py_varobj_iter *self,
-		     struct varobj *var, gdbpy_ref<> &&pyiter)
+		     struct varobj *var, gdbpy_ref<> &&pyiter,
+		     std::unique_ptr<array_element_reader> &&array)
 {
   self->base.var = var;
   self->base.ops = &py_varobj_iter_ops;
   self->base.next_raw_index = 0;
   self->iter = pyiter.release ();
+  self->array = array.release ();
 }
 
 /* Allocate and construct a pretty-printed varobj iterator.  VAR is
    the varobj whose children the iterator will be iterating over.
    PYITER is the python iterator actually responsible for the
-   iteration.  */
+   iteration, or NULL if ARRAY holds the children instead.  */
 
 static struct py_varobj_iter *
-py_varobj_iter_new (struct varobj *var, gdbpy_ref<> &&pyiter)
+py_varobj_iter_new (struct varobj *var, gdbpy_ref<> &&pyiter,
+		    std::unique_ptr<array_element_reader> &&array)
 {
   struct py_varobj_iter *self;
 
   self = XNEW (struct py_varobj_iter);
-  py_varobj_iter_ctor (self, var, std::move (pyiter));
+  py_varobj_iter_ctor (self, var, std::move (pyiter), std::move (array));
   return self;
 }
 
@@ -169,14 +222,20 @@ py_varobj_get_iterator (struct varobj *var, PyObject *printer)
       error (_("Null value returned for children"));
     }
 
-  gdbpy_ref<> iter (PyObject_GetIter (children.get ()));
-  if (iter == NULL)
+  std::unique_ptr<array_element_reader> array
+    = gdbpy_children_array (children.get ());
+  gdbpy_ref<> iter;
+  if (array == NULL)
     {
-      gdbpy_print_stack ();
-      error (_("Could not get children iterator"));
+      iter.reset (PyObject_GetIter (children.get ()));
+      if (iter == NULL)
+	{
+	  gdbpy_print_stack ();
+	  error (_("Could not get children iterator"));
+	}
     }
 
-  py_iter = py_varobj_iter_new (var, std::move (iter));
+  py_iter = py_varobj_iter_new (var, std::move (iter), std::move (array));
 
   return &py_iter->base;
 }
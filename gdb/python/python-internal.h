@@ -716,6 +716,15 @@ gdbpy_ref<> gdbpy_get_varobj_pretty_printer (struct value *value);
 gdb::unique_xmalloc_ptr<char> gdbpy_get_display_hint (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
 
+class array_element_reader;
+
+/* If CHILDREN, the result of calling a pretty-printer's "children"
+   method, is an array value with known bounds, return a reader for
+   its elements, which are then the children.  Otherwise, return
+   NULL.  */
+std::unique_ptr<array_element_reader> gdbpy_children_array
+  (PyObject *children);
+
 void bpfinishpy_pre_stop_hook (struct gdbpy_breakpoint_object *bp_obj);
 void bpfinishpy_post_stop_hook (struct gdbpy_breakpoint_object *bp_obj);
 
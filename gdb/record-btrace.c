@@ -40,6 +40,7 @@
 #include "inf-loop.h"
 #include "inferior.h"
 #include <algorithm>
+#include <forward_list>
 #include "gdbarch.h"
 #include "cli/cli-style.h"
 
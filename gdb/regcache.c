@@ -28,7 +28,6 @@
 #include "reggroups.h"
 #include "observable.h"
 #include "regset.h"
-#include <forward_list>
 
 /*
  * DATA STRUCTURE
@@ -317,19 +316,20 @@ reg_buffer::assert_regnum (int regnum) const
    recording if the register values have been changed (eg. by the
    user).  Therefore all registers must be written back to the
    target when appropriate.  */
-std::forward_list<regcache *> regcache::current_regcache;
+regcache::ptid_regcache_map regcache::current_regcache;
 
 struct regcache *
 get_thread_arch_aspace_regcache (ptid_t ptid, struct gdbarch *gdbarch,
 				 struct address_space *aspace)
 {
-  for (const auto &regcache : regcache::current_regcache)
-    if (regcache->ptid () == ptid && regcache->arch () == gdbarch)
-      return regcache;
+  auto range = regcache::current_regcache.equal_range (ptid);
+  for (auto it = range.first; it != range.second; ++it)
+    if (it->second->arch () == gdbarch)
+      return it->second;
 
   regcache *new_regcache = new regcache (gdbarch, aspace);
 
-  regcache::current_regcache.push_front (new_regcache);
+  regcache::current_regcache.emplace (ptid, new_regcache);
   new_regcache->set_ptid (ptid);
 
   return new_regcache;
@@ -393,10 +393,17 @@ regcache_observer_target_changed (struct target_ops *target)
 void
 regcache::regcache_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid)
 {
-  for (auto &regcache : regcache::current_regcache)
+  auto range = regcache::current_regcache.equal_range (old_ptid);
+  std::vector<regcache *> moved;
+
+  for (auto it = range.first; it != range.second; ++it)
+    moved.push_back (it->second);
+  regcache::current_regcache.erase (range.first, range.second);
+
+  for (regcache *regcache : moved)
     {
-      if (regcache->ptid () == old_ptid)
-	regcache->set_ptid (new_ptid);
+      regcache->set_ptid (new_ptid);
+      regcache::current_regcache.emplace (new_ptid, regcache);
     }
 }
 
@@ -414,18 +421,29 @@ regcache::regcache_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid)
 void
 registers_changed_ptid (ptid_t ptid)
 {
-  for (auto oit = regcache::current_regcache.before_begin (),
-	 it = std::next (oit);
-       it != regcache::current_regcache.end ();
-       )
+  if (ptid != minus_one_ptid && !ptid.is_pid ())
     {
-      if ((*it)->ptid ().matches (ptid))
+      /* A single thread; only its own regcaches can match.  */
+      auto range = regcache::current_regcache.equal_range (ptid);
+
+      for (auto it = range.first; it != range.second; ++it)
+	delete it->second;
+      regcache::current_regcache.erase (range.first, range.second);
+    }
+  else
+    {
+      for (auto it = regcache::current_regcache.begin ();
+	   it != regcache::current_regcache.end ();
+	   )
 	{
-	  delete *it;
-	  it = regcache::current_regcache.erase_after (oit);
+	  if (it->second->ptid ().matches (ptid))
+	    {
+	      delete it->second;
+	      it = regcache::current_regcache.erase (it);
+	    }
+	  else
+	    ++it;
 	}
-      else
-	oit = it++;
     }
 
   if (current_thread_ptid.matches (ptid))
@@ -1395,8 +1413,7 @@ public:
   static size_t
   current_regcache_size ()
   {
-    return std::distance (regcache::current_regcache.begin (),
-			  regcache::current_regcache.end ());
+    return regcache::current_regcache.size ();
   }
 };
 
@@ -1449,6 +1466,26 @@ current_regcache_test (void)
      current_regcache.  */
   registers_changed_ptid (ptid2);
   SELF_CHECK (regcache_access::current_regcache_size () == 2);
+
+  /* Changing the ptid of ptid3 moves its regcache over to the new
+     ptid.  */
+  ptid_t ptid4 (3, 4);
+  struct regcache *regcache3
+    = get_thread_arch_aspace_regcache (ptid3, target_gdbarch (), NULL);
+  regcache::regcache_thread_ptid_changed (ptid3, ptid4);
+  regcache = get_thread_arch_aspace_regcache (ptid4, target_gdbarch (),
+					      NULL);
+  SELF_CHECK (regcache == regcache3);
+  SELF_CHECK (regcache->ptid () == ptid4);
+  SELF_CHECK (regcache_access::current_regcache_size () == 2);
+
+  /* Marking a single thread changed only removes its regcache.  */
+  registers_changed_ptid (ptid4);
+  SELF_CHECK (regcache_access::current_regcache_size () == 1);
+
+  /* Marking all threads changed removes all regcaches.  */
+  registers_changed_ptid (minus_one_ptid);
+  SELF_CHECK (regcache_access::current_regcache_size () == 0);
 }
 
 class target_ops_no_register : public test_target_ops
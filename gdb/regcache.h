@@ -22,7 +22,7 @@
 
 #include "gdbsupport/common-regcache.h"
 #include "gdbsupport/function-view.h"
-#include <forward_list>
+#include <unordered_map>
 
 struct regcache;
 struct regset;
@@ -393,7 +393,12 @@ public:
 protected:
   regcache (gdbarch *gdbarch, const address_space *aspace_);
 
-  static std::forward_list<regcache *> current_regcache;
+  /* The thread regcaches, keyed by ptid.  A thread has one regcache
+     per architecture it has been accessed with.  */
+  typedef std::unordered_multimap<ptid_t, regcache *, hash_ptid>
+    ptid_regcache_map;
+
+  static ptid_regcache_map current_regcache;
 
 private:
 
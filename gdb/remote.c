@@ -75,7 +75,9 @@
 #include "gdbsupport/scoped_restore.h"
 #include "gdbsupport/environ.h"
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/function-view.h"
 #include <unordered_map>
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -159,25 +161,92 @@ struct readahead_cache
      read, or 0 if the request can't be served from the cache.  */
   int pread (int fd, gdb_byte *read_buf, size_t len, ULONGEST offset);
 
+  /* One block of the readahead window.  */
+  struct block
+  {
+    /* The offset into the file that the block corresponds to.  */
+    ULONGEST offset = 0;
+
+    /* The block's contents.  We try to read as much as fits into a
+       packet at a time.  */
+    std::vector<gdb_byte> data;
+  };
+
   /* The file descriptor for the file that is being cached.  -1 if the
      cache is invalid.  */
   int fd = -1;
 
-  /* The offset into the file that the cache buffer corresponds
-     to.  */
-  ULONGEST offset = 0;
+  /* The blocks of the readahead window, sorted by file offset.  The
+     window is filled with one request per block; when the remote
+     supports pipelining, all the requests of a window are in flight
+     at once.  A short read leaves a hole between two blocks, which is
+     filled by the next refill.  */
+  std::vector<block> blocks;
 
-  /* The buffer holding the cache contents.  */
-  gdb_byte *buf = nullptr;
-  /* The buffer's size.  We try to read as much as fits into a packet
-     at a time.  */
-  size_t bufsize = 0;
+  /* The number of blocks to read on the next miss.  This starts at
+     one, and only grows while the file is read sequentially, so that
+     random reads don't fetch blocks that are never used.  */
+  int window = 1;
 
   /* Cache hit and miss counters.  */
   ULONGEST hit_count = 0;
   ULONGEST miss_count = 0;
 };
 
+/* Kinds of replies the remote may compress, as negotiated with the
+   QCompressReplies packet.  */
+
+enum compressed_reply_kind
+{
+  /* Replies to "m" memory reads.  */
+  COMPRESSED_REPLY_m,
+
+  /* Replies to "vFile:pread" file reads.  */
+  COMPRESSED_REPLY_vFile_pread,
+
+  /* Replies to "qXfer" object reads.  */
+  COMPRESSED_REPLY_qXfer,
+
+  COMPRESSED_REPLY_MAX
+};
+
+/* The names of the compressed reply kinds, as used in the
+   QCompressReplies packet and by "set remote compressed-replies".  */
+
+static const char *const compressed_reply_names[COMPRESSED_REPLY_MAX] =
+{
+  "m",
+  "vFile:pread",
+  "qXfer",
+};
+
+/* Transfer statistics of a remote connection, shown by "maint print
+   remote-stats".  */
+
+struct remote_stats
+{
+  /* Packets sent, not counting retransmissions, and their payload
+     size.  */
+  ULONGEST packets_sent = 0;
+  ULONGEST bytes_sent = 0;
+
+  /* Packets received, notifications included, and their payload
+     size.  */
+  ULONGEST packets_received = 0;
+  ULONGEST bytes_received = 0;
+
+  /* For each kind of reply that may be compressed, the number of
+     replies received and how many of those were compressed, and
+     their size before and after decompression.  */
+  struct
+  {
+    ULONGEST replies = 0;
+    ULONGEST compressed = 0;
+    ULONGEST wire_bytes = 0;
+    ULONGEST bytes = 0;
+  } replies[COMPRESSED_REPLY_MAX];
+};
+
 /* Description of the remote protocol for a given architecture.  */
 
 struct packet_reg
@@ -357,6 +426,18 @@ public: /* data */
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
 
+  /* The maximum number of requests the remote stub accepts to have
+     in flight at once, as reported by the "PipelineWindow" qSupported
+     feature.  1 means the stub is strictly request/reply.  */
+  int pipeline_window = 1;
+
+  /* The mask of compressed_reply_kind bits the remote stub agreed to
+     compress, with the QCompressReplies packet.  */
+  unsigned int compressed_replies = 0;
+
+  /* Transfer statistics of this connection.  */
+  struct remote_stats stats;
+
   /* The list of already fetched and acknowledged stop events.  This
      queue is used for notification Stop, and other notifications
      don't need queue for their events, because the notification
@@ -530,6 +611,11 @@ public:
 		     const gdb_byte *pattern, ULONGEST pattern_len,
 		     CORE_ADDR *found_addrp) override;
 
+  int search_memory_all (CORE_ADDR start_addr, ULONGEST search_space_len,
+			 const gdb_byte *pattern, ULONGEST pattern_len,
+			 ULONGEST align,
+			 search_memory_found_ftype found_cb) override;
+
   bool can_async_p () override;
 
   bool is_async_p () override;
@@ -693,10 +779,14 @@ public: /* Remote specific methods.  */
 			    ULONGEST offset, int *remote_errno);
   int remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 				 ULONGEST offset, int *remote_errno);
+  int remote_hostio_prepare_pread (int fd, int len, ULONGEST offset);
 
   int remote_hostio_send_command (int command_bytes, int which_packet,
 				  int *remote_errno, char **attachment,
 				  int *attachment_len);
+  int remote_hostio_parse_reply (int bytes_read, int which_packet,
+				 int *remote_errno, char **attachment,
+				 int *attachment_len);
   int remote_hostio_set_filesystem (struct inferior *inf,
 				    int *remote_errno);
   /* We should get rid of this and use fileio_open directly.  */
@@ -815,6 +905,15 @@ public: /* Remote specific methods.  */
   void remote_packet_size (const protocol_feature *feature,
 			   packet_support support, const char *value);
 
+  void remote_pipeline_window (const protocol_feature *feature,
+			       packet_support support, const char *value);
+
+  int get_remote_pipeline_window ();
+
+  void remote_send_pipelined (int count,
+			      gdb::function_view<int (int)> make_request,
+			      gdb::function_view<void (int, int)> handle_reply);
+
   void remote_serial_quit_handler ();
 
   void remote_detach_pid (int pid);
@@ -859,6 +958,19 @@ public: /* Remote specific methods.  */
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  int remote_decompress_reply (enum compressed_reply_kind kind,
+			       int bytes_read);
+
+  void remote_set_compressed_replies ();
+
+  void print_remote_stats ();
+
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						  gdb_byte *myaddr,
+						  ULONGEST len_units,
+						  int unit_size,
+						  ULONGEST *xfered_len_units);
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -2085,6 +2197,12 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for pipelined requests.  */
+  PACKET_PipelineWindow,
+
+  /* Support for the QCompressReplies packet.  */
+  PACKET_QCompressReplies,
+
   PACKET_MAX
 };
 
@@ -4579,6 +4697,9 @@ remote_target::start_remote (int from_tty, int extended_p)
 	rs->noack_mode = 1;
     }
 
+  /* Ask for the replies the user wants compressed.  */
+  remote_set_compressed_replies ();
+
   if (extended_p)
     {
       /* Tell the remote that we are using the extended protocol.  */
@@ -5058,6 +5179,49 @@ remote_target::remote_packet_size (const protocol_feature *feature,
   rs->explicit_packet_size = packet_size;
 }
 
+/* Add the "PipelineWindow=N" qSupported feature handler.  */
+
+static void
+remote_pipeline_window (remote_target *remote,
+			const protocol_feature *feature,
+			enum packet_support support, const char *value)
+{
+  remote->remote_pipeline_window (feature, support, value);
+}
+
+void
+remote_target::remote_pipeline_window (const protocol_feature *feature,
+				       enum packet_support support,
+				       const char *value)
+{
+  struct remote_state *rs = get_remote_state ();
+  int window;
+  char *value_end;
+
+  remote_protocol_packets[feature->packet].support = support;
+
+  if (support != PACKET_ENABLE)
+    return;
+
+  if (value == NULL || *value == '\0')
+    {
+      warning (_("Remote target reported \"%s\" without a size."),
+	       feature->name);
+      return;
+    }
+
+  errno = 0;
+  window = strtol (value, &value_end, 16);
+  if (errno != 0 || *value_end != '\0' || window <= 0)
+    {
+      warning (_("Remote target reported \"%s\" with a bad size: \"%s\"."),
+	       feature->name, value);
+      return;
+    }
+
+  rs->pipeline_window = window;
+}
+
 void
 remote_packet_size (remote_target *remote, const protocol_feature *feature,
 		    enum packet_support support, const char *value)
@@ -5168,6 +5332,10 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "PipelineWindow", PACKET_DISABLE, remote_pipeline_window,
+    PACKET_PipelineWindow },
+  { "QCompressReplies", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QCompressReplies },
 };
 
 static char *remote_support_xml;
@@ -5536,6 +5704,9 @@ remote_target::open_1 (const char *name, int from_tty, int extended_p)
   reset_all_packet_configs_support ();
   rs->cached_wait_status = 0;
   rs->explicit_packet_size = 0;
+  rs->pipeline_window = 1;
+  rs->compressed_replies = 0;
+  rs->stats = {};
   rs->noack_mode = 0;
   rs->extended = extended_p;
   rs->waiting_for_stop_reply = 0;
@@ -7855,6 +8026,12 @@ remote_target::wait (ptid_t ptid, struct target_waitstatus *status, int options)
   else
     event_ptid = wait_as (ptid, status, options);
 
+  /* Ask for the compression the user set while the target was
+     running, now that the remote can take the packet.  */
+  if (!target_is_non_stop_p ()
+      && status->kind == TARGET_WAITKIND_STOPPED)
+    remote_set_compressed_replies ();
+
   if (target_is_async_p ())
     {
       remote_state *rs = get_remote_state ();
@@ -8698,6 +8875,13 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
 
+  /* If the request doesn't fit in a single packet, and the remote
+     accepts several requests in flight, keep the link busy.  */
+  if (len_units > (ULONGEST) (buf_size_bytes / unit_size) / 2
+      && get_remote_pipeline_window () > 1)
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					unit_size, xfered_len_units);
+
   /* Number of units that will fit.  */
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
@@ -8711,7 +8895,7 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   p += hexnumstr (p, (ULONGEST) todo_units);
   *p = '\0';
   putpkt (rs->buf);
-  getpkt (&rs->buf, 0);
+  remote_decompress_reply (COMPRESSED_REPLY_m, getpkt_sane (&rs->buf, 0));
   if (rs->buf[0] == 'E'
       && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
       && rs->buf[3] == '\0')
@@ -8725,6 +8909,83 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Like remote_read_bytes_1, but split the read in as many "m"
+   packets as the remote's pipeline window allows, and send them all
+   before waiting for the first reply.  Stops accumulating data at the
+   first error or short read; the replies to the requests after that
+   one are still consumed, but discarded.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units,
+					    int unit_size,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST chunk_units
+    = (ULONGEST) (get_memory_read_packet_size () / unit_size) / 2;
+  ULONGEST count = (len_units + chunk_units - 1) / chunk_units;
+  ULONGEST done_units = 0;
+  bool failed = false;
+
+  count = std::min (count, (ULONGEST) get_remote_pipeline_window ());
+
+  auto chunk_todo = [&] (int i)
+    {
+      return std::min (chunk_units, len_units - i * chunk_units);
+    };
+
+  auto make_request = [&] (int i)
+    {
+      char *p = rs->buf.data ();
+
+      /* Construct "m"<memaddr>","<len>".  */
+      *p++ = 'm';
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr
+							   + i * chunk_units));
+      *p++ = ',';
+      p += hexnumstr (p, chunk_todo (i));
+      *p = '\0';
+      return (int) (p - rs->buf.data ());
+    };
+
+  auto handle_reply = [&] (int i, int bytes_read)
+    {
+      bytes_read = remote_decompress_reply (COMPRESSED_REPLY_m, bytes_read);
+
+      if (failed)
+	return;
+
+      if (bytes_read < 0
+	  || (rs->buf[0] == 'E'
+	      && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
+	      && rs->buf[3] == '\0'))
+	{
+	  failed = true;
+	  return;
+	}
+
+      ULONGEST todo_units = chunk_todo (i);
+      int decoded_bytes = hex2bin (rs->buf.data (),
+				   myaddr + i * chunk_units * unit_size,
+				   todo_units * unit_size);
+
+      done_units += decoded_bytes / unit_size;
+      if (decoded_bytes / unit_size != todo_units)
+	failed = true;
+    };
+
+  remote_send_pipelined (count, make_request, handle_reply);
+
+  if (done_units == 0 && failed)
+    return TARGET_XFER_E_IO;
+
+  /* Return what we have.  Let higher layers handle partial reads.  */
+  *xfered_len_units = done_units;
+  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -9106,6 +9367,9 @@ remote_target::putpkt_binary (const char *buf, int cnt)
      stale cached response.  */
   rs->cached_wait_status = 0;
 
+  rs->stats.packets_sent++;
+  rs->stats.bytes_sent += cnt;
+
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
 
@@ -9571,6 +9835,9 @@ remote_target::getpkt_or_notif_sane_1 (gdb::char_vector *buf,
 	  return -1;
 	}
 
+      rs->stats.packets_received++;
+      rs->stats.bytes_received += val;
+
       /* If we got an ordinary packet, return that to our caller.  */
       if (c == '$')
 	{
@@ -9638,6 +9905,283 @@ remote_target::getpkt_or_notif_sane (gdb::char_vector *buf, int forever,
   return getpkt_or_notif_sane_1 (buf, forever, 1, is_notif);
 }
 
+/* Return how many requests we may have in flight at once.  Pipelining
+   requires no-ack mode, otherwise putpkt would wait for each request
+   to be acknowledged anyway.  */
+
+int
+remote_target::get_remote_pipeline_window ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (!rs->noack_mode
+      || packet_support (PACKET_PipelineWindow) != PACKET_ENABLE)
+    return 1;
+
+  return rs->pipeline_window;
+}
+
+/* Send COUNT requests to the remote back to back, without waiting for
+   the replies in between, then read the COUNT replies, which the
+   remote sends in request order.  MAKE_REQUEST is called with the
+   index of each request and must prepare it in RS->BUF, returning its
+   length.  HANDLE_REPLY is called with the index of each request and
+   the value getpkt_sane returned for its reply, which is in RS->BUF.
+
+   COUNT must not exceed get_remote_pipeline_window.  */
+
+void
+remote_target::remote_send_pipelined
+  (int count, gdb::function_view<int (int)> make_request,
+   gdb::function_view<void (int, int)> handle_reply)
+{
+  struct remote_state *rs = get_remote_state ();
+  int i;
+
+  gdb_assert (count <= get_remote_pipeline_window ());
+
+  for (i = 0; i < count; i++)
+    putpkt_binary (rs->buf.data (), make_request (i));
+
+  for (i = 0; i < count; i++)
+    {
+      int bytes_read = getpkt_sane (&rs->buf, 0);
+
+      try
+	{
+	  handle_reply (i, bytes_read);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* Consume the replies still in flight, so that the next
+	     request doesn't see them.  */
+	  for (i++; i < count; i++)
+	    getpkt_sane (&rs->buf, 0);
+	  throw;
+	}
+    }
+}
+
+/* The compressed_reply_kind bits of the replies the user wants
+   compressed, and the "set remote compressed-replies" string they
+   were parsed from.  */
+
+static unsigned int remote_compressed_replies_mask;
+static char *remote_compressed_replies_string;
+
+/* The reply in RS->BUF, BYTES_READ bytes long as returned by
+   getpkt_sane, is to a request whose reply is of KIND.  Account for
+   it in the statistics and, if the remote compressed it, decompress
+   it in place.  Return the length of the decompressed reply.
+
+   A compressed reply is "Z<length>;<data>", where LENGTH is the
+   length in hex of the original reply, and DATA is the original
+   reply compressed with zlib, then escaped as binary data.  */
+
+int
+remote_target::remote_decompress_reply (enum compressed_reply_kind kind,
+					int bytes_read)
+{
+  struct remote_state *rs = get_remote_state ();
+  auto &stats = rs->stats.replies[kind];
+
+  if (bytes_read < 0)
+    return bytes_read;
+
+  stats.replies++;
+  stats.wire_bytes += bytes_read;
+
+  if ((rs->compressed_replies & (1 << kind)) == 0 || rs->buf[0] != 'Z')
+    {
+      stats.bytes += bytes_read;
+      return bytes_read;
+    }
+
+  ULONGEST len;
+  const char *p = unpack_varlen_hex (rs->buf.data () + 1, &len);
+
+  if (*p != ';' || len >= INT_MAX)
+    error (_("Malformed compressed reply from remote target."));
+  p++;
+
+  gdb::byte_vector zbuf (bytes_read - (p - rs->buf.data ()));
+  int zlen = remote_unescape_input ((const gdb_byte *) p, zbuf.size (),
+				    zbuf.data (), zbuf.size ());
+
+  if (rs->buf.size () < len + 1)
+    rs->buf.resize (len + 1);
+
+  uLongf out_len = len;
+  if (uncompress ((Bytef *) rs->buf.data (), &out_len, zbuf.data (),
+		  zlen) != Z_OK
+      || out_len != len)
+    error (_("Malformed compressed reply from remote target."));
+  rs->buf[len] = '\0';
+
+  if (remote_debug)
+    fprintf_unfiltered (gdb_stdlog, "Decompressed reply: %d -> %s bytes\n",
+			bytes_read, pulongest (len));
+
+  stats.compressed++;
+  stats.bytes += len;
+  return len;
+}
+
+/* Tell the remote which replies the user wants compressed, if it
+   supports compressing replies and that changed.  Does nothing while
+   the target is running in all-stop mode.  */
+
+void
+remote_target::remote_set_compressed_replies ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (packet_support (PACKET_QCompressReplies) != PACKET_ENABLE
+      || rs->compressed_replies == remote_compressed_replies_mask)
+    return;
+
+  /* In all-stop mode, the remote can't take the packet while the
+     target is running.  remote_target::wait sends it once the target
+     stops.  */
+  if (!target_is_non_stop_p () && rs->waiting_for_stop_reply)
+    return;
+
+  std::string packet = "QCompressReplies:";
+  const char *sep = "";
+
+  for (int kind = 0; kind < COMPRESSED_REPLY_MAX; kind++)
+    if ((remote_compressed_replies_mask & (1 << kind)) != 0)
+      {
+	packet += sep;
+	packet += compressed_reply_names[kind];
+	sep = ";";
+      }
+
+  putpkt (packet.c_str ());
+  getpkt (&rs->buf, 0);
+
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_QCompressReplies])
+      == PACKET_OK)
+    rs->compressed_replies = remote_compressed_replies_mask;
+  else
+    warning (_("Remote refused compressing replies: %s"), rs->buf.data ());
+}
+
+/* Print the transfer statistics of this connection.  */
+
+void
+remote_target::print_remote_stats ()
+{
+  struct remote_state *rs = get_remote_state ();
+  const remote_stats &stats = rs->stats;
+
+  printf_filtered (_("Packets sent: %s (%s bytes)\n"),
+		   pulongest (stats.packets_sent),
+		   pulongest (stats.bytes_sent));
+  printf_filtered (_("Packets received: %s (%s bytes)\n"),
+		   pulongest (stats.packets_received),
+		   pulongest (stats.bytes_received));
+
+  for (int kind = 0; kind < COMPRESSED_REPLY_MAX; kind++)
+    {
+      const auto &r = stats.replies[kind];
+
+      printf_filtered (_("Replies to %s: %s, %s compressed (%s), "
+			 "%s bytes received for %s bytes"),
+		       compressed_reply_names[kind], pulongest (r.replies),
+		       pulongest (r.compressed),
+		       ((rs->compressed_replies & (1 << kind)) != 0
+			? _("enabled") : _("disabled")),
+		       pulongest (r.wire_bytes), pulongest (r.bytes));
+      if (r.wire_bytes != 0)
+	printf_filtered (_(", ratio %.2f"),
+			 (double) r.bytes / r.wire_bytes);
+      printf_filtered ("\n");
+    }
+}
+
+/* The "set remote compressed-replies" set hook.  */
+
+static void
+set_remote_compressed_replies (const char *args, int from_tty,
+			       struct cmd_list_element *c)
+{
+  unsigned int mask = 0;
+  std::string error_kind;
+  const char *p = remote_compressed_replies_string;
+
+  if (p == NULL || strcmp (p, "none") == 0 || *p == '\0')
+    mask = 0;
+  else if (strcmp (p, "all") == 0)
+    mask = (1 << COMPRESSED_REPLY_MAX) - 1;
+  else
+    while (*p != '\0')
+      {
+	const char *end = strchrnul (p, ',');
+	int kind;
+
+	for (kind = 0; kind < COMPRESSED_REPLY_MAX; kind++)
+	  if (strlen (compressed_reply_names[kind]) == (size_t) (end - p)
+	      && strncmp (compressed_reply_names[kind], p, end - p) == 0)
+	    break;
+
+	if (kind == COMPRESSED_REPLY_MAX)
+	  {
+	    error_kind = std::string (p, end - p);
+	    break;
+	  }
+
+	mask |= 1 << kind;
+	p = *end == ',' ? end + 1 : end;
+      }
+
+  /* Rebuild the string from the mask, so that it reads back in
+     canonical form, or back to its previous value on error.  */
+  if (error_kind.empty ())
+    remote_compressed_replies_mask = mask;
+
+  std::string canonical;
+
+  for (int kind = 0; kind < COMPRESSED_REPLY_MAX; kind++)
+    if ((remote_compressed_replies_mask & (1 << kind)) != 0)
+      {
+	if (!canonical.empty ())
+	  canonical += ",";
+	canonical += compressed_reply_names[kind];
+      }
+  xfree (remote_compressed_replies_string);
+  remote_compressed_replies_string
+    = xstrdup (canonical.empty () ? "none" : canonical.c_str ());
+
+  if (!error_kind.empty ())
+    error (_("Unknown reply kind \"%s\"."), error_kind.c_str ());
+
+  remote_target *remote = get_current_remote_target ();
+  if (remote != NULL)
+    remote->remote_set_compressed_replies ();
+}
+
+static void
+show_remote_compressed_replies (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Replies the remote target is asked to "
+			    "compress: %s.\n"), value);
+}
+
+/* The "maintenance print remote-stats" command.  */
+
+static void
+maintenance_print_remote_stats (const char *args, int from_tty)
+{
+  remote_target *remote = get_current_remote_target ();
+
+  if (remote == NULL)
+    error (_("No remote target."));
+
+  remote->print_remote_stats ();
+}
+
 /* Kill any new fork children of process PID that haven't been
    processed by follow_fork.  */
 
@@ -10782,7 +11326,8 @@ remote_target::remote_read_qxfer (const char *object_name,
     return TARGET_XFER_E_IO;
 
   rs->buf[0] = '\0';
-  packet_len = getpkt_sane (&rs->buf, 0);
+  packet_len = remote_decompress_reply (COMPRESSED_REPLY_qXfer,
+					getpkt_sane (&rs->buf, 0));
   if (packet_len < 0 || packet_ok (rs->buf, packet) != PACKET_OK)
     return TARGET_XFER_E_IO;
 
@@ -11118,6 +11663,60 @@ remote_target::search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
   return found;
 }
 
+int
+remote_target::search_memory_all (CORE_ADDR start_addr,
+				  ULONGEST search_space_len,
+				  const gdb_byte *pattern, ULONGEST pattern_len,
+				  ULONGEST align,
+				  search_memory_found_ftype found_cb)
+{
+  struct packet_config *packet =
+    &remote_protocol_packets[PACKET_qSearch_memory];
+  int found_count = 0;
+
+  /* Let the target find each match, and restart the search just past
+     it.  This avoids transferring the memory.  */
+  while (search_space_len >= pattern_len)
+    {
+      CORE_ADDR found_addr;
+      ULONGEST next_incr;
+      int found;
+
+      if (packet_config_support (packet) == PACKET_DISABLE)
+	{
+	  /* Copy the rest of the memory and search it here, in a
+	     single pass.  */
+	  found = simple_search_memory_all (this, start_addr,
+					    search_space_len,
+					    pattern, pattern_len,
+					    align, found_cb);
+	  return found < 0 ? -1 : found_count + found;
+	}
+
+      found = search_memory (start_addr, search_space_len,
+			     pattern, pattern_len, &found_addr);
+      if (found < 0)
+	return -1;
+      if (found == 0)
+	break;
+
+      if (align <= 1 || found_addr % align == 0)
+	{
+	  ++found_count;
+	  if (!found_cb (found_addr))
+	    break;
+	}
+
+      next_incr = (found_addr - start_addr) + 1;
+      if (search_space_len < next_incr)
+	break;
+      search_space_len -= next_incr;
+      start_addr += next_incr;
+    }
+
+  return found_count;
+}
+
 void
 remote_target::rcmd (const char *command, struct ui_file *outbuf)
 {
@@ -11739,8 +12338,7 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
 					   int *attachment_len)
 {
   struct remote_state *rs = get_remote_state ();
-  int ret, bytes_read;
-  char *attachment_tmp;
+  int bytes_read;
 
   if (packet_support (which_packet) == PACKET_DISABLE)
     {
@@ -11751,6 +12349,28 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
   putpkt_binary (rs->buf.data (), command_bytes);
   bytes_read = getpkt_sane (&rs->buf, 0);
 
+  return remote_hostio_parse_reply (bytes_read, which_packet, remote_errno,
+				    attachment, attachment_len);
+}
+
+/* Parse the reply to an I/O packet, which is in RS->BUF and is
+   BYTES_READ bytes long, as returned by getpkt_sane.  The other
+   arguments and the return value are as for
+   remote_hostio_send_command.  */
+
+int
+remote_target::remote_hostio_parse_reply (int bytes_read, int which_packet,
+					  int *remote_errno, char **attachment,
+					  int *attachment_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  int ret;
+  char *attachment_tmp;
+
+  if (which_packet == PACKET_vFile_pread)
+    bytes_read = remote_decompress_reply (COMPRESSED_REPLY_vFile_pread,
+					  bytes_read);
+
   /* If it timed out, something is wrong.  Don't try to parse the
      buffer.  */
   if (bytes_read < 0)
@@ -11942,19 +12562,15 @@ remote_target::fileio_pwrite (int fd, const gdb_byte *write_buf, int len,
   return remote_hostio_pwrite (fd, write_buf, len, offset, remote_errno);
 }
 
-/* Helper for the implementation of to_fileio_pread.  Read the file
-   from the remote side with vFile:pread.  */
+/* Prepare a vFile:pread request for LEN bytes at OFFSET in the file
+   open as FD in RS->BUF.  Returns the length of the request.  */
 
 int
-remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
-					  ULONGEST offset, int *remote_errno)
+remote_target::remote_hostio_prepare_pread (int fd, int len, ULONGEST offset)
 {
   struct remote_state *rs = get_remote_state ();
   char *p = rs->buf.data ();
-  char *attachment;
   int left = get_remote_packet_size ();
-  int ret, attachment_len;
-  int read_len;
 
   remote_buffer_add_string (&p, &left, "vFile:pread:");
 
@@ -11966,17 +12582,43 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 
   remote_buffer_add_int (&p, &left, offset);
 
-  ret = remote_hostio_send_command (p - rs->buf.data (), PACKET_vFile_pread,
-				    remote_errno, &attachment,
-				    &attachment_len);
+  return p - rs->buf.data ();
+}
 
-  if (ret < 0)
-    return ret;
+/* Decode the ATTACHMENT_LEN bytes of ATTACHMENT of a vFile:pread
+   reply that returned RET into READ_BUF, which is LEN bytes long.  */
+
+static void
+remote_hostio_decode_pread (int ret, char *attachment, int attachment_len,
+			    gdb_byte *read_buf, int len)
+{
+  int read_len;
 
   read_len = remote_unescape_input ((gdb_byte *) attachment, attachment_len,
 				    read_buf, len);
   if (read_len != ret)
     error (_("Read returned %d, but %d bytes."), ret, (int) read_len);
+}
+
+/* Helper for the implementation of to_fileio_pread.  Read the file
+   from the remote side with vFile:pread.  */
+
+int
+remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
+					  ULONGEST offset, int *remote_errno)
+{
+  char *attachment;
+  int ret, attachment_len;
+
+  ret = remote_hostio_send_command (remote_hostio_prepare_pread (fd, len,
+								offset),
+				    PACKET_vFile_pread, remote_errno,
+				    &attachment, &attachment_len);
+
+  if (ret < 0)
+    return ret;
+
+  remote_hostio_decode_pread (ret, attachment, attachment_len, read_buf, len);
 
   return ret;
 }
@@ -11987,18 +12629,20 @@ int
 readahead_cache::pread (int fd, gdb_byte *read_buf, size_t len,
 			ULONGEST offset)
 {
-  if (this->fd == fd
-      && this->offset <= offset
-      && offset < this->offset + this->bufsize)
-    {
-      ULONGEST max = this->offset + this->bufsize;
+  if (this->fd != fd)
+    return 0;
 
-      if (offset + len > max)
-	len = max - offset;
+  for (const block &b : this->blocks)
+    if (b.offset <= offset && offset < b.offset + b.data.size ())
+      {
+	ULONGEST max = b.offset + b.data.size ();
 
-      memcpy (read_buf, this->buf + offset - this->offset, len);
-      return len;
-    }
+	if (offset + len > max)
+	  len = max - offset;
+
+	memcpy (read_buf, b.data.data () + offset - b.offset, len);
+	return len;
+      }
 
   return 0;
 }
@@ -12029,20 +12673,135 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
     fprintf_unfiltered (gdb_stdlog, "readahead cache miss %s\n",
 			pulongest (cache->miss_count));
 
+  if (packet_support (PACKET_vFile_pread) == PACKET_DISABLE)
+    {
+      *remote_errno = FILEIO_ENOSYS;
+      return -1;
+    }
+
+  /* Double the readahead window when this read continues in, or right
+     after, the blocks read on the previous misses, up to the remote's
+     pipeline window.  Go back to a single block otherwise, so that
+     random reads don't fetch blocks that are never used.  */
+  std::vector<readahead_cache::block> kept;
+  if (cache->fd == fd && !cache->blocks.empty ()
+      && cache->blocks.front ().offset <= offset
+      && offset <= (cache->blocks.back ().offset
+		    + cache->blocks.back ().data.size ()))
+    {
+      cache->window = std::min (cache->window * 2,
+				get_remote_pipeline_window ());
+
+      /* Keep the blocks after OFFSET; only the ranges they don't
+	 cover are requested.  */
+      for (readahead_cache::block &b : cache->blocks)
+	if (b.offset > offset)
+	  kept.push_back (std::move (b));
+    }
+  else
+    cache->window = 1;
+
+  /* Plan one request per block, from OFFSET on, skipping what is
+     still cached.  */
+  int window = cache->window;
+  ULONGEST blocksize = get_remote_packet_size ();
+  std::vector<std::pair<ULONGEST, ULONGEST>> requests;
+  ULONGEST pos = offset;
+  size_t next_kept = 0;
+
+  while (requests.size () < (size_t) window)
+    {
+      if (next_kept < kept.size () && kept[next_kept].offset <= pos)
+	{
+	  pos = std::max (pos, (kept[next_kept].offset
+				+ kept[next_kept].data.size ()));
+	  next_kept++;
+	  continue;
+	}
+
+      ULONGEST size = blocksize;
+      if (next_kept < kept.size ())
+	size = std::min (size, kept[next_kept].offset - pos);
+      requests.emplace_back (pos, size);
+      pos += size;
+    }
+
+  int nblocks = 0;
+  bool done = false;
+
   cache->fd = fd;
-  cache->offset = offset;
-  cache->bufsize = get_remote_packet_size ();
-  cache->buf = (gdb_byte *) xrealloc (cache->buf, cache->bufsize);
+  cache->blocks.resize (window);
+
+  auto make_request = [&] (int i)
+    {
+      return remote_hostio_prepare_pread (fd, requests[i].second,
+					  requests[i].first);
+    };
+
+  auto handle_reply = [&] (int i, int bytes_read)
+    {
+      char *attachment;
+      int attachment_len, block_errno;
+      int block_ret = remote_hostio_parse_reply (bytes_read,
+						 PACKET_vFile_pread,
+						 &block_errno, &attachment,
+						 &attachment_len);
+
+      if (i == 0)
+	{
+	  ret = block_ret;
+	  *remote_errno = block_errno;
+	}
+
+      /* Only keep the blocks up to the first error or end of
+	 file.  */
+      if (done || block_ret <= 0)
+	{
+	  done = true;
+	  return;
+	}
+
+      readahead_cache::block &b = cache->blocks[nblocks++];
+
+      b.offset = requests[i].first;
+      b.data.resize (requests[i].second);
+      remote_hostio_decode_pread (block_ret, attachment, attachment_len,
+				  b.data.data (), requests[i].second);
+      b.data.resize (block_ret);
+    };
 
-  ret = remote_hostio_pread_vFile (cache->fd, cache->buf, cache->bufsize,
-				   cache->offset, remote_errno);
+  try
+    {
+      remote_send_pipelined (window, make_request, handle_reply);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      cache->invalidate_fd (fd);
+      throw;
+    }
+
+  cache->blocks.resize (nblocks);
   if (ret <= 0)
     {
       cache->invalidate_fd (fd);
       return ret;
     }
 
-  cache->bufsize = ret;
+  /* Merge the blocks still cached with the new ones.  They don't
+     overlap, since the new ones were only requested where there was
+     no cached block.  */
+  if (!kept.empty ())
+    {
+      for (readahead_cache::block &b : kept)
+	cache->blocks.push_back (std::move (b));
+      std::sort (cache->blocks.begin (), cache->blocks.end (),
+		 [] (const readahead_cache::block &a,
+		     const readahead_cache::block &b)
+		 {
+		   return a.offset < b.offset;
+		 });
+    }
+
   return cache->pread (fd, read_buf, len, offset);
 }
 
@@ -14635,6 +15394,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_PipelineWindow],
+			 "PipelineWindow", "pipeline-window", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QCompressReplies],
+			 "QCompressReplies", "compress-replies", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -14712,6 +15477,25 @@ Show the remote pathname for \"run\"."), NULL,
 				   &remote_set_cmdlist,
 				   &remote_show_cmdlist);
 
+  remote_compressed_replies_string = xstrdup ("none");
+  add_setshow_string_noescape_cmd ("compressed-replies", class_support,
+				   &remote_compressed_replies_string, _("\
+Set the replies the remote target is asked to compress."), _("\
+Show the replies the remote target is asked to compress."), _("\
+The value is \"none\", \"all\", or a comma-separated list of the kinds\n\
+of replies to compress: \"m\" (memory reads), \"vFile:pread\" (remote\n\
+file reads) and \"qXfer\" (object transfers).  Compression only helps\n\
+on slow connections.  The default is \"none\"."),
+				   set_remote_compressed_replies,
+				   show_remote_compressed_replies,
+				   &remote_set_cmdlist,
+				   &remote_show_cmdlist);
+
+  add_cmd ("remote-stats", class_maintenance,
+	   maintenance_print_remote_stats, _("\
+Print statistics about the data exchanged with the remote target."),
+	   &maintenanceprintlist);
+
   add_setshow_boolean_cmd ("range-stepping", class_run,
 			   &use_range_stepping, _("\
 Enable or disable range stepping."), _("\
@@ -2174,5 +2174,6 @@ extern const struct language_defn rust_language_defn =
   NULL,
   NULL,
   rust_is_string_type_p,
-  "{...}"			/* la_struct_too_deep_ellipsis */
+  "{...}",			/* la_struct_too_deep_ellipsis */
+  false				/* la_val_print_fetches_in_parts */
 };
@@ -55,6 +55,10 @@
 #include "gdbsupport/def-vector.h"
 #include "cli/cli-option.h"
 #include "cli/cli-style.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <unordered_map>
 
 /* The possible choices of "set print frame-arguments", and the value
    of this setting.  */
@@ -187,6 +191,8 @@ struct backtrace_cmd_options
   bool full = false;
   bool no_filters = false;
   bool hide = false;
+  bool all_threads = false;
+  bool unique = false;
 };
 
 using bt_flag_option_def
@@ -210,6 +216,21 @@ static const gdb::option::option_def backtrace_command_option_defs[] = {
     [] (backtrace_cmd_options *opt) { return &opt->hide; },
     N_("Causes Python frame filter elided frames to not be printed."),
   },
+
+  bt_flag_option_def {
+    "all-threads",
+    [] (backtrace_cmd_options *opt) { return &opt->all_threads; },
+    N_("Print the backtraces of all threads.\n\
+The symbol lookups of the frames the threads have in common are\n\
+shared, and the frames' arguments are not printed."),
+  },
+
+  bt_flag_option_def {
+    "unique",
+    [] (backtrace_cmd_options *opt) { return &opt->unique; },
+    N_("Like -all-threads, but print each distinct backtrace once,\n\
+along with the threads that share it."),
+  },
 };
 
 /* Prototypes for local functions.  */
@@ -2076,6 +2097,482 @@ backtrace_command_1 (const frame_print_options &fp_opts,
     }
 }
 
+/* Backtraces of all threads.
+
+   Printing the backtraces of thousands of threads one by one, as
+   "thread apply all backtrace" does, looks up the symbol, line and
+   shared library of the same frames over and over: most threads of a
+   program tend to sit in the same few places.  backtrace_all_threads
+   instead describes each distinct frame once, and only unwinds the
+   stack of each thread.  Frames are described by pointer to the
+   shared description, which also makes grouping identical stacks
+   cheap.  Frame arguments are not printed, since they would have to
+   be read from each thread.  */
+
+/* What distinguishes how two frames are printed.  */
+
+struct bt_batch_frame_key
+{
+  struct program_space *pspace;
+  struct gdbarch *gdbarch;
+  enum frame_type type;
+  bool pc_p;
+  CORE_ADDR pc;
+
+  /* The address looked up in the symbol tables, which is before PC
+     in caller frames.  */
+  CORE_ADDR addr_in_block;
+
+  /* The number of inlined functions the frame called at PC.  */
+  int inlined_callees;
+
+  std::string addr_flags;
+
+  bool operator== (const bt_batch_frame_key &other) const
+  {
+    return (pspace == other.pspace
+	    && gdbarch == other.gdbarch
+	    && type == other.type
+	    && pc_p == other.pc_p
+	    && pc == other.pc
+	    && addr_in_block == other.addr_in_block
+	    && inlined_callees == other.inlined_callees
+	    && addr_flags == other.addr_flags);
+  }
+};
+
+struct bt_batch_frame_key_hash
+{
+  size_t operator() (const bt_batch_frame_key &key) const
+  {
+    return (std::hash<CORE_ADDR> () (key.pc) * 31
+	    + std::hash<CORE_ADDR> () (key.addr_in_block)) * 31
+	    + key.inlined_callees;
+  }
+};
+
+/* How a frame is printed in a batch backtrace.  */
+
+struct bt_batch_frame
+{
+  struct gdbarch *gdbarch;
+  enum frame_type type;
+  bool pc_p;
+  CORE_ADDR pc;
+  std::string addr_flags;
+
+  /* Whether to print PC along with the location.  */
+  bool print_address;
+
+  /* The function's name, as printed.  */
+  std::string funname;
+
+  /* Whether the function has arguments.  */
+  bool has_args;
+
+  /* Where in the source the frame is, if known.  */
+  struct symtab *symtab;
+  int line;
+
+  /* The shared library holding PC, if the frame has no symbol or no
+     source.  */
+  const char *lib;
+};
+
+/* The frame descriptions shared by all the threads.  */
+
+struct bt_batch_cache
+{
+  std::unordered_map<bt_batch_frame_key, bt_batch_frame,
+		     bt_batch_frame_key_hash> frames;
+
+  /* Descriptions that can't be shared, because they depend on the
+     thread's state.  */
+  std::deque<bt_batch_frame> unshared;
+};
+
+/* The backtrace of one or more threads.  */
+
+struct bt_batch_stack
+{
+  std::vector<const bt_batch_frame *> frames;
+
+  /* If the backtrace stopped early, what to say about it.  */
+  enum { COMPLETE, MORE_FRAMES, STOPPED, ERROR } end = COMPLETE;
+  std::string reason;
+
+  /* The threads with this backtrace.  */
+  std::vector<thread_info *> threads;
+};
+
+/* Return the description of FRAME from CACHE, adding it if needed.  */
+
+static const bt_batch_frame *
+bt_batch_describe_frame (bt_batch_cache &cache, frame_info *frame)
+{
+  bt_batch_frame_key key;
+
+  key.pspace = get_frame_program_space (frame);
+  key.gdbarch = get_frame_arch (frame);
+  key.type = get_frame_type (frame);
+  key.pc = 0;
+  key.pc_p = get_frame_pc_if_available (frame, &key.pc);
+  key.addr_in_block = 0;
+  if (key.pc_p)
+    {
+      get_frame_address_in_block_if_available (frame, &key.addr_in_block);
+      key.addr_flags = gdbarch_get_pc_address_flags (key.gdbarch, frame,
+						     key.pc);
+    }
+  key.inlined_callees = frame_inlined_callees (frame);
+
+  /* The location of the innermost frame depends on which inlined
+     functions the thread is considered to have stepped into.  */
+  bool shared = (get_next_frame (frame) != NULL || key.inlined_callees == 0);
+  if (shared)
+    {
+      auto iter = cache.frames.find (key);
+      if (iter != cache.frames.end ())
+	return &iter->second;
+    }
+
+  bt_batch_frame desc;
+  desc.gdbarch = key.gdbarch;
+  desc.type = key.type;
+  desc.pc_p = key.pc_p;
+  desc.pc = key.pc;
+  desc.addr_flags = key.addr_flags;
+  desc.print_address = true;
+  desc.has_args = false;
+  desc.symtab = NULL;
+  desc.line = 0;
+  desc.lib = NULL;
+
+  if (key.type != DUMMY_FRAME
+      && key.type != SIGTRAMP_FRAME
+      && key.type != ARCH_FRAME)
+    {
+      enum language funlang = language_unknown;
+      struct symbol *func;
+      symtab_and_line sal = find_frame_sal (frame);
+      gdb::unique_xmalloc_ptr<char> funname
+	= find_frame_funname (frame, &funlang, &func);
+      string_file stb;
+
+      desc.print_address = !sal.symtab || frame_show_address (frame, sal);
+      fprintf_symbol_filtered (&stb, funname ? funname.get () : "??",
+			       funlang, DMGL_ANSI);
+      desc.funname = std::move (stb.string ());
+      if (func != NULL)
+	{
+	  struct block_iterator iter;
+	  struct symbol *sym;
+
+	  ALL_BLOCK_SYMBOLS (SYMBOL_BLOCK_VALUE (func), iter, sym)
+	    if (SYMBOL_IS_ARGUMENT (sym))
+	      {
+		desc.has_args = true;
+		break;
+	      }
+	}
+      desc.symtab = sal.symtab;
+      desc.line = sal.line;
+      if (key.pc_p && (funname == NULL || sal.symtab == NULL))
+	desc.lib = solib_name_from_address (key.pspace, key.pc);
+    }
+
+  if (!shared)
+    {
+      cache.unshared.push_back (std::move (desc));
+      return &cache.unshared.back ();
+    }
+  return &cache.frames.emplace (std::move (key),
+				std::move (desc)).first->second;
+}
+
+/* Unwind the current thread, and store its innermost COUNT frames, or
+   all of them if COUNT is -1, into STACK.  */
+
+static void
+bt_batch_collect (bt_batch_cache &cache, int count, bt_batch_stack *stack)
+{
+  struct frame_info *fi = NULL;
+  struct frame_info *trailing = NULL;
+
+  try
+    {
+      for (fi = get_current_frame (); fi && count--; fi = get_prev_frame (fi))
+	{
+	  QUIT;
+
+	  stack->frames.push_back (bt_batch_describe_frame (cache, fi));
+	  trailing = fi;
+	}
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      stack->end = bt_batch_stack::ERROR;
+      stack->reason = ex.what ();
+      return;
+    }
+
+  if (fi != NULL)
+    stack->end = bt_batch_stack::MORE_FRAMES;
+  else if (trailing != NULL
+	   && get_frame_unwind_stop_reason (trailing) >= UNWIND_FIRST_ERROR)
+    {
+      stack->end = bt_batch_stack::STOPPED;
+      stack->reason = frame_stop_reason_string (trailing);
+    }
+}
+
+/* Print frame number LEVEL of a batch backtrace, described by F.  */
+
+static void
+bt_batch_print_frame (struct ui_out *uiout, int level, const bt_batch_frame &f)
+{
+  struct value_print_options opts;
+
+  get_user_print_options (&opts);
+
+  ui_out_emit_tuple tuple_emitter (uiout, "frame");
+
+  uiout->text ("#");
+  uiout->field_fmt_signed (2, ui_left, "level", level);
+
+  if (uiout->is_mi_like_p () || (opts.addressprint && f.print_address))
+    {
+      if (f.pc_p)
+	{
+	  uiout->field_core_addr ("addr", f.gdbarch, f.pc);
+	  if (!f.addr_flags.empty ())
+	    {
+	      uiout->text (" [");
+	      uiout->field_string ("addr_flags", f.addr_flags);
+	      uiout->text ("]");
+	    }
+	}
+      else
+	uiout->field_string ("addr", "<unavailable>",
+			     metadata_style.style ());
+      if (f.type != DUMMY_FRAME
+	  && f.type != SIGTRAMP_FRAME
+	  && f.type != ARCH_FRAME)
+	uiout->text (" in ");
+    }
+
+  if (f.type == DUMMY_FRAME)
+    uiout->field_string ("func", "<function called from gdb>",
+			 metadata_style.style ());
+  else if (f.type == SIGTRAMP_FRAME)
+    uiout->field_string ("func", "<signal handler called>",
+			 metadata_style.style ());
+  else if (f.type == ARCH_FRAME)
+    uiout->field_string ("func", "<cross-architecture call>",
+			 metadata_style.style ());
+  else
+    {
+      uiout->field_string ("func", f.funname.c_str (),
+			   function_name_style.style ());
+      uiout->wrap_hint ("   ");
+      uiout->text (f.has_args ? " (...)" : " ()");
+
+      if (f.symtab != NULL)
+	{
+	  uiout->wrap_hint ("   ");
+	  uiout->text (" at ");
+	  uiout->field_string ("file", symtab_to_filename_for_display (f.symtab),
+			       file_name_style.style ());
+	  if (uiout->is_mi_like_p ())
+	    uiout->field_string ("fullname", symtab_to_fullname (f.symtab));
+	  uiout->text (":");
+	  uiout->field_signed ("line", f.line);
+	}
+
+      if (f.lib != NULL)
+	{
+	  uiout->wrap_hint ("  ");
+	  uiout->text (" from ");
+	  uiout->field_string ("from", f.lib, file_name_style.style ());
+	}
+    }
+
+  if (uiout->is_mi_like_p ())
+    uiout->field_string ("arch",
+			 (gdbarch_bfd_arch_info (f.gdbarch))->printable_name);
+  uiout->text ("\n");
+}
+
+/* Return the IDs of THREADS, which are in ascending order, as a list
+   of thread ID ranges.  */
+
+static std::string
+bt_batch_thread_ranges (const std::vector<thread_info *> &threads)
+{
+  std::string result;
+
+  for (size_t i = 0; i < threads.size (); )
+    {
+      size_t j = i + 1;
+
+      while (j < threads.size ()
+	     && threads[j]->inf == threads[i]->inf
+	     && (threads[j]->per_inf_num
+		 == threads[i]->per_inf_num + (int) (j - i)))
+	j++;
+
+      if (!result.empty ())
+	result += ", ";
+      result += print_thread_id (threads[i]);
+      if (j - i > 1)
+	result += string_printf ("-%d", threads[j - 1]->per_inf_num);
+      i = j;
+    }
+
+  return result;
+}
+
+/* Print STACK, the backtrace of one or more threads.  */
+
+static void
+bt_batch_print_stack (struct ui_out *uiout, const bt_batch_stack &stack,
+		      int from_tty)
+{
+  ui_out_emit_tuple tuple_emitter (uiout, "stack");
+
+  if (uiout->is_mi_like_p ())
+    {
+      ui_out_emit_list list_emitter (uiout, "thread-ids");
+
+      for (thread_info *tp : stack.threads)
+	uiout->field_signed ("thread-id", tp->global_num);
+    }
+  else if (stack.threads.size () == 1)
+    printf_filtered (_("\nThread %s (%s):\n"),
+		     print_thread_id (stack.threads[0]),
+		     target_pid_to_str (stack.threads[0]->ptid).c_str ());
+  else
+    {
+      std::vector<thread_info *> sorted = stack.threads;
+
+      std::sort (sorted.begin (), sorted.end (),
+		 [] (const thread_info *a, const thread_info *b)
+		 {
+		   if (a->inf->num != b->inf->num)
+		     return a->inf->num < b->inf->num;
+		   return a->per_inf_num < b->per_inf_num;
+		 });
+      printf_filtered (_("\nThreads %s (%s threads):\n"),
+		       bt_batch_thread_ranges (sorted).c_str (),
+		       pulongest (sorted.size ()));
+    }
+
+  {
+    ui_out_emit_list list_emitter (uiout, "frames");
+
+    for (int level = 0; level < stack.frames.size (); level++)
+      bt_batch_print_frame (uiout, level, *stack.frames[level]);
+  }
+
+  switch (stack.end)
+    {
+    case bt_batch_stack::MORE_FRAMES:
+      if (from_tty)
+	uiout->text (_("(More stack frames follow...)\n"));
+      break;
+    case bt_batch_stack::STOPPED:
+      if (uiout->is_mi_like_p ())
+	uiout->field_string ("stop-reason", stack.reason.c_str ());
+      else
+	printf_filtered (_("Backtrace stopped: %s\n"), stack.reason.c_str ());
+      break;
+    case bt_batch_stack::ERROR:
+      if (uiout->is_mi_like_p ())
+	uiout->field_string ("error", stack.reason.c_str ());
+      else
+	printf_filtered ("%s\n", stack.reason.c_str ());
+      break;
+    default:
+      break;
+    }
+}
+
+/* See stack.h.  */
+
+void
+backtrace_all_threads (int count, bool unique, int from_tty)
+{
+  struct ui_out *uiout = current_uiout;
+  bt_batch_cache cache;
+
+  update_thread_list ();
+
+  std::vector<thread_info *> threads;
+  for (thread_info *tp : all_non_exited_threads ())
+    threads.push_back (tp);
+
+  /* Use the same order as "thread apply all".  */
+  std::sort (threads.begin (), threads.end (),
+	     [] (const thread_info *a, const thread_info *b)
+	     {
+	       if (a->inf->num != b->inf->num)
+		 return a->inf->num > b->inf->num;
+	       return a->per_inf_num > b->per_inf_num;
+	     });
+
+  scoped_restore_current_thread restore_thread;
+  ui_out_emit_list list_emitter (uiout, "stacks");
+
+  if (!unique)
+    {
+      for (thread_info *tp : threads)
+	{
+	  bt_batch_stack stack;
+
+	  switch_to_thread (tp);
+	  bt_batch_collect (cache, count, &stack);
+	  stack.threads.push_back (tp);
+	  bt_batch_print_stack (uiout, stack, from_tty);
+	}
+      return;
+    }
+
+  std::vector<bt_batch_stack> stacks;
+  std::map<std::pair<std::vector<const bt_batch_frame *>, std::string>,
+	   size_t> stack_index;
+
+  for (thread_info *tp : threads)
+    {
+      bt_batch_stack stack;
+
+      switch_to_thread (tp);
+      bt_batch_collect (cache, count, &stack);
+
+      auto key = std::make_pair (stack.frames,
+				 string_printf ("%d%s", (int) stack.end,
+						stack.reason.c_str ()));
+      auto iter = stack_index.find (key);
+      if (iter == stack_index.end ())
+	{
+	  stack_index.emplace (std::move (key), stacks.size ());
+	  stack.threads.push_back (tp);
+	  stacks.push_back (std::move (stack));
+	}
+      else
+	stacks[iter->second].threads.push_back (tp);
+    }
+
+  /* The most common backtraces first.  */
+  std::stable_sort (stacks.begin (), stacks.end (),
+		    [] (const bt_batch_stack &a, const bt_batch_stack &b)
+		    {
+		      return a.threads.size () > b.threads.size ();
+		    });
+
+  for (const bt_batch_stack &stack : stacks)
+    bt_batch_print_stack (uiout, stack, from_tty);
+}
+
 /* Create an option_def_group array grouping all the "backtrace"
    options, with FP_OPTS, BT_CMD_OPT, SET_BT_OPTS as contexts.  */
 
@@ -2156,6 +2653,26 @@ backtrace_command (const char *arg, int from_tty)
   scoped_restore restore_set_backtrace_options
     = make_scoped_restore (&user_set_backtrace_options, set_bt_opts);
 
+  if (bt_cmd_opts.all_threads || bt_cmd_opts.unique)
+    {
+      int count = -1;
+
+      if (bt_cmd_opts.full)
+	error (_("-full can't be used with -all-threads or -unique."));
+      if (!target_has_stack)
+	error (_("No stack."));
+      if (arg != NULL)
+	{
+	  count = parse_and_eval_long (arg);
+	  if (count < 0)
+	    error (_("A negative COUNT can't be used with -all-threads "
+		     "or -unique."));
+	}
+
+      backtrace_all_threads (count, bt_cmd_opts.unique, from_tty);
+      return;
+    }
+
   backtrace_command_1 (fp_opts, bt_cmd_opts, arg, from_tty);
 }
 
@@ -64,6 +64,14 @@ struct symtab* get_last_displayed_symtab (void);
 int get_last_displayed_line (void);
 symtab_and_line get_last_displayed_sal ();
 
+/* Print the backtraces of all threads, or of their innermost COUNT
+   frames if COUNT is not -1, sharing the symbol lookups of the frames
+   they have in common.  The frames' arguments are not printed.  If
+   UNIQUE, print each distinct backtrace once, along with the threads
+   that share it, the most common first.  */
+
+void backtrace_all_threads (int count, bool unique, int from_tty);
+
 /* Completer for the "frame apply all" command.  */
 void frame_apply_all_cmd_completer (struct cmd_list_element *ignore,
 				    completion_tracker &tracker,
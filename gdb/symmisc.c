@@ -39,6 +39,7 @@
 #include "readline/readline.h"
 
 #include "psymtab.h"
+#include "dwarf2-frame.h"
 
 /* Unfortunately for debugging, stderr is usually a macro.  This is painful
    when calling functions that take FILE *'s from the debugger.
@@ -105,6 +106,7 @@ print_objfile_statistics (void)
 			 OBJSTAT (objfile, n_types));
       if (objfile->sf)
 	objfile->sf->qf->print_stats (objfile);
+      dwarf2_frame_print_statistics (objfile);
       i = linetables = 0;
       for (compunit_symtab *cu : objfile->compunits ())
 	{
@@ -114,6 +114,8 @@
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_find_memory_region_ftype(X) \
   target_debug_do_print (host_address_to_string (X))
+#define target_debug_print_search_memory_found_ftype(X) \
+  target_debug_do_print (host_address_to_string (&X))
 #define target_debug_print_bfd_p(X) \
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_std_vector_mem_region(X) \
@@ -36,6 +36,7 @@ struct dummy_target : public target_ops
   int remove_mask_watchpoint (CORE_ADDR arg0, CORE_ADDR arg1, enum target_hw_bp_type arg2) override;
   bool stopped_by_watchpoint () override;
   bool have_steppable_watchpoint () override;
+  bool stopped_by_nonsteppable_watchpoint () override;
   bool stopped_data_address (CORE_ADDR *arg0) override;
   bool watchpoint_addr_within_range (CORE_ADDR arg0, CORE_ADDR arg1, int arg2) override;
   int region_ok_for_hw_watchpoint (CORE_ADDR arg0, int arg1) override;
@@ -100,6 +101,7 @@ struct dummy_target : public target_ops
   ptid_t get_ada_task_ptid (long arg0, long arg1) override;
   int auxv_parse (gdb_byte **arg0, gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  int search_memory_all (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, ULONGEST arg4, search_memory_found_ftype arg5) override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -107,6 +109,7 @@ struct dummy_target : public target_ops
   bool supports_disable_randomization () override;
   bool supports_string_tracing () override;
   bool supports_evaluation_of_breakpoint_conditions () override;
+  bool stopped_by_false_breakpoint_condition () override;
   bool can_run_breakpoint_commands () override;
   struct gdbarch *thread_architecture (ptid_t arg0) override;
   struct address_space *thread_address_space (ptid_t arg0) override;
@@ -204,6 +207,7 @@ struct debug_target : public target_ops
   int remove_mask_watchpoint (CORE_ADDR arg0, CORE_ADDR arg1, enum target_hw_bp_type arg2) override;
   bool stopped_by_watchpoint () override;
   bool have_steppable_watchpoint () override;
+  bool stopped_by_nonsteppable_watchpoint () override;
   bool stopped_data_address (CORE_ADDR *arg0) override;
   bool watchpoint_addr_within_range (CORE_ADDR arg0, CORE_ADDR arg1, int arg2) override;
   int region_ok_for_hw_watchpoint (CORE_ADDR arg0, int arg1) override;
@@ -268,6 +272,7 @@ struct debug_target : public target_ops
   ptid_t get_ada_task_ptid (long arg0, long arg1) override;
   int auxv_parse (gdb_byte **arg0, gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  int search_memory_all (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, ULONGEST arg4, search_memory_found_ftype arg5) override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -275,6 +280,7 @@ struct debug_target : public target_ops
   bool supports_disable_randomization () override;
   bool supports_string_tracing () override;
   bool supports_evaluation_of_breakpoint_conditions () override;
+  bool stopped_by_false_breakpoint_condition () override;
   bool can_run_breakpoint_commands () override;
   struct gdbarch *thread_architecture (ptid_t arg0) override;
   struct address_space *thread_address_space (ptid_t arg0) override;
@@ -1016,6 +1022,31 @@ debug_target::have_steppable_watchpoint ()
   return result;
 }
 
+bool
+target_ops::stopped_by_nonsteppable_watchpoint ()
+{
+  return this->beneath ()->stopped_by_nonsteppable_watchpoint ();
+}
+
+bool
+dummy_target::stopped_by_nonsteppable_watchpoint ()
+{
+  return false;
+}
+
+bool
+debug_target::stopped_by_nonsteppable_watchpoint ()
+{
+  bool result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->stopped_by_nonsteppable_watchpoint (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->stopped_by_nonsteppable_watchpoint ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->stopped_by_nonsteppable_watchpoint (", this->beneath ()->shortname ());
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::stopped_data_address (CORE_ADDR *arg0)
 {
@@ -2623,6 +2654,42 @@ debug_target::search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2
   return result;
 }
 
+int
+target_ops::search_memory_all (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, ULONGEST arg4, search_memory_found_ftype arg5)
+{
+  return this->beneath ()->search_memory_all (arg0, arg1, arg2, arg3, arg4, arg5);
+}
+
+int
+dummy_target::search_memory_all (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, ULONGEST arg4, search_memory_found_ftype arg5)
+{
+  return default_search_memory_all (this, arg0, arg1, arg2, arg3, arg4, arg5);
+}
+
+int
+debug_target::search_memory_all (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, ULONGEST arg4, search_memory_found_ftype arg5)
+{
+  int result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->search_memory_all (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->search_memory_all (arg0, arg1, arg2, arg3, arg4, arg5);
+  fprintf_unfiltered (gdb_stdlog, "<- %s->search_memory_all (", this->beneath ()->shortname ());
+  target_debug_print_CORE_ADDR (arg0);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_ULONGEST (arg1);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_const_gdb_byte_p (arg2);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_ULONGEST (arg3);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_ULONGEST (arg4);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_search_memory_found_ftype (arg5);
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_int (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::can_execute_reverse ()
 {
@@ -2798,6 +2865,31 @@ debug_target::supports_evaluation_of_breakpoint_conditions ()
   return result;
 }
 
+bool
+target_ops::stopped_by_false_breakpoint_condition ()
+{
+  return this->beneath ()->stopped_by_false_breakpoint_condition ();
+}
+
+bool
+dummy_target::stopped_by_false_breakpoint_condition ()
+{
+  return false;
+}
+
+bool
+debug_target::stopped_by_false_breakpoint_condition ()
+{
+  bool result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->stopped_by_false_breakpoint_condition (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->stopped_by_false_breakpoint_condition ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->stopped_by_false_breakpoint_condition (", this->beneath ()->shortname ());
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::can_run_breakpoint_commands ()
 {
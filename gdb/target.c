@@ -77,6 +77,13 @@ static int default_search_memory (struct target_ops *ops,
 				  ULONGEST pattern_len,
 				  CORE_ADDR *found_addrp);
 
+static int default_search_memory_all (struct target_ops *self,
+				      CORE_ADDR start_addr,
+				      ULONGEST search_space_len,
+				      const gdb_byte *pattern,
+				      ULONGEST pattern_len, ULONGEST align,
+				      search_memory_found_ftype found_cb);
+
 static int default_verify_memory (struct target_ops *self,
 				  const gdb_byte *data,
 				  CORE_ADDR memaddr, ULONGEST size);
@@ -1076,6 +1083,10 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
     {
       DCACHE *dcache = target_dcache_get_or_init ();
 
+      if (stack_cache_enabled_p () && object == TARGET_OBJECT_STACK_MEMORY)
+	return dcache_read_stack_memory_partial (ops, dcache, memaddr,
+						 readbuf, reg_len,
+						 xfered_len);
       return dcache_read_memory_partial (ops, dcache, memaddr, readbuf,
 					 reg_len, xfered_len);
     }
@@ -2206,21 +2217,75 @@ target_read_description (struct target_ops *target)
   return target->read_description ();
 }
 
+/* Return the first occurrence of PATTERN, PATTERN_LEN bytes long, in
+   the LEN bytes at BUF whose address is a multiple of ALIGN, or NULL
+   if there is none.  BUF holds target memory from address BUF_ADDR.
+
+   Candidates are located with memchr on the first byte of the pattern,
+   which the C library implements with vector instructions, and are
+   checked against the last byte of the pattern before comparing all
+   of it.  */
+
+static const gdb_byte *
+find_pattern (const gdb_byte *buf, size_t len, CORE_ADDR buf_addr,
+	      const gdb_byte *pattern, size_t pattern_len, ULONGEST align)
+{
+  if (len < pattern_len)
+    return NULL;
+
+  const gdb_byte *p = buf;
+  const gdb_byte *last = buf + len - pattern_len;
+  gdb_byte first_byte = pattern[0];
+  gdb_byte last_byte = pattern[pattern_len - 1];
+
+  while (p <= last)
+    {
+      p = (const gdb_byte *) memchr (p, first_byte, last - p + 1);
+      if (p == NULL)
+	return NULL;
+
+      if (align > 1)
+	{
+	  ULONGEST misalign = (buf_addr + (p - buf)) % align;
+
+	  if (misalign != 0)
+	    {
+	      /* Skip to the next aligned address.  Check against the
+		 remaining length to avoid forming a pointer past the
+		 end of the buffer.  */
+	      if (align - misalign > (ULONGEST) (last - p))
+		return NULL;
+	      p += align - misalign;
+	      continue;
+	    }
+	}
+
+      if (p[pattern_len - 1] == last_byte
+	  && memcmp (p, pattern, pattern_len) == 0)
+	return p;
+
+      ++p;
+    }
+
+  return NULL;
+}
+
 /* This implements a basic search of memory, reading target memory and
    performing the search here (as opposed to performing the search in on the
    target side with, for example, gdbserver).  */
 
 int
-simple_search_memory (struct target_ops *ops,
-		      CORE_ADDR start_addr, ULONGEST search_space_len,
-		      const gdb_byte *pattern, ULONGEST pattern_len,
-		      CORE_ADDR *found_addrp)
+simple_search_memory_all (struct target_ops *ops,
+			  CORE_ADDR start_addr, ULONGEST search_space_len,
+			  const gdb_byte *pattern, ULONGEST pattern_len,
+			  ULONGEST align, search_memory_found_ftype found_cb)
 {
   /* NOTE: also defined in find.c testcase.  */
-#define SEARCH_CHUNK_SIZE 16000
+#define SEARCH_CHUNK_SIZE (256 * 1024)
   const unsigned chunk_size = SEARCH_CHUNK_SIZE;
   /* Buffer to hold memory contents for searching.  */
   unsigned search_buf_size;
+  int found_count = 0;
 
   search_buf_size = chunk_size + pattern_len - 1;
 
@@ -2246,26 +2311,29 @@ simple_search_memory (struct target_ops *ops,
 
      The loop is kept simple by allocating [N + pattern-length - 1] bytes.
      When we've scanned N bytes we copy the trailing bytes to the start and
-     read in another N bytes.  */
+     read in another N bytes.  Every match found in the buffer starts in
+     its first N bytes, so no match is reported twice.  */
 
   while (search_space_len >= pattern_len)
     {
-      gdb_byte *found_ptr;
       unsigned nr_search_bytes
 	= std::min (search_space_len, (ULONGEST) search_buf_size);
+      const gdb_byte *p = search_buf.data ();
+      const gdb_byte *end = search_buf.data () + nr_search_bytes;
 
-      found_ptr = (gdb_byte *) memmem (search_buf.data (), nr_search_bytes,
-				       pattern, pattern_len);
-
-      if (found_ptr != NULL)
+      while ((p = find_pattern (p, end - p,
+				start_addr + (p - search_buf.data ()),
+				pattern, pattern_len, align)) != NULL)
 	{
-	  CORE_ADDR found_addr = start_addr + (found_ptr - search_buf.data ());
+	  CORE_ADDR found_addr = start_addr + (p - search_buf.data ());
 
-	  *found_addrp = found_addr;
-	  return 1;
+	  ++found_count;
+	  if (!found_cb (found_addr))
+	    return found_count;
+	  ++p;
 	}
 
-      /* Not found in this chunk, skip to next chunk.  */
+      /* Skip to next chunk.  */
 
       /* Don't let search_space_len wrap here, it's unsigned.  */
       if (search_space_len >= chunk_size)
@@ -2302,9 +2370,26 @@ simple_search_memory (struct target_ops *ops,
 	}
     }
 
-  /* Not found.  */
+  return found_count;
+}
+
+/* See target.h.  */
 
-  return 0;
+int
+simple_search_memory (struct target_ops *ops,
+		      CORE_ADDR start_addr, ULONGEST search_space_len,
+		      const gdb_byte *pattern, ULONGEST pattern_len,
+		      CORE_ADDR *found_addrp)
+{
+  int found = simple_search_memory_all (ops, start_addr, search_space_len,
+					pattern, pattern_len, 1,
+					[&] (CORE_ADDR addr)
+					{
+					  *found_addrp = addr;
+					  return false;
+					});
+
+  return found > 0 ? 1 : found;
 }
 
 /* Default implementation of memory-searching.  */
@@ -2321,6 +2406,20 @@ default_search_memory (struct target_ops *self,
 			       pattern, pattern_len, found_addrp);
 }
 
+/* Default implementation of searching memory for all matches.  */
+
+static int
+default_search_memory_all (struct target_ops *self,
+			   CORE_ADDR start_addr, ULONGEST search_space_len,
+			   const gdb_byte *pattern, ULONGEST pattern_len,
+			   ULONGEST align, search_memory_found_ftype found_cb)
+{
+  /* Start over from the top of the target stack.  */
+  return simple_search_memory_all (current_top_target (),
+				   start_addr, search_space_len,
+				   pattern, pattern_len, align, found_cb);
+}
+
 /* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for the
    sequence of bytes in PATTERN with length PATTERN_LEN.
 
@@ -2337,6 +2436,19 @@ target_search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 				      pattern, pattern_len, found_addrp);
 }
 
+/* See target.h.  */
+
+int
+target_search_memory_all (CORE_ADDR start_addr, ULONGEST search_space_len,
+			  const gdb_byte *pattern, ULONGEST pattern_len,
+			  ULONGEST align, search_memory_found_ftype found_cb)
+{
+  return current_top_target ()->search_memory_all (start_addr,
+						   search_space_len,
+						   pattern, pattern_len,
+						   align, found_cb);
+}
+
 /* Look through the currently pushed targets.  If none of them will
    be able to restart the currently running process, issue an error
    message.  */
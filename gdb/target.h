@@ -82,6 +82,11 @@ struct inferior;
 #include "tracepoint.h"
 
 #include "gdbsupport/break-common.h" /* For enum target_hw_bp_type.  */
+#include "gdbsupport/function-view.h"
+
+/* Callback for target_ops::search_memory_all.  Called with the address
+   of each match; return false to stop the search.  */
+typedef gdb::function_view<bool (CORE_ADDR)> search_memory_found_ftype;
 
 enum strata
   {
@@ -556,6 +561,8 @@ struct target_ops
       TARGET_DEFAULT_RETURN (false);
     virtual bool have_steppable_watchpoint ()
       TARGET_DEFAULT_RETURN (false);
+    virtual bool stopped_by_nonsteppable_watchpoint ()
+      TARGET_DEFAULT_RETURN (false);
     virtual bool stopped_data_address (CORE_ADDR *)
       TARGET_DEFAULT_RETURN (false);
     virtual bool watchpoint_addr_within_range (CORE_ADDR, CORE_ADDR, int)
@@ -837,6 +844,21 @@ struct target_ops
 			       CORE_ADDR *found_addrp)
       TARGET_DEFAULT_FUNC (default_search_memory);
 
+    /* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for all
+       occurrences of the sequence of bytes in PATTERN with length
+       PATTERN_LEN, calling FOUND_CB with the address of each one, in
+       increasing order, until it returns false.  Only matches whose
+       address is a multiple of ALIGN are reported.
+
+       The result is the number of matches reported, or -1 if there was
+       an error requiring halting of the search.  */
+    virtual int search_memory_all (CORE_ADDR start_addr,
+				   ULONGEST search_space_len,
+				   const gdb_byte *pattern,
+				   ULONGEST pattern_len, ULONGEST align,
+				   search_memory_found_ftype found_cb)
+      TARGET_DEFAULT_FUNC (default_search_memory_all);
+
     /* Can target execute in reverse?  */
     virtual bool can_execute_reverse ()
       TARGET_DEFAULT_RETURN (false);
@@ -870,6 +892,11 @@ struct target_ops
     virtual bool supports_evaluation_of_breakpoint_conditions ()
       TARGET_DEFAULT_RETURN (false);
 
+    /* Did the current thread stop at a breakpoint whose conditions the
+       target evaluated, and found all false?  */
+    virtual bool stopped_by_false_breakpoint_condition ()
+      TARGET_DEFAULT_RETURN (false);
+
     /* Does this target support evaluation of breakpoint commands on its
        end?  */
     virtual bool can_run_breakpoint_commands ()
@@ -1465,6 +1492,12 @@ int target_supports_disable_randomization (void);
 #define target_supports_evaluation_of_breakpoint_conditions() \
   (current_top_target ()->supports_evaluation_of_breakpoint_conditions) ()
 
+/* Returns true if the current thread stopped at a breakpoint whose
+   conditions the target found all false.  */
+
+#define target_stopped_by_false_breakpoint_condition() \
+  (current_top_target ()->stopped_by_false_breakpoint_condition) ()
+
 /* Returns true if this target can handle breakpoint commands
    on its end.  */
 
@@ -1963,6 +1996,13 @@ extern gdb::byte_vector target_thread_info_to_thread_handle
 #define target_have_steppable_watchpoint \
   (current_top_target ()->have_steppable_watchpoint ())
 
+/* Returns true if the current thread stopped at a watchpoint before
+   the access was made, and must be stepped over it with watchpoints
+   removed, whatever gdbarch_have_nonsteppable_watchpoint says.  */
+
+#define target_stopped_by_nonsteppable_watchpoint() \
+  (current_top_target ()->stopped_by_nonsteppable_watchpoint ())
+
 /* Provide defaults for hardware watchpoint functions.  */
 
 /* If the *_hw_beakpoint functions have not been defined
@@ -2082,6 +2122,15 @@ extern int simple_search_memory (struct target_ops* ops,
                                  ULONGEST pattern_len,
                                  CORE_ADDR *found_addrp);
 
+/* Utility implementation of searching memory for all matches of a
+   pattern.  See target_ops::search_memory_all.  */
+extern int simple_search_memory_all (struct target_ops *ops,
+				     CORE_ADDR start_addr,
+				     ULONGEST search_space_len,
+				     const gdb_byte *pattern,
+				     ULONGEST pattern_len, ULONGEST align,
+				     search_memory_found_ftype found_cb);
+
 /* Main entry point for searching memory.  */
 extern int target_search_memory (CORE_ADDR start_addr,
                                  ULONGEST search_space_len,
@@ -2089,6 +2138,14 @@ extern int target_search_memory (CORE_ADDR start_addr,
                                  ULONGEST pattern_len,
                                  CORE_ADDR *found_addrp);
 
+/* Main entry point for searching memory for all matches of a
+   pattern.  */
+extern int target_search_memory_all (CORE_ADDR start_addr,
+				     ULONGEST search_space_len,
+				     const gdb_byte *pattern,
+				     ULONGEST pattern_len, ULONGEST align,
+				     search_memory_found_ftype found_cb);
+
 /* Target file operations.  */
 
 /* Return nonzero if the filesystem seen by the current inferior
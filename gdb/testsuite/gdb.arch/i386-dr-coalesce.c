@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Eight adjacent fields, each needing its own debug register if
+   watched separately.  */
+struct fields
+{
+  char c[8];
+} __attribute__ ((aligned (8)));
+
+struct fields fields;
+
+/* Fields separated by padding that nobody watches.  */
+struct padded
+{
+  char b0, p0, b1, p1;
+} __attribute__ ((aligned (4)));
+
+struct padded w1, w2, w3;
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+    fields.c[i] = i + 1;
+
+  w1.p0 = 1;	/* padded start */
+  w2.p1 = 1;
+  w3.p0 = 1;
+
+  w1.b0 = 1;
+  w1.b1 = 2;
+  w2.b0 = 3;
+  w2.b1 = 4;
+  w3.b0 = 5;
+
+  return 0;	/* break at exit */
+}
@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+#include <stddef.h>
+
+#define UNTOUCHED_SIZE (16 * 1024 * 1024)
+#define SPARSE_SIZE (4 * 1024 * 1024)
+
+/* A mapping that is never written to.  */
+char *untouched;
+
+/* A mapping with one byte written every megabyte.  */
+char *sparse;
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  size_t i;
+
+  untouched = mmap (NULL, UNTOUCHED_SIZE, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  sparse = mmap (NULL, SPARSE_SIZE, PROT_READ | PROT_WRITE,
+		 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (untouched == MAP_FAILED || sparse == MAP_FAILED)
+    return 1;
+
+  for (i = 0; i < SPARSE_SIZE; i += 1024 * 1024)
+    sparse[i] = 0x5a;
+
+  marker ();
+  return 0;
+}
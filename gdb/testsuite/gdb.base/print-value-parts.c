@@ -0,0 +1,64 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct big
+{
+  int a : 3;
+  unsigned int b : 5;
+  char name[8];
+  int elts[20000];
+  double d;
+};
+
+struct big big_struct;
+
+/* Points at the last four ints of a mapped page, followed by an
+   unmapped one.  */
+int (*tail)[4096];
+
+static void
+stop (void)
+{
+}
+
+int
+main (void)
+{
+  long pagesize = sysconf (_SC_PAGESIZE);
+  char *p = mmap (0, 2 * pagesize, PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (p == MAP_FAILED)
+    return 1;
+  munmap (p + pagesize, pagesize);
+  tail = (int (*)[4096]) (p + pagesize - 4 * sizeof (int));
+  (*tail)[0] = 1;
+  (*tail)[1] = 2;
+
+  big_struct.a = -2;
+  big_struct.b = 17;
+  strcpy (big_struct.name, "abc");
+  big_struct.elts[3] = 9;
+  big_struct.d = 2.5;
+
+  stop ();
+  return 0;
+}
@@ -0,0 +1,63 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+/* Too big for the debug registers.  */
+struct big
+{
+  int a[64];
+};
+
+struct big big;
+
+/* Shares a page with BIG, and must not trigger the watchpoint.  */
+int neighbour[16];
+
+int v1, v2, v3, v4, v5, v6;
+
+/* Spans several pages.  */
+char pages[6 * 4096] __attribute__ ((aligned (4096)));
+
+/* Spans too many pages for page protection.  */
+char huge[2048 * 4096];
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    neighbour[i] = i;		/* break here */
+
+  big.a[10] = 1;		/* big first write */
+  big.a[63] = 2;		/* big second write */
+
+  v1 = 1;
+  v2 = 2;
+  v3 = 3;
+  v4 = 4;
+  v5 = 5;
+  v6 = 6;
+
+  /* A single access to two protected pages.  */
+  *(volatile int *) (pages + 4096 - 2) = -1;	/* straddling write */
+
+  memset (pages, 1, sizeof pages);		/* all pages */
+
+  return 0;			/* break at exit */
+}
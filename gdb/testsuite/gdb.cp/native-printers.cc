@@ -0,0 +1,59 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct holder
+{
+  std::vector<int> numbers;
+  std::string name;
+};
+
+static void
+marker1 ()
+{
+}
+
+int
+main ()
+{
+  std::vector<int> v = {1, 2, 3};
+  v.reserve (4);
+  std::vector<int> empty_v;
+  std::vector<std::string> vs = {"a", "bc"};
+  std::string s = "hello";
+  std::unordered_map<int, int> um = {{1, 2}};
+  std::shared_ptr<int> sp = std::make_shared<int> (5);
+  std::shared_ptr<int> sp2 = sp;
+  std::weak_ptr<int> wp = sp;
+  std::shared_ptr<int> empty_sp;
+  std::shared_ptr<int> gone = std::make_shared<int> (6);
+  std::weak_ptr<int> expired = gone;
+  gone.reset ();
+  std::deque<int> d = {4, 5, 6};
+  std::deque<long> big_d;
+  for (long i = 0; i < 200; i++)
+    big_d.push_back (i);
+  holder h = {{7, 8}, "h"};
+
+  marker1 ();
+  return 0;
+}
@@ -0,0 +1,38 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define BIG 1000000
+
+int big[BIG];
+
+int
+locals (int x, int y)
+{
+  int a = x + 1;
+  int b = y + 2;
+  int c = a + b;
+  int d = c * 2;
+
+  return a + b + c + d;		/* Locals set.  */
+}
+
+int
+main (void)
+{
+  big[BIG - 5] = 7;		/* Change an element.  */
+  return locals (1, 2);		/* Call locals.  */
+}
@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct inner
+{
+  int a;
+  char name[8];
+};
+
+struct outer
+{
+  int counter;
+  struct inner in;
+  int arr[4];
+  struct inner *ptr;
+  char *str;
+};
+
+char buffer[16] = "abc";
+struct inner target = { 5, "t" };
+struct outer b = { 0, { 1, "in" }, { 1, 2, 3, 4 }, &target, buffer };
+
+int
+main (void)
+{
+  b.counter++;		/* Change the counter.  */
+  target.a = 6;		/* Change the pointed-to object.  */
+  buffer[0] = 'x';	/* Change the string.  */
+  b.arr[2] = 30;	/* Change an array element.  */
+  b.ptr = 0;		/* Clear the pointer.  */
+  return 0;		/* Done.  */
+}
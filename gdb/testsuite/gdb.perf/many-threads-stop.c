@@ -0,0 +1,79 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 1000
+#endif
+
+static pthread_barrier_t barrier;
+
+static void *
+thread_function (void *arg)
+{
+  pthread_barrier_wait (&barrier);
+
+  while (1)
+    pause ();
+
+  return NULL;
+}
+
+volatile int counter;
+
+static void
+stop_here (void)
+{
+  counter++;
+}
+
+static void
+all_started (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int i, res;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  /* Keep the memory footprint down, so that many threads fit.  */
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, 64 * 1024);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      res = pthread_create (&thread, &attr, thread_function, NULL);
+      assert (res == 0);
+    }
+
+  pthread_barrier_wait (&barrier);
+  all_started ();
+
+  while (1)
+    stop_here ();
+
+  return 0;
+}
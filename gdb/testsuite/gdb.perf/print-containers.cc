@@ -0,0 +1,47 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#ifndef NUM_ELEMENTS
+#define NUM_ELEMENTS 1000000
+#endif
+
+static void
+stop_here ()
+{
+}
+
+int
+main ()
+{
+  std::vector<int> vector_1;
+  std::deque<int> deque_1;
+  std::unordered_map<int, int> unordered_map_1;
+
+  for (int i = 0; i < NUM_ELEMENTS; i++)
+    {
+      vector_1.push_back (i);
+      deque_1.push_back (i);
+      unordered_map_1[i] = i;
+    }
+
+  stop_here ();
+  return 0;
+}
@@ -0,0 +1,41 @@
+# Copyright (C) 2019 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+from perftest import utils
+
+class PrintContainers (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, elements):
+        super (PrintContainers, self).__init__ ("print-containers-%d"
+                                                % elements)
+
+    def warm_up(self):
+        utils.safe_execute("print vector_1")
+
+    def execute_test(self):
+        # Each measurement is keyed by the container printed and by
+        # whether the native pretty-printers were used.  They are only
+        # used when no Python printer applies, so the Python printers
+        # are disabled while they are on.
+        for native in ("on", "off"):
+            utils.safe_execute("set print native-printers %s" % native)
+            if native == "on":
+                utils.safe_execute("disable pretty-printer")
+            else:
+                utils.safe_execute("enable pretty-printer")
+            for container in ("vector_1", "deque_1", "unordered_map_1"):
+                func = lambda: utils.safe_execute("print %s" % container)
+                self.measure.measure(func, "%s-native-%s"
+                                     % (container, native))
@@ -4,7 +4,7 @@
 #include <string.h>
 #include <pthread.h>
 
-#define CHUNK_SIZE 16000 /* same as findcmd.c's */
+#define CHUNK_SIZE (256 * 1024) /* same as findcmd.c's */
 #define BUF_SIZE (2 * CHUNK_SIZE) /* at least two chunks */
 #define NUMTH 8
 
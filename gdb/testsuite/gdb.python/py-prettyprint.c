@@ -163,6 +163,18 @@ struct justchildren
   int *elements;
 };
 
+/* A container whose elements are contiguous in memory.  */
+
+struct contiguous
+{
+  int len;
+  int *elements;
+};
+
+int carray[] = { 10, 20, 30 };
+struct contiguous contig = { 3, carray };
+struct contiguous bad_contig = { 3, 0 };
+
 typedef struct justchildren nostring_type;
 
 struct memory_error
@@ -219,6 +219,23 @@ class pp_children_as_list (object):
     def children (self):
         return [('one', 1)]
 
+class pp_contiguous (object):
+    "Return the children as an array value"
+
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return 'contiguous with %d elements' % int(self.val['len'])
+
+    def children(self):
+        elements = self.val['elements']
+        array_type = elements.type.target().array(int(self.val['len']) - 1)
+        return elements.cast(array_type.pointer()).dereference()
+
+    def display_hint (self):
+        return 'array'
+
 class pp_outer (object):
     "Print struct outer"
 
@@ -370,6 +387,8 @@ def register_pretty_printers ():
 
     pretty_printers_dict[re.compile ('^struct children_as_list$')]  = pp_children_as_list
     pretty_printers_dict[re.compile ('^children_as_list$')]  = pp_children_as_list
+    pretty_printers_dict[re.compile ('^struct contiguous$')]  = pp_contiguous
+    pretty_printers_dict[re.compile ('^contiguous$')]  = pp_contiguous
 
     pretty_printers_dict[re.compile ('^memory_error$')]  = MemoryErrorString
 
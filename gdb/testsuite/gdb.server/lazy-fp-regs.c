@@ -0,0 +1,59 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdint.h>
+
+volatile uint64_t in_value;
+volatile uint64_t out_value;
+
+void
+done (void)
+{
+}
+
+/* Load IN_VALUE into %xmm7, which must hold it across the stop at
+   xmm_stop, then store %xmm7 into OUT_VALUE.  */
+
+__attribute__ ((noinline)) void
+roundtrip (void)
+{
+  uint64_t out;
+
+  asm volatile ("movq %1, %%xmm7\n\t"
+		".globl xmm_stop\n"
+		"xmm_stop:\n\t"
+		"nop\n\t"
+		"movq %%xmm7, %0"
+		: "=r" (out) : "r" (in_value) : "xmm7");
+  out_value = out;
+  done ();
+}
+
+int
+main (void)
+{
+  in_value = 0x1111111111111111ULL;
+  roundtrip ();
+
+  in_value = 0x2222222222222222ULL;
+  roundtrip ();
+
+  in_value = 0x3333333333333333ULL;
+  roundtrip ();
+
+  return 0;
+}
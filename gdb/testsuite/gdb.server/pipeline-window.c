@@ -0,0 +1,38 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Large enough to take several "m" packets to read.  */
+#define BUF_SIZE (256 * 1024)
+
+unsigned char buf[BUF_SIZE];
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < BUF_SIZE; i++)
+    buf[i] = (i * 7 + i / 251) & 0xff;
+
+  marker ();
+  return 0;
+}
@@ -0,0 +1,75 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+#define NUM_THREADS 6
+
+static pthread_barrier_t ready;
+
+/* Never completes, since only the worker threads wait on it.  */
+static pthread_barrier_t never;
+
+static void __attribute__ ((noinline))
+block_even (void)
+{
+  pthread_barrier_wait (&never);
+}
+
+static void __attribute__ ((noinline))
+block_odd (void)
+{
+  pthread_barrier_wait (&never);
+}
+
+static void *
+thread_func (void *arg)
+{
+  int i = (int) (long) arg;
+
+  pthread_barrier_wait (&ready);
+
+  if (i % 2 == 0)
+    block_even ();
+  else
+    block_odd ();
+
+  return NULL;
+}
+
+static void
+all_threads_ready (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  long i;
+
+  pthread_barrier_init (&ready, NULL, NUM_THREADS + 1);
+  pthread_barrier_init (&never, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_func, (void *) i);
+
+  pthread_barrier_wait (&ready);
+
+  all_threads_ready ();
+  return 0;
+}
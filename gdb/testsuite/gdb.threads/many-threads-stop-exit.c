@@ -0,0 +1,79 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <assert.h>
+
+#define NUM_THREADS 64
+
+static pthread_barrier_t barrier;
+
+pthread_t threads[NUM_THREADS];
+
+void
+thread_break (void)
+{
+}
+
+static void *
+thread_function (void *arg)
+{
+  long i = (long) arg;
+
+  pthread_barrier_wait (&barrier);
+
+  /* All threads leave the barrier at once.  Half of them hit a
+     breakpoint, while the other half exit, so threads keep exiting
+     while GDB stops all of them to report the hits.  */
+  if (i % 2 == 0)
+    thread_break ();
+
+  return NULL;
+}
+
+static void
+all_done (void)
+{
+}
+
+int
+main (void)
+{
+  long i;
+  int res;
+
+  alarm (300);
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      res = pthread_create (&threads[i], NULL, thread_function, (void *) i);
+      assert (res == 0);
+    }
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      res = pthread_join (threads[i], NULL);
+      assert (res == 0);
+    }
+
+  all_done ();
+
+  return 0;
+}
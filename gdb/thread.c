@@ -236,9 +236,44 @@ init_thread_list (void)
 	set_thread_exited (tp, 1);
 
       inf->thread_list = NULL;
+      inf->thread_list_tail = NULL;
+      inf->ptid_thread_map.clear ();
     }
 }
 
+/* Record in TP's inferior that TP is the thread to return when
+   looking up its ptid.  */
+
+static void
+add_thread_ptid_mapping (thread_info *tp)
+{
+  tp->inf->ptid_thread_map[tp->ptid] = tp;
+}
+
+/* Forget the ptid lookup entry for TP, if TP is the thread recorded
+   for its ptid.  */
+
+static void
+remove_thread_ptid_mapping (thread_info *tp)
+{
+  auto &map = tp->inf->ptid_thread_map;
+  auto it = map.find (tp->ptid);
+
+  if (it != map.end () && it->second == tp)
+    map.erase (it);
+}
+
+/* Change the ptid of TP to PTID, keeping TP's inferior's ptid lookup
+   map in sync.  */
+
+static void
+set_thread_ptid (thread_info *tp, ptid_t ptid)
+{
+  remove_thread_ptid_mapping (tp);
+  tp->ptid = ptid;
+  add_thread_ptid_mapping (tp);
+}
+
 /* Allocate a new thread of inferior INF with target id PTID and add
    it to the thread list.  */
 
@@ -250,13 +285,10 @@ new_thread (struct inferior *inf, ptid_t ptid)
   if (inf->thread_list == NULL)
     inf->thread_list = tp;
   else
-    {
-      struct thread_info *last;
+    inf->thread_list_tail->next = tp;
+  inf->thread_list_tail = tp;
 
-      for (last = inf->thread_list; last->next != NULL; last = last->next)
-	;
-      last->next = tp;
-    }
+  add_thread_ptid_mapping (tp);
 
   return tp;
 }
@@ -293,7 +325,7 @@ add_thread_silent (ptid_t ptid)
 	  delete_thread (tp);
 
 	  /* Now reset its ptid, and reswitch inferior_ptid to it.  */
-	  new_thr->ptid = ptid;
+	  set_thread_ptid (new_thr, ptid);
 	  new_thr->state = THREAD_STOPPED;
 	  switch_to_thread (new_thr);
 
@@ -475,6 +507,10 @@ delete_thread_1 (thread_info *thr, bool silent)
     tpprev->next = tp->next;
   else
     tp->inf->thread_list = tp->next;
+  if (tp->inf->thread_list_tail == tp)
+    tp->inf->thread_list_tail = tpprev;
+
+  remove_thread_ptid_mapping (tp);
 
   delete tp;
 }
@@ -532,9 +568,9 @@ find_thread_ptid (ptid_t ptid)
 struct thread_info *
 find_thread_ptid (inferior *inf, ptid_t ptid)
 {
-  for (thread_info *tp : inf->threads ())
-    if (tp->ptid == ptid)
-      return tp;
+  auto it = inf->ptid_thread_map.find (ptid);
+  if (it != inf->ptid_thread_map.end ())
+    return it->second;
 
   return NULL;
 }
@@ -772,7 +808,7 @@ thread_change_ptid (ptid_t old_ptid, ptid_t new_ptid)
   inf->pid = new_ptid.pid ();
 
   tp = find_thread_ptid (inf, old_ptid);
-  tp->ptid = new_ptid;
+  set_thread_ptid (tp, new_ptid);
 
   gdb::observers::thread_ptid_changed.notify (old_ptid, new_ptid);
 }
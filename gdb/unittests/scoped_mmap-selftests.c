@@ -71,12 +71,43 @@ test_release ()
   munmap (mem, sysconf (_SC_PAGESIZE));
 }
 
+/* Test that move-assigning unmaps the old memory and transfers
+   ownership of the new one.  */
+static void
+test_move_assign ()
+{
+  void *old_mem, *new_mem;
+
+  errno = 0;
+  {
+    ::scoped_mmap smmap (nullptr, sysconf (_SC_PAGESIZE), PROT_WRITE,
+			 MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    ::scoped_mmap other (nullptr, sysconf (_SC_PAGESIZE), PROT_WRITE,
+			 MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+
+    old_mem = smmap.get ();
+    new_mem = other.get ();
+    SELF_CHECK (old_mem != MAP_FAILED && new_mem != MAP_FAILED);
+
+    smmap = std::move (other);
+    SELF_CHECK (smmap.get () == new_mem);
+    SELF_CHECK (other.get () == MAP_FAILED);
+    SELF_CHECK (msync (old_mem, sysconf (_SC_PAGESIZE), 0) == -1
+		&& errno == ENOMEM);
+    SELF_CHECK (msync (new_mem, sysconf (_SC_PAGESIZE), 0) == 0);
+  }
+
+  SELF_CHECK (msync (new_mem, sysconf (_SC_PAGESIZE), 0) == -1
+	      && errno == ENOMEM);
+}
+
 /* Run selftests.  */
 static void
 run_tests ()
 {
   test_destroy ();
   test_release ();
+  test_move_assign ();
 }
 
 } /* namespace scoped_mmap */
@@ -36,6 +36,7 @@
 #include <ctype.h>
 #include <algorithm>
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/scope-exit.h"
 #include "cli/cli-option.h"
 #include "gdbarch.h"
 #include "cli/cli-style.h"
@@ -1164,6 +1165,22 @@ value_check_printable (struct value *val, struct ui_file *stream,
   return 1;
 }
 
+/* Start reading lazy value VAL in parts if LANGUAGE's printers read
+   the parts of a value they print as they go; this spares reading all
+   of a large value to print a little of it.  Return true if VAL is
+   now being read in parts.  */
+
+static bool
+val_print_begin_fetch_in_parts (struct value *val,
+				const struct language_defn *language)
+{
+  return (val != NULL
+	  && value_lazy (val)
+	  && language == current_language
+	  && language->la_val_print_fetches_in_parts
+	  && value_begin_fetch_in_parts (val));
+}
+
 /* Print using the given LANGUAGE the value VAL onto stream STREAM according
    to OPTIONS.
 
@@ -1175,6 +1192,13 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
 		  const struct value_print_options *options,
 		  const struct language_defn *language)
 {
+  bool in_parts = val_print_begin_fetch_in_parts (val, language);
+  SCOPE_EXIT
+    {
+      if (in_parts)
+	value_end_fetch_in_parts (val);
+    };
+
   if (!value_check_printable (val, stream, options))
     return;
 
@@ -1185,7 +1209,7 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     val = ada_to_fixed_value (val);
 
-  if (value_lazy (val))
+  if (value_lazy (val) && !in_parts)
     value_fetch_lazy (val);
 
   val_print (value_type (val),
@@ -1201,6 +1225,13 @@ void
 value_print (struct value *val, struct ui_file *stream,
 	     const struct value_print_options *options)
 {
+  bool in_parts = val_print_begin_fetch_in_parts (val, current_language);
+  SCOPE_EXIT
+    {
+      if (in_parts)
+	value_end_fetch_in_parts (val);
+    };
+
   if (!value_check_printable (val, stream, options))
     return;
 
@@ -1300,9 +1331,10 @@ val_print_scalar_formatted (struct type *type,
       return;
     }
 
-  /* value_contents_for_printing fetches all VAL's contents.  They are
-     needed to check whether VAL is optimized-out or unavailable
-     below.  */
+  /* value_contents_for_printing fetches all VAL's contents, unless
+     VAL is being read in parts, in which case the caller has read the
+     part printed here.  They are needed to check whether VAL is
+     optimized-out or unavailable below.  */
   const gdb_byte *valaddr = value_contents_for_printing (val);
 
   /* A scalar object that does not have all bits available can't be
@@ -2055,14 +2087,28 @@ val_print_array_elements (struct type *type,
 	 UINT_MAX (unlimited).  */
       if (options->repeat_count_threshold < UINT_MAX)
 	{
-	  while (rep1 < len
-		 && value_contents_eq (val,
-				       embedded_offset + i * eltlen,
-				       val,
-				       (embedded_offset
-					+ rep1 * eltlen),
-				       eltlen))
+	  /* VAL may be being read in parts; read the elements compared
+	     as we go.  An element that can't be read ends the repeats,
+	     and is reported when printed.  */
+	  while (rep1 < len)
 	    {
+	      try
+		{
+		  value_fetch_lazy_range (val, embedded_offset + i * eltlen,
+					  eltlen);
+		  value_fetch_lazy_range (val, embedded_offset + rep1 * eltlen,
+					  eltlen);
+		}
+	      catch (const gdb_exception_error &ex)
+		{
+		  if (ex.error != MEMORY_ERROR)
+		    throw;
+		  break;
+		}
+	      if (!value_contents_eq (val, embedded_offset + i * eltlen,
+				      val, embedded_offset + rep1 * eltlen,
+				      eltlen))
+		break;
 	      ++reps;
 	      ++rep1;
 	    }
@@ -2813,6 +2859,70 @@ generic_printstr (struct ui_file *stream, struct type *type,
   fputs_filtered ((const char *) obstack_base (&output), stream);
 }
 
+/* The number of bytes array_element_reader reads from memory at
+   once.  */
+
+#define ARRAY_ELEMENT_READER_CHUNK_SIZE 8192
+
+/* See valprint.h.  */
+
+array_element_reader::array_element_reader (struct value *array)
+  : m_array (value_ref_ptr::new_reference (array))
+{
+  struct type *type = check_typedef (value_type (array));
+
+  gdb_assert (TYPE_CODE (type) == TYPE_CODE_ARRAY);
+  if (!get_array_bounds (type, &m_low, &m_high))
+    gdb_assert_not_reached ("array without known bounds");
+}
+
+/* See valprint.h.  */
+
+struct value *
+array_element_reader::element (LONGEST i)
+{
+  gdb_assert (i >= 0 && i < count ());
+
+  struct type *type = check_typedef (value_type (m_array.get ()));
+  struct type *elttype = TYPE_TARGET_TYPE (type);
+  LONGEST eltlen = TYPE_LENGTH (check_typedef (elttype));
+
+  if (m_chunk == NULL
+      || i < m_chunk_first
+      || i >= m_chunk_first + m_chunk_count)
+    {
+      LONGEST n = std::min (count () - i,
+			    std::max ((LONGEST) 1,
+				      ARRAY_ELEMENT_READER_CHUNK_SIZE / eltlen));
+      struct value *chunk = value_slice (m_array.get (), m_low + i, n);
+
+      try
+	{
+	  if (value_lazy (chunk))
+	    value_fetch_lazy (chunk);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* The rest of the chunk may be unreadable, or larger than
+	     max-value-size, while this element is not.  */
+	  if (n == 1)
+	    throw;
+
+	  n = 1;
+	  chunk = value_slice (m_array.get (), m_low + i, n);
+	  if (value_lazy (chunk))
+	    value_fetch_lazy (chunk);
+	}
+
+      m_chunk = value_ref_ptr::new_reference (chunk);
+      m_chunk_first = i;
+      m_chunk_count = n;
+    }
+
+  return value_from_component (m_chunk.get (), elttype,
+			       (i - m_chunk_first) * eltlen);
+}
+
 /* Print a string from the inferior, starting at ADDR and printing up to LEN
    characters, of WIDTH bytes a piece, to STREAM.  If LEN is -1, printing
    stops at the first null byte, otherwise printing proceeds (including null
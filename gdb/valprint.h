@@ -21,6 +21,7 @@
 #define VALPRINT_H
 
 #include "cli/cli-option.h"
+#include "value.h"
 
 /* This is used to pass formatting options to various value-printing
    functions.  */
@@ -282,4 +283,47 @@ extern bool val_print_check_max_depth (struct ui_file *stream, int recurse,
 				       const struct value_print_options *opts,
 				       const struct language_defn *language);
 
+/* Reads the elements of an array value from memory a chunk at a time,
+   for printers that print them one by one, rather than one element
+   at a time or all of the array at once.  */
+
+class array_element_reader
+{
+public:
+
+  /* ARRAY must be an array value whose bounds are known, with
+     elements of nonzero size.  */
+  explicit array_element_reader (struct value *array);
+
+  /* The array's lower bound.  */
+  LONGEST low_bound () const
+  {
+    return m_low;
+  }
+
+  /* The number of elements.  */
+  LONGEST count () const
+  {
+    return m_high - m_low + 1;
+  }
+
+  /* Return element I, counting from zero, reading the chunk of the
+     array holding it if it hasn't been read yet.  */
+  struct value *element (LONGEST i);
+
+private:
+
+  /* The array value.  */
+  value_ref_ptr m_array;
+
+  /* Its bounds.  */
+  LONGEST m_low, m_high;
+
+  /* The slice of the array read last, the index of its first element,
+     counting from zero, and its number of elements.  */
+  value_ref_ptr m_chunk;
+  LONGEST m_chunk_first = 0;
+  LONGEST m_chunk_count = 0;
+};
+
 #endif
@@ -29,6 +29,7 @@
 #include "language.h"
 #include "demangle.h"
 #include "regcache.h"
+#include "inferior.h"
 #include "block.h"
 #include "target-float.h"
 #include "objfiles.h"
@@ -178,6 +179,7 @@ struct value
       lazy (1),
       initialized (1),
       stack (0),
+      fetch_in_parts (0),
       type (type_),
       enclosing_type (type_)
   {
@@ -228,6 +230,10 @@ struct value
      used instead of read_memory to enable extra caching.  */
   unsigned int stack : 1;
 
+  /* If nonzero, this lazy value is being read in parts; see
+     value_begin_fetch_in_parts.  */
+  unsigned int fetch_in_parts : 1;
+
   /* Location of value (if lval).  */
   union
   {
@@ -356,6 +362,10 @@ struct value
      treated pretty much the same, except not-saved registers have a
      different string representation and related error strings.  */
   std::vector<range> optimized_out;
+
+  /* If FETCH_IN_PARTS, the ranges of CONTENTS that have been read so
+     far, in bits.  */
+  std::vector<range> fetched;
 };
 
 /* See value.h.  */
@@ -369,7 +379,7 @@ get_value_arch (const struct value *value)
 int
 value_bits_available (const struct value *value, LONGEST offset, LONGEST length)
 {
-  gdb_assert (!value->lazy);
+  gdb_assert (!value->lazy || value->fetch_in_parts);
 
   return !ranges_contain (value->unavailable, offset, length);
 }
@@ -386,7 +396,7 @@ value_bytes_available (const struct value *value,
 int
 value_bits_any_optimized_out (const struct value *value, int bit_offset, int bit_length)
 {
-  gdb_assert (!value->lazy);
+  gdb_assert (!value->lazy || value->fetch_in_parts);
 
   return ranges_contain (value->optimized_out, bit_offset, bit_length);
 }
@@ -395,8 +405,9 @@ int
 value_entirely_available (struct value *value)
 {
   /* We can only tell whether the whole value is available when we try
-     to read it.  */
-  if (value->lazy)
+     to read it.  Values read in parts can't be unavailable; see
+     value_begin_fetch_in_parts.  */
+  if (value->lazy && !value->fetch_in_parts)
     value_fetch_lazy (value);
 
   if (value->unavailable.empty ())
@@ -413,8 +424,9 @@ value_entirely_covered_by_range_vector (struct value *value,
 					const std::vector<range> &ranges)
 {
   /* We can only tell whether the whole value is optimized out /
-     unavailable when we try to read it.  */
-  if (value->lazy)
+     unavailable when we try to read it.  Values read in parts can be
+     neither; see value_begin_fetch_in_parts.  */
+  if (value->lazy && !value->fetch_in_parts)
     value_fetch_lazy (value);
 
   if (ranges.size () == 1)
@@ -841,7 +853,8 @@ value_contents_bits_eq (const struct value *val1, int offset1,
   struct ranges_and_idx rp1[2], rp2[2];
 
   /* See function description in value.h.  */
-  gdb_assert (!val1->lazy && !val2->lazy);
+  gdb_assert ((!val1->lazy || val1->fetch_in_parts)
+	      && (!val2->lazy || val2->fetch_in_parts));
 
   /* We shouldn't be trying to compare past the end of the values.  */
   gdb_assert (offset1 + length
@@ -1231,7 +1244,7 @@ require_available (const struct value *value)
 const gdb_byte *
 value_contents_for_printing (struct value *value)
 {
-  if (value->lazy)
+  if (value->lazy && !value->fetch_in_parts)
     value_fetch_lazy (value);
   return value->contents.get ();
 }
@@ -1239,13 +1252,16 @@ value_contents_for_printing (struct value *value)
 const gdb_byte *
 value_contents_for_printing_const (const struct value *value)
 {
-  gdb_assert (!value->lazy);
+  gdb_assert (!value->lazy || value->fetch_in_parts);
   return value->contents.get ();
 }
 
 const gdb_byte *
 value_contents_all (struct value *value)
 {
+  if (value->lazy)
+    value_fetch_lazy (value);
+
   const gdb_byte *result = value_contents_for_printing (value);
   require_not_optimized_out (value);
   require_available (value);
@@ -1368,6 +1384,8 @@ void
 set_value_lazy (struct value *value, int val)
 {
   value->lazy = val;
+  value->fetch_in_parts = 0;
+  value->fetched.clear ();
 }
 
 int
@@ -3751,6 +3769,147 @@ value_fetch_lazy_bitfield (struct value *val)
 			 value_offset (val), parent);
 }
 
+/* The least number of bytes value_fetch_lazy_range reads from the
+   target at once, unless the value ends first.  */
+
+#define VALUE_FETCH_CHUNK 1024
+
+/* Read the parts of the LENGTH bytes at OFFSET in the contents of
+   lazy value VAL, which is being read in parts, that haven't been read
+   yet.  Reads are extended to VALUE_FETCH_CHUNK bytes, so that reading
+   a large value piece by piece doesn't take one target read per
+   piece.  */
+
+static void
+value_fetch_lazy_memory_range (struct value *val, LONGEST offset,
+			       LONGEST length)
+{
+  LONGEST value_length = TYPE_LENGTH (check_typedef (val->enclosing_type));
+  LONGEST end = std::min (offset + length, value_length);
+  gdb_byte *contents = value_contents_all_raw (val);
+
+  while (offset < end)
+    {
+      /* The end of the part not read yet starting at OFFSET, if any.  */
+      LONGEST gap_end = value_length;
+      bool in_gap = true;
+
+      for (const range &r : val->fetched)
+	{
+	  LONGEST r_start = r.offset / TARGET_CHAR_BIT;
+	  LONGEST r_end = (r.offset + r.length) / TARGET_CHAR_BIT;
+
+	  if (r_start <= offset && offset < r_end)
+	    {
+	      offset = r_end;
+	      in_gap = false;
+	      break;
+	    }
+	  if (r_start > offset)
+	    {
+	      gap_end = r_start;
+	      break;
+	    }
+	}
+      if (!in_gap)
+	continue;
+
+      LONGEST read_end
+	= std::min (gap_end,
+		    std::max (end, offset + (LONGEST) VALUE_FETCH_CHUNK));
+
+      try
+	{
+	  read_value_memory (val, offset * TARGET_CHAR_BIT, value_stack (val),
+			     value_address (val) + offset, contents + offset,
+			     read_end - offset);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* The part read ahead may be unreadable while the part asked
+	     for is not.  */
+	  if (ex.error != MEMORY_ERROR || read_end <= std::min (end, gap_end))
+	    throw;
+
+	  read_end = std::min (end, gap_end);
+	  read_value_memory (val, offset * TARGET_CHAR_BIT, value_stack (val),
+			     value_address (val) + offset, contents + offset,
+			     read_end - offset);
+	}
+      insert_into_bit_range_vector (&val->fetched,
+				    offset * TARGET_CHAR_BIT,
+				    (read_end - offset) * TARGET_CHAR_BIT);
+      offset = read_end;
+    }
+}
+
+/* See value.h.  */
+
+bool
+value_begin_fetch_in_parts (struct value *val)
+{
+  if (!val->lazy
+      || val->fetch_in_parts
+      || VALUE_LVAL (val) != lval_memory
+      || val->bitsize != 0
+      /* Outside of traceframes and replays, memory that can't be read
+	 is an error rather than unavailable, which lets the parts not
+	 read yet be assumed available.  */
+      || get_traceframe_number () != -1
+      || target_record_is_replaying (inferior_ptid)
+      || gdbarch_addressable_memory_unit_size (get_value_arch (val)) != 1)
+    return false;
+
+  val->fetch_in_parts = 1;
+
+  /* Read the first part now, so that an unreadable value is reported
+     before any of it is printed.  */
+  try
+    {
+      value_fetch_lazy_range (val, 0, 1);
+    }
+  catch (const gdb_exception &ex)
+    {
+      value_end_fetch_in_parts (val);
+      throw;
+    }
+
+  return true;
+}
+
+/* See value.h.  */
+
+void
+value_end_fetch_in_parts (struct value *val)
+{
+  val->fetch_in_parts = 0;
+  val->fetched.clear ();
+}
+
+/* See value.h.  */
+
+void
+value_fetch_lazy_range (struct value *val, LONGEST offset, LONGEST length)
+{
+  if (!val->lazy)
+    return;
+
+  if (!val->fetch_in_parts)
+    {
+      value_fetch_lazy (val);
+      return;
+    }
+
+  value_fetch_lazy_memory_range (val, offset, length);
+
+  /* Once all of VAL has been read, it is just not lazy anymore.  */
+  LONGEST value_length = TYPE_LENGTH (check_typedef (val->enclosing_type));
+  if (val->fetched.size () == 1
+      && val->fetched[0].offset == 0
+      && val->fetched[0].length == value_length * TARGET_CHAR_BIT)
+    set_value_lazy (val, 0);
+}
+
 /* Helper for value_fetch_lazy when the value is in memory.  */
 
 static void
@@ -3761,7 +3920,9 @@ value_fetch_lazy_memory (struct value *val)
   CORE_ADDR addr = value_address (val);
   struct type *type = check_typedef (value_enclosing_type (val));
 
-  if (TYPE_LENGTH (type))
+  if (val->fetch_in_parts)
+    value_fetch_lazy_memory_range (val, 0, TYPE_LENGTH (type));
+  else if (TYPE_LENGTH (type))
       read_value_memory (val, 0, value_stack (val),
 			 addr, value_contents_all_raw (val),
 			 type_length_units (type));
@@ -3902,7 +4063,8 @@ value_fetch_lazy (struct value *val)
   allocate_value_contents (val);
   /* A value is either lazy, or fully fetched.  The
      availability/validity is only established as we try to fetch a
-     value.  */
+     value.  Values read in parts are neither optimized out nor
+     unavailable; see value_begin_fetch_in_parts.  */
   gdb_assert (val->optimized_out.empty ());
   gdb_assert (val->unavailable.empty ());
   if (value_bitsize (val))
@@ -397,6 +397,27 @@ extern const gdb_byte *
 
 extern void value_fetch_lazy (struct value *val);
 
+/* Start reading lazy value VAL in parts, as printing it goes: until
+   value_end_fetch_in_parts, value_fetch_lazy_range reads just the
+   parts asked for, and value_contents_for_printing returns VAL's
+   contents without reading the rest.  Only printers that read the
+   parts of VAL they look at first may be used on VAL meanwhile.
+   Return false, leaving VAL alone, if VAL can't be read in parts.  */
+
+extern bool value_begin_fetch_in_parts (struct value *val);
+
+/* Stop reading VAL in parts.  Unless all of it has been read by now,
+   VAL is lazy again, and will be read entirely when needed.  */
+
+extern void value_end_fetch_in_parts (struct value *val);
+
+/* Read the LENGTH bytes at OFFSET in the contents of lazy value VAL
+   (see value_contents_all), if VAL is being read in parts, or all of
+   VAL otherwise.  Do nothing if VAL isn't lazy.  */
+
+extern void value_fetch_lazy_range (struct value *val, LONGEST offset,
+				    LONGEST length);
+
 /* If nonzero, this is the value of a variable which does not actually
    exist in the program, at least partially.  If the value is lazy,
    this may fetch it now.  */
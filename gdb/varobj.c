@@ -24,6 +24,7 @@
 #include "block.h"
 #include "valprint.h"
 #include "gdb_regex.h"
+#include "c-lang.h"
 
 #include "varobj.h"
 #include "gdbthread.h"
@@ -31,6 +32,7 @@
 #include "varobj-iter.h"
 #include "parser-defs.h"
 #include "gdbarch.h"
+#include "native-printers.h"
 
 #if HAVE_PYTHON
 #include "python/python.h"
@@ -124,6 +126,12 @@ struct varobj_dynamic
      new printer object is needed, and one will be constructed.  */
   PyObject *pretty_printer = NULL;
 
+  /* Whether the varobj is printed by a native pretty-printer (see
+     native-printers.h), because no Python pretty-printer is
+     installed.  The printer keeps the state of an iteration over the
+     children, so a new one is made from the value when needed.  */
+  bool native_printer = false;
+
   /* The iterator returned by the printer's 'children' method, or NULL
      if not available.  */
   struct varobj_iter *child_iter = NULL;
@@ -172,6 +180,8 @@ static bool update_type_if_necessary (struct varobj *var,
 static bool install_new_value (struct varobj *var, struct value *value,
 			       bool initial);
 
+static value_ref_ptr update_varobj_snapshot (struct varobj *var);
+
 /* Language-specific routines.  */
 
 static int number_of_children (const struct varobj *);
@@ -535,11 +545,32 @@ varobj_get_display_format (const struct varobj *var)
   return var->format;
 }
 
+/* Return true if VAR is printed by a pretty-printer, either a Python
+   or a native one.  */
+
+static bool
+varobj_has_visualizer (const struct varobj *var)
+{
+  return (var->dynamic->pretty_printer != NULL
+	  || var->dynamic->native_printer);
+}
+
 gdb::unique_xmalloc_ptr<char>
 varobj_get_display_hint (const struct varobj *var)
 {
   gdb::unique_xmalloc_ptr<char> result;
 
+  if (var->dynamic->native_printer)
+    {
+      std::unique_ptr<native_printer> printer
+	= make_native_printer (var->value.get ());
+      const char *hint = printer != NULL ? printer->display_hint () : NULL;
+
+      if (hint != NULL)
+	result.reset (xstrdup (hint));
+      return result;
+    }
+
 #if HAVE_PYTHON
   if (!gdb_python_initialized)
     return NULL;
@@ -682,12 +713,99 @@ dynamic_varobj_has_child_method (const struct varobj *var)
 }
 #endif
 
+/* A dynamic varobj iterator "class" for varobjs printed by a native
+   pretty-printer.  This inherits struct varobj_iter.  */
+
+struct native_varobj_iter
+{
+  /* The 'base class'.  */
+  struct varobj_iter base;
+
+  /* The printer whose children are iterated over.  */
+  native_printer *printer;
+};
+
+/* Implementation of the 'dtor' method of native varobj iterators.  */
+
+static void
+native_varobj_iter_dtor (struct varobj_iter *self)
+{
+  struct native_varobj_iter *dis = (struct native_varobj_iter *) self;
+
+  delete dis->printer;
+}
+
+/* Implementation of the 'next' method of native varobj iterators.
+   A child that can't be read is reported as an error string, as
+   py_varobj_iter_next does.  */
+
+static varobj_item *
+native_varobj_iter_next (struct varobj_iter *self)
+{
+  struct native_varobj_iter *dis = (struct native_varobj_iter *) self;
+  std::string name;
+  struct value *value;
+
+  try
+    {
+      value = dis->printer->next_child (&name);
+      if (value == NULL)
+	return NULL;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      struct gdbarch *gdbarch
+	= get_type_arch (value_type (self->var->value.get ()));
+
+      name = string_printf ("<error at %d>", self->next_raw_index);
+      value = value_cstring (ex.what (), strlen (ex.what ()),
+			     builtin_type (gdbarch)->builtin_char);
+    }
+
+  varobj_item *vitem = new varobj_item ();
+  vitem->name = std::move (name);
+  vitem->value = value;
+
+  self->next_raw_index++;
+  return vitem;
+}
+
+/* The 'vtable' of native varobj iterators.  */
+
+static const struct varobj_iter_ops native_varobj_iter_ops =
+{
+  native_varobj_iter_dtor,
+  native_varobj_iter_next
+};
+
+/* Return an iterator over the children of VAR, which is printed by a
+   native pretty-printer, or NULL if the printer can't be made.  */
+
+static struct varobj_iter *
+native_varobj_get_iterator (struct varobj *var)
+{
+  std::unique_ptr<native_printer> printer
+    = make_native_printer (var->value.get ());
+  if (printer == NULL)
+    return NULL;
+
+  struct native_varobj_iter *self = XNEW (struct native_varobj_iter);
+  self->base.var = var;
+  self->base.ops = &native_varobj_iter_ops;
+  self->base.next_raw_index = 0;
+  self->printer = printer.release ();
+  return &self->base;
+}
+
 /* A factory for creating dynamic varobj's iterators.  Returns an
    iterator object suitable for iterating over VAR's children.  */
 
 static struct varobj_iter *
 varobj_get_iterator (struct varobj *var)
 {
+  if (var->dynamic->native_printer)
+    return native_varobj_get_iterator (var);
+
 #if HAVE_PYTHON
   if (var->dynamic->pretty_printer)
     return py_varobj_get_iterator (var, var->dynamic->pretty_printer);
@@ -832,8 +950,8 @@ varobj_get_num_children (struct varobj *var)
   return var->num_children >= 0 ? var->num_children : 0;
 }
 
-/* Creates a list of the immediate children of a variable object;
-   the return code is the number of such children or -1 on error.  */
+/* Creates the immediate children of a variable object in the range
+   *FROM to *TO, and returns the list of its children.  */
 
 const std::vector<varobj *> &
 varobj_list_children (struct varobj *var, int *from, int *to)
@@ -865,19 +983,27 @@ varobj_list_children (struct varobj *var, int *from, int *to)
   while (var->children.size () < var->num_children)
     var->children.push_back (NULL);
 
-  for (int i = 0; i < var->num_children; i++)
+  /* Only create the children in the requested range, so that listing
+     a window of a large array doesn't create a varobj for each of its
+     elements.  */
+  varobj_restrict_range (var->children, from, to);
+
+  for (int i = *from; i < *to; i++)
     {
       if (var->children[i] == NULL)
 	{
 	  /* Either it's the first call to varobj_list_children for
-	     this variable object, and the child was never created,
-	     or it was explicitly deleted by the client.  */
+	     this child, and the child was never created, or it was
+	     explicitly deleted by the client.  */
 	  std::string name = name_of_child (var, i);
 	  var->children[i] = create_child (var, i, name);
 	}
     }
 
-  varobj_restrict_range (var->children, from, to);
+  /* Remember the memory the children were just read from, for
+     -var-update to tell which of them may have changed.  */
+  update_varobj_snapshot (var);
+
   return var->children;
 }
 
@@ -996,7 +1122,7 @@ varobj_get_attributes (const struct varobj *var)
 bool
 varobj_is_dynamic_p (const struct varobj *var)
 {
-  return var->dynamic->pretty_printer != NULL;
+  return varobj_has_visualizer (var);
 }
 
 std::string
@@ -1094,6 +1220,7 @@ install_visualizer (struct varobj_dynamic *var, PyObject *constructor,
 
   Py_XDECREF (var->pretty_printer);
   var->pretty_printer = visualizer;
+  var->native_printer = false;
 
   varobj_iter_delete (var->child_iter);
   var->child_iter = NULL;
@@ -1177,10 +1304,8 @@ install_new_value_visualizer (struct varobj *var)
 #if HAVE_PYTHON
   /* If the constructor is None, then we want the raw value.  If VAR
      does not have a value, just skip this.  */
-  if (!gdb_python_initialized)
-    return;
-
-  if (var->dynamic->constructor != Py_None && var->value != NULL)
+  if (gdb_python_initialized
+      && var->dynamic->constructor != Py_None && var->value != NULL)
     {
       gdbpy_enter_varobj enter_py (var);
 
@@ -1189,9 +1314,24 @@ install_new_value_visualizer (struct varobj *var)
       else
 	construct_visualizer (var, var->dynamic->constructor);
     }
-#else
-  /* Do nothing.  */
+
+  if (var->dynamic->constructor != NULL)
+    return;
 #endif
+
+  /* Use a native printer if no Python one applies, as
+     apply_ext_lang_val_pretty_printer does.  */
+  bool native = (pretty_printing
+		 && !CPLUS_FAKE_CHILD (var)
+		 && var->dynamic->pretty_printer == NULL
+		 && var->value != NULL
+		 && make_native_printer (var->value.get ()) != NULL);
+  if (native != var->dynamic->native_printer)
+    {
+      var->dynamic->native_printer = native;
+      varobj_iter_delete (var->dynamic->child_iter);
+      var->dynamic->child_iter = NULL;
+    }
 }
 
 /* When using RTTI to determine variable type it may be changed in runtime when
@@ -1230,6 +1370,161 @@ update_type_if_necessary (struct varobj *var, struct value *new_value)
   return false;
 }
 
+/* Return true if VAR's printed value depends only on the contents of
+   its value, so that it can't have changed if its value is still at
+   the same place in memory, and that memory hasn't changed.  */
+
+static bool
+varobj_value_depends_on_contents_only (const struct varobj *var)
+{
+  if (var->root->lang_ops != &c_varobj_ops
+      && var->root->lang_ops != &cplus_varobj_ops)
+    return false;
+
+  /* Pretty-printers may print anything, and values assigned with
+     -var-assign are reported as changed anyway.  */
+  if (varobj_has_visualizer (var)
+      || var->updated || var->not_fetched)
+    return false;
+
+  if (var->value == NULL || VALUE_LVAL (var->value.get ()) != lval_memory)
+    return false;
+
+  struct type *type = check_typedef (value_type (var->value.get ()));
+  if (TYPE_CODE (type) == TYPE_CODE_PTR)
+    {
+      struct value_print_options opts;
+
+      /* Pointers to characters are printed with the string they point
+	 to, and with "set print object", the type of pointers to
+	 classes depends on the object they point to.  */
+      get_user_print_options (&opts);
+      if (opts.objectprint
+	  || c_textual_element_type (check_typedef (TYPE_TARGET_TYPE (type)),
+				     0))
+	return false;
+    }
+
+  return true;
+}
+
+/* Return true if OLD_VAL and NEW_VAL, which must not be lazy, are in
+   the same place in memory, with the same type and contents.  */
+
+static bool
+value_unchanged_in_memory_p (struct value *old_val, struct value *new_val)
+{
+  if (VALUE_LVAL (old_val) != lval_memory
+      || VALUE_LVAL (new_val) != lval_memory
+      || value_type (old_val) != value_type (new_val)
+      || value_address (old_val) != value_address (new_val)
+      || value_bitpos (old_val) != value_bitpos (new_val)
+      || value_bitsize (old_val) != value_bitsize (new_val))
+    return false;
+
+  return value_contents_eq (old_val, value_embedded_offset (old_val),
+			    new_val, value_embedded_offset (new_val),
+			    TYPE_LENGTH (check_typedef (value_type (new_val))));
+}
+
+/* Return true if VAR's value, as last installed, lies in the memory
+   of OLD_SNAPSHOT, the snapshot of the memory of VAR's parent at the
+   last update, and if that part of it is the same in NEW_SNAPSHOT, the
+   snapshot taken now.  */
+
+static bool
+varobj_in_unchanged_memory_p (const struct varobj *var,
+			      struct value *old_snapshot,
+			      struct value *new_snapshot)
+{
+  /* C++ access specifiers have no value of their own.  */
+  if (CPLUS_FAKE_CHILD (var))
+    return true;
+
+  if (!varobj_value_depends_on_contents_only (var))
+    return false;
+
+  struct value *val = var->value.get ();
+  CORE_ADDR start = value_address (val);
+  ULONGEST length = TYPE_LENGTH (check_typedef (value_type (val)));
+  CORE_ADDR addr = value_address (old_snapshot);
+  ULONGEST len = TYPE_LENGTH (check_typedef (value_type (old_snapshot)));
+
+  if (start < addr || length > len || start - addr > len - length)
+    return false;
+
+  LONGEST offset = start - addr;
+  return value_contents_eq (old_snapshot,
+			    value_embedded_offset (old_snapshot) + offset,
+			    new_snapshot,
+			    value_embedded_offset (new_snapshot) + offset,
+			    length);
+}
+
+/* Read the memory VAR's children are read from in one go, and make it
+   VAR's snapshot (see varobj::snapshot).  Return the previous
+   snapshot if it is of the same memory, or NULL.  */
+
+static value_ref_ptr
+update_varobj_snapshot (struct varobj *var)
+{
+  value_ref_ptr old_snapshot = std::move (var->snapshot);
+
+  if (var->children.empty () || var->value == NULL || var->not_fetched
+      || varobj_has_visualizer (var)
+      || (var->root->lang_ops != &c_varobj_ops
+	  && var->root->lang_ops != &cplus_varobj_ops))
+    return NULL;
+
+  struct value *val = var->value.get ();
+  struct type *type = check_typedef (value_type (val));
+  struct value *mem;
+
+  try
+    {
+      switch (TYPE_CODE (type))
+	{
+	case TYPE_CODE_STRUCT:
+	case TYPE_CODE_UNION:
+	case TYPE_CODE_ARRAY:
+	  mem = val;
+	  break;
+
+	case TYPE_CODE_PTR:
+	  {
+	    struct type *target = check_typedef (TYPE_TARGET_TYPE (type));
+
+	    if (TYPE_CODE (target) == TYPE_CODE_FUNC
+		|| TYPE_CODE (target) == TYPE_CODE_VOID
+		|| value_as_address (val) == 0)
+	      return NULL;
+	    mem = value_ind (val);
+	  }
+	  break;
+
+	default:
+	  return NULL;
+	}
+
+      if (VALUE_LVAL (mem) != lval_memory)
+	return NULL;
+      if (value_lazy (mem))
+	value_fetch_lazy (mem);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      return NULL;
+    }
+
+  var->snapshot = value_ref_ptr::new_reference (mem);
+  if (old_snapshot == NULL
+      || value_type (old_snapshot.get ()) != value_type (mem)
+      || value_address (old_snapshot.get ()) != value_address (mem))
+    return NULL;
+
+  return old_snapshot;
+}
+
 /* Assign a new value to a variable object.  If INITIAL is true,
    this is the first assignment after the variable object was just
    created, or changed type.  In that case, just assign the value 
@@ -1260,7 +1555,7 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
   /* If the type has custom visualizer, we consider it to be always
      changeable.  FIXME: need to make sure this behaviour will not
      mess up read-sensitive values.  */
-  if (var->dynamic->pretty_printer != NULL)
+  if (varobj_has_visualizer (var))
     changeable = true;
 
   need_to_fetch = changeable;
@@ -1333,8 +1628,18 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
      should not be fetched.  */
   std::string print_value;
   if (value != NULL && !value_lazy (value)
-      && var->dynamic->pretty_printer == NULL)
-    print_value = varobj_value_get_print_value (value, var->format, var);
+      && !varobj_has_visualizer (var))
+    {
+      /* A value in the same place in memory as before, with the same
+	 contents, is printed the same.  */
+      if (!initial && changeable
+	  && varobj_value_depends_on_contents_only (var)
+	  && !value_lazy (var->value.get ())
+	  && value_unchanged_in_memory_p (var->value.get (), value))
+	print_value = var->print_value;
+      else
+	print_value = varobj_value_get_print_value (value, var->format, var);
+    }
 
   /* If the type is changeable, compare the old and the new values.
      If this is the initial assignment, we don't have any old value
@@ -1348,7 +1653,7 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
 	 varobj as changed.  */
       if (var->updated)
 	changed = true;
-      else if (var->dynamic->pretty_printer == NULL)
+      else if (!varobj_has_visualizer (var))
 	{
 	  /* Try to compare the values.  That requires that both
 	     values are non-lazy.  */
@@ -1401,7 +1706,7 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
 
   /* If we installed a pretty-printer, re-compare the printed version
      to see if the variable changed.  */
-  if (var->dynamic->pretty_printer != NULL)
+  if (varobj_has_visualizer (var))
     {
       print_value = varobj_value_get_print_value (var->value.get (),
 						  var->format, var);
@@ -1584,8 +1889,12 @@ varobj_update (struct varobj **varp, bool is_explicit)
       struct varobj *v = r.varobj;
 
       /* Update this variable, unless it's a root, which is already
-	 updated.  */
-      if (!r.value_installed)
+	 updated, or its value is in memory that hasn't changed.  */
+      bool in_unchanged_memory
+	= (!r.value_installed && r.old_snapshot != NULL
+	   && varobj_in_unchanged_memory_p (v, r.old_snapshot.get (),
+					    r.new_snapshot.get ()));
+      if (!r.value_installed && !in_unchanged_memory)
 	{
 	  struct type *new_type;
 
@@ -1704,6 +2013,26 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	    }
 	}
 
+      /* Read the memory the children are read from, to find out which
+	 of them are in a part of it that hasn't changed.  The children
+	 of an unchanged structure, union or array are in the memory of
+	 its parent, which was just read.  */
+      value_ref_ptr old_snapshot, new_snapshot;
+      if (in_unchanged_memory
+	  && (CPLUS_FAKE_CHILD (v)
+	      || (TYPE_CODE (check_typedef (value_type (v->value.get ())))
+		  != TYPE_CODE_PTR)))
+	{
+	  old_snapshot = std::move (r.old_snapshot);
+	  new_snapshot = std::move (r.new_snapshot);
+	}
+      else
+	{
+	  old_snapshot = update_varobj_snapshot (v);
+	  if (old_snapshot != NULL)
+	    new_snapshot = v->snapshot;
+	}
+
       /* Push any children.  Use reverse order so that the first
 	 child is popped from the work stack first, and so
 	 will be added to result first.  This does not
@@ -1714,7 +2043,13 @@ varobj_update (struct varobj **varp, bool is_explicit)
 
 	  /* Child may be NULL if explicitly deleted by -var-delete.  */
 	  if (c != NULL && !c->frozen)
-	    stack.emplace_back (c);
+	    {
+	      varobj_update_result item (c);
+
+	      item.old_snapshot = old_snapshot;
+	      item.new_snapshot = new_snapshot;
+	      stack.push_back (std::move (item));
+	    }
 	}
 
       if (r.changed || r.type_changed)
@@ -2254,7 +2589,7 @@ my_value_of_variable (struct varobj *var, enum varobj_display_formats format)
 {
   if (var->root->is_valid)
     {
-      if (var->dynamic->pretty_printer != NULL)
+      if (varobj_has_visualizer (var))
 	return varobj_value_get_print_value (var->value.get (), var->format,
 					     var);
       return (*var->root->lang_ops->value_of_variable) (var, format);
@@ -2291,6 +2626,21 @@ varobj_value_get_print_value (struct value *value,
   string_file stb;
   std::string thevalue;
 
+  if (var->dynamic->native_printer)
+    {
+      std::unique_ptr<native_printer> printer = make_native_printer (value);
+
+      if (printer != NULL)
+	{
+	  if (printer->has_children ())
+	    return "{...}";
+
+	  varobj_formatted_print_options (&opts, format);
+	  printer->to_string (&stb, &opts);
+	  return std::move (stb.string ());
+	}
+    }
+
 #if HAVE_PYTHON
   if (gdb_python_initialized)
     {
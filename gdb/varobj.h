@@ -78,6 +78,13 @@ struct varobj_update_result
      be yet installed.  Don't use this outside varobj.c.  */
   bool value_installed = false;
 
+  /* Also used internally by varobj_update: the memory the children
+     of the varobj's parent were read from, as it was at the last
+     update, and as it is now (see varobj::snapshot).  Don't use this
+     outside varobj.c.  */
+  value_ref_ptr old_snapshot;
+  value_ref_ptr new_snapshot;
+
   /* This will be non-NULL when new children were added to the varobj.
      It lists the new children (which must necessarily come at the end
      of the child list) added during an update.  The caller is
@@ -124,6 +131,14 @@ struct varobj
      the value is either NULL, or not lazy.  */
   value_ref_ptr value;
 
+  /* The memory the children of this variable were last read from:
+     the variable's value if it is a structure, union or array, or the
+     object it points to if it is a pointer, as read in one go.  NULL
+     if the variable has no children, or if the memory couldn't be
+     read.  If this memory hasn't changed, the children in it haven't
+     either, and -var-update skips them.  */
+  value_ref_ptr snapshot;
+
   /* The number of (immediate) children this variable has.  */
   int num_children = -1;
 
@@ -288,7 +303,9 @@ extern int varobj_get_num_children (struct varobj *var);
    return, *FROM and *TO will be updated to indicate the real range
    that was returned.  The resulting vector will contain at least the
    children from *FROM to just before *TO; it might contain more
-   children, depending on whether any more were available.  */
+   children, depending on whether any more were available.  Only the
+   children in that range are created; the elements of the vector
+   outside of it may be NULL.  */
 extern const std::vector<varobj *> &
   varobj_list_children (struct varobj *var, int *from, int *to);
 
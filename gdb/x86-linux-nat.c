@@ -25,6 +25,7 @@
 #include <sys/user.h>
 #include <sys/procfs.h>
 #include <sys/uio.h>
+#include <sys/mman.h>
 
 #include "x86-nat.h"
 #ifndef __x86_64__
@@ -266,6 +267,147 @@ x86_linux_nat_target::btrace_conf (const struct btrace_target_info *btinfo)
   return linux_btrace_conf (btinfo);
 }
 
+/* Implement the "region_ok_for_hw_watchpoint" target method.  Regions
+   too large for the debug registers can still be watched by
+   protecting their pages, up to PAGE_PROTECTION_MAX_PAGES pages.  */
+
+int
+x86_linux_nat_target::region_ok_for_hw_watchpoint (CORE_ADDR addr, int len)
+{
+  if (x86_nat_target::region_ok_for_hw_watchpoint (addr, len))
+    return 1;
+
+  return (page_protection_watchpoints
+	  && page_protection_region_ok_p (addr, len));
+}
+
+/* Implement the "insert_watchpoint" target method.  Watchpoints that
+   don't fit in the free debug registers fall back to page
+   protection.  */
+
+int
+x86_linux_nat_target::insert_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type,
+					 struct expression *cond)
+{
+  if (x86_nat_target::insert_watchpoint (addr, len, type, cond) == 0)
+    return 0;
+
+  return insert_page_protection_watchpoint (addr, len, type);
+}
+
+/* Implement the "remove_watchpoint" target method.  */
+
+int
+x86_linux_nat_target::remove_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type,
+					 struct expression *cond)
+{
+  if (remove_page_protection_watchpoint (addr, len, type) == 0)
+    return 0;
+
+  return x86_nat_target::remove_watchpoint (addr, len, type, cond);
+}
+
+/* The i386 GNU/Linux system call number of mprotect.  */
+#define I386_LINUX_SYS_MPROTECT 125
+
+/* linux_nat_target::low_inferior_mprotect implementation.  The LWP
+   runs a "syscall" (or, for 32-bit programs, "int $0x80") instruction
+   written over the one at its PC, which must be in an executable
+   page.  */
+
+bool
+x86_linux_nat_target::low_inferior_mprotect (int lwpid, CORE_ADDR addr,
+					     ULONGEST len, int prot)
+{
+  static const gdb_byte syscall_insn[] = { 0x0f, 0x05 };
+  static const gdb_byte int80_insn[] = { 0xcd, 0x80 };
+  struct user_regs_struct regs, saved_regs;
+  const gdb_byte *insn;
+  CORE_ADDR pc;
+
+  if (ptrace (PTRACE_GETREGS, lwpid, 0, &saved_regs) != 0)
+    return false;
+  regs = saved_regs;
+
+#ifdef __x86_64__
+  pc = regs.rip;
+  if (regs.cs == AMD64_LINUX_USER64_CS)
+    {
+      insn = syscall_insn;
+      if (regs.ds == AMD64_LINUX_X32_DS)
+	regs.rax = amd64_x32_sys_mprotect;
+      else
+	regs.rax = amd64_sys_mprotect;
+      regs.rdi = addr;
+      regs.rsi = len;
+      regs.rdx = prot;
+    }
+  else
+    {
+      insn = int80_insn;
+      regs.rax = I386_LINUX_SYS_MPROTECT;
+      regs.rbx = addr;
+      regs.rcx = len;
+      regs.rdx = prot;
+    }
+  /* Don't let the kernel restart a system call the LWP may have been
+     stopped in, instead of running ours.  */
+  regs.orig_rax = -1;
+#else
+  pc = regs.eip;
+  insn = int80_insn;
+  regs.eax = I386_LINUX_SYS_MPROTECT;
+  regs.ebx = addr;
+  regs.ecx = len;
+  regs.edx = prot;
+  regs.orig_eax = -1;
+#endif
+
+  /* The instruction would fault if the LWP stopped outside code,
+     e.g. after jumping to a bad address.  */
+  CORE_ADDR page_mask = ~((CORE_ADDR) getpagesize () - 1);
+  CORE_ADDR insn_last = pc + sizeof (syscall_insn) - 1;
+  for (CORE_ADDR insn_addr : { pc, insn_last })
+    {
+      if (insn_addr != pc && (insn_addr & page_mask) == (pc & page_mask))
+	continue;
+
+      int insn_prot = linux_proc_page_prot (lwpid, insn_addr);
+      if (insn_prot == -1 || (insn_prot & PROT_EXEC) == 0)
+	return false;
+    }
+
+  errno = 0;
+  PTRACE_TYPE_RET word = ptrace (PTRACE_PEEKTEXT, lwpid,
+				  (PTRACE_TYPE_ARG3) (uintptr_t) pc, 0);
+  if (errno != 0)
+    return false;
+
+  PTRACE_TYPE_RET new_word = word;
+  memcpy (&new_word, insn, sizeof (syscall_insn));
+  if (ptrace (PTRACE_POKETEXT, lwpid, (PTRACE_TYPE_ARG3) (uintptr_t) pc,
+	      new_word) != 0)
+    return false;
+
+  bool ok = false;
+  if (ptrace (PTRACE_SETREGS, lwpid, 0, &regs) == 0
+      && linux_nat_step_injected_lwp (lwpid)
+      && ptrace (PTRACE_GETREGS, lwpid, 0, &regs) == 0)
+    {
+#ifdef __x86_64__
+      ok = regs.rax == 0;
+#else
+      ok = regs.eax == 0;
+#endif
+    }
+
+  ptrace (PTRACE_POKETEXT, lwpid, (PTRACE_TYPE_ARG3) (uintptr_t) pc, word);
+  ptrace (PTRACE_SETREGS, lwpid, 0, &saved_regs);
+  return ok;
+}
+
 
 
 /* Helper for ps_get_thread_area.  Sets BASE_ADDR to a pointer to
@@ -60,6 +60,21 @@ struct x86_linux_nat_target : public x86_nat_target<linux_nat_target>
   bool low_stopped_data_address (CORE_ADDR *addr_p) override
   { return x86_nat_target::stopped_data_address (addr_p); }
 
+  /* These fall back to page protection watchpoints, when the debug
+     registers can't hold the watchpoint.  */
+  int region_ok_for_hw_watchpoint (CORE_ADDR addr, int len) override;
+
+  int insert_watchpoint (CORE_ADDR addr, int len,
+			 enum target_hw_bp_type type,
+			 struct expression *cond) override;
+
+  int remove_watchpoint (CORE_ADDR addr, int len,
+			 enum target_hw_bp_type type,
+			 struct expression *cond) override;
+
+  bool low_inferior_mprotect (int lwpid, CORE_ADDR addr, ULONGEST len,
+			      int prot) override;
+
   void low_new_fork (struct lwp_info *parent, pid_t child_pid) override;
 
   void low_forget_process (pid_t pid) override
@@ -21,6 +21,8 @@
 #include "x86-nat.h"
 #include "gdbcmd.h"
 #include "inferior.h"
+#include "ui-out.h"
+#include "gdbarch.h"
 
 /* Support for hardware watchpoints and breakpoints using the x86
    debug registers.
@@ -194,6 +196,19 @@ x86_stopped_data_address (CORE_ADDR *addr_p)
   return x86_dr_stopped_data_address (state, addr_p);
 }
 
+/* Return non-zero if a watchpoint hit at ADDR should be considered a
+   hit of the watchpoint watching the LENGTH bytes at START.  */
+
+int
+x86_watchpoint_addr_within_range (CORE_ADDR addr, CORE_ADDR start,
+				  int length)
+{
+  struct x86_debug_reg_state *state
+    = x86_debug_reg_state (inferior_ptid.pid ());
+
+  return x86_dr_watchpoint_addr_within_range (state, addr, start, length);
+}
+
 /* Return non-zero if the inferior has some watchpoint that triggered.
    Otherwise return zero.  */
 
@@ -269,6 +284,115 @@ x86_stopped_by_hw_breakpoint ()
   return x86_dr_stopped_by_hw_breakpoint (state);
 }
 
+/* Return a string describing accesses of type TYPE.  */
+
+static const char *
+x86_hw_bp_type_name (enum target_hw_bp_type type)
+{
+  switch (type)
+    {
+    case hw_write:
+      return "write";
+    case hw_read:
+      return "read";
+    case hw_access:
+      return "access";
+    case hw_execute:
+      return "execute";
+    default:
+      return "??";
+    }
+}
+
+/* Implement the "maint info watchpoint-registers" command.  */
+
+static void
+maintenance_info_watchpoint_registers (const char *args, int from_tty)
+{
+  struct ui_out *uiout = current_uiout;
+  struct x86_process_info *proc = x86_find_process_pid (inferior_ptid.pid ());
+  int nregions = 0, nused = 0;
+  int covered = 0, watched = 0;
+  int i;
+
+  if (inferior_ptid == null_ptid || proc == NULL)
+    {
+      uiout->message (_("No debug registers are in use.\n"));
+      return;
+    }
+
+  struct x86_debug_reg_state *state = &proc->state;
+
+  {
+    ui_out_emit_table table_emitter (uiout, 5, DR_NADDR,
+				     "watchpoint-registers");
+    uiout->table_header (8, ui_left, "register", "Register");
+    uiout->table_header (18, ui_left, "addr", "Address");
+    uiout->table_header (6, ui_left, "len", "Length");
+    uiout->table_header (8, ui_left, "type", "Type");
+    uiout->table_header (5, ui_left, "refcount", "Uses");
+    uiout->table_body ();
+
+    ALL_DEBUG_ADDRESS_REGISTERS (i)
+      {
+	CORE_ADDR addr;
+	int len;
+	enum target_hw_bp_type type;
+
+	ui_out_emit_tuple tuple_emitter (uiout, NULL);
+	uiout->field_fmt ("register", "DR%d", i);
+	if (x86_dr_get_cover (state, i, &addr, &len, &type))
+	  {
+	    nused++;
+	    uiout->field_core_addr ("addr", target_gdbarch (), addr);
+	    uiout->field_signed ("len", len);
+	    uiout->field_string ("type", x86_hw_bp_type_name (type));
+	    uiout->field_signed ("refcount", state->dr_ref_count[i]);
+
+	    if (type != hw_execute)
+	      {
+		/* Count the bytes of the cover that some region of the
+		   same type watches.  */
+		covered += len;
+		for (CORE_ADDR a = addr; a < addr + len; a++)
+		  for (const struct x86_dr_region &region : state->regions)
+		    if (region.ref_count > 0 && region.type == type
+			&& region.addr <= a && a < region.addr + region.len)
+		      {
+			watched++;
+			break;
+		      }
+	      }
+	  }
+	else
+	  {
+	    uiout->field_skip ("addr");
+	    uiout->field_skip ("len");
+	    uiout->field_string ("type", "unused");
+	    uiout->field_skip ("refcount");
+	  }
+	uiout->text ("\n");
+      }
+  }
+
+  for (const struct x86_dr_region &region : state->regions)
+    if (region.ref_count > 0)
+      nregions++;
+
+  uiout->text ("\n");
+  uiout->field_signed ("registers-used", nused);
+  uiout->text (" of ");
+  uiout->field_signed ("registers", DR_NADDR);
+  uiout->text (" debug registers in use for ");
+  uiout->field_signed ("regions", nregions);
+  uiout->text (nregions == 1 ? " region.\n" : " regions.\n");
+  uiout->text ("Data registers cover ");
+  uiout->field_signed ("bytes-covered", covered);
+  uiout->text (" bytes, of which ");
+  uiout->field_signed ("bytes-watched", watched);
+  uiout->text (" are watched.\n");
+}
+
 static void
 add_show_debug_regs_command (void)
 {
@@ -286,6 +410,15 @@ triggers a breakpoint or watchpoint."),
 			   NULL,
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
+
+  add_cmd ("watchpoint-registers", class_maintenance,
+	   maintenance_info_watchpoint_registers, _("\
+Show how the x86 debug registers are allocated.\n\
+For each debug register, show the region it watches, the type of\n\
+accesses it traps, and how many watchpoints and breakpoints use it.\n\
+Then show how many of the bytes the data registers cover are actually\n\
+watched; writes to the others are filtered out when they trigger."),
+	   &maintenanceinfolist);
 }
 
 /* See x86-nat.h.  */
@@ -297,5 +430,10 @@ x86_set_debug_register_length (int len)
   gdb_assert (x86_dr_low.debug_register_length == 0);
   gdb_assert (len == 4 || len == 8);
   x86_dr_low.debug_register_length = len;
+
+  /* x86_nat_target checks watchpoint hits with
+     x86_watchpoint_addr_within_range, so registers can be shared.  */
+  x86_dr_low.coalesce_regions = 1;
+
   add_show_debug_regs_command ();
 }
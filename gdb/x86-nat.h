@@ -52,6 +52,8 @@ extern int x86_can_use_hw_breakpoint (enum bptype type, int cnt, int othertype);
 extern int x86_region_ok_for_hw_watchpoint (CORE_ADDR addr, int len);
 extern int x86_stopped_by_watchpoint ();
 extern int x86_stopped_data_address (CORE_ADDR *addr_p);
+extern int x86_watchpoint_addr_within_range (CORE_ADDR addr,
+					     CORE_ADDR start, int length);
 extern int x86_insert_watchpoint (CORE_ADDR addr, int len,
 			   enum target_hw_bp_type type,
 			   struct expression *cond);
@@ -102,6 +104,10 @@ struct x86_nat_target : public BaseTarget
   bool stopped_data_address (CORE_ADDR *addr_p) override
   { return x86_stopped_data_address (addr_p); }
 
+  bool watchpoint_addr_within_range (CORE_ADDR addr, CORE_ADDR start,
+				     int length) override
+  { return x86_watchpoint_addr_within_range (addr, start, length); }
+
   /* A target must provide an implementation of the
      "supports_stopped_by_hw_breakpoint" target method before this
      callback will be used.  */